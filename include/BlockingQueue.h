@@ -0,0 +1,485 @@
+/*******************************************************************************
+ * BlockingQueue.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.25
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include "Deque.h"
+
+namespace cpplib
+{
+
+/**
+ * 有界阻塞队列.
+ * 元素保存在Container中，由一个互斥锁保护.
+ * 队满时生产者等待，队空时消费者等待，等待可以设置超时.
+ * 线程等待时先在锁外自旋SPIN_COUNT轮，条件仍不满足才在条件变量上休眠；
+ * 只有存在休眠的线程时才调用notify，没有等待者时入队和出队不进入内核.
+ * 关闭队列后入队失败，消费者取完剩余元素后出队失败.
+ * 队列记录等待次数和等待时间，用于观察唤醒开销和延迟.
+ */
+template<typename E, typename Container = Deque<E>>
+class BlockingQueue
+{
+    static constexpr size_t DEFAULT_CAPACITY = 1024; // 默认容量
+    static constexpr int SPIN_COUNT = 256; // 休眠前自旋的轮数
+
+    using clock = std::chrono::steady_clock;
+public:
+    // 成员类型定义
+    using container_type  = Container;
+    using value_type      = E;
+    using reference       = E&;
+    using const_reference = const E&;
+    using size_type       = size_t;
+
+    // 等待统计，只统计条件不满足、需要等待的操作
+    struct Counters
+    {
+        unsigned long long spins;       // 自旋期间条件满足的次数
+        unsigned long long parks;       // 在条件变量上休眠的次数
+        unsigned long long wakeups;     // 从条件变量返回的次数，包括虚假唤醒
+        unsigned long long timeouts;    // 等待超时的次数
+        unsigned long long wait_ns;     // 总等待时间（纳秒）
+        unsigned long long max_wait_ns; // 最长的一次等待时间（纳秒）
+    };
+
+    explicit BlockingQueue(size_type capacity = DEFAULT_CAPACITY);
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    // 判断队列是否为空，并发修改时只是近似值
+    bool empty() const { return size() == 0; }
+    // 返回队列元素的数量，并发修改时只是近似值
+    size_type size() const { return n.load(std::memory_order_relaxed); }
+    // 返回队列的容量
+    size_type capacity() const { return cap; }
+    // 判断队列是否已关闭
+    bool closed() const { return is_closed.load(std::memory_order_acquire); }
+    // 返回等待统计
+    Counters counters() const;
+
+    // 入队，队满时等待，队列关闭时返回false
+    bool enqueue(const E& elem) { return push(elem, nullptr); }
+    // 移动元素入队，队满时等待，队列关闭时返回false且elem不被移动
+    bool enqueue(E&& elem) { return push(std::move(elem), nullptr); }
+    // 入队，队满时至多等待timeout，超时或队列关闭时返回false
+    template<typename Rep, typename Period>
+    bool try_enqueue(const E& elem, const std::chrono::duration<Rep, Period>& timeout);
+    // 移动元素入队，超时或队列关闭时返回false且elem不被移动
+    template<typename Rep, typename Period>
+    bool try_enqueue(E&& elem, const std::chrono::duration<Rep, Period>& timeout);
+    // 将从first开始的count个元素移动入队，队满时等待，返回入队的数量，队列关闭时可能少于count
+    template<typename InputIterator>
+    size_type enqueue_batch(InputIterator first, size_type count);
+    // 出队并移动队首元素到elem，队空时等待，队列关闭且为空时返回false
+    bool dequeue(E& elem) { return pop(&elem, 1, nullptr) == 1; }
+    // 出队，队空时至多等待timeout，超时或队列关闭且为空时返回false
+    template<typename Rep, typename Period>
+    bool try_dequeue(E& elem, const std::chrono::duration<Rep, Period>& timeout);
+    // 至多等待timeout直到队列非空，再将至多max个元素出队并移动到out，返回出队的数量
+    template<typename OutputIterator, typename Rep, typename Period>
+    size_type dequeue_batch(OutputIterator out, size_type max,
+                            const std::chrono::duration<Rep, Period>& timeout);
+    // 不等待，将至多max个元素出队并移动到out，返回出队的数量
+    template<typename OutputIterator>
+    size_type try_dequeue_batch(OutputIterator out, size_type max);
+    // 至多等待timeout直到队列非空或已关闭，不取走元素，超时返回false
+    template<typename Rep, typename Period>
+    bool wait_not_empty(const std::chrono::duration<Rep, Period>& timeout);
+    // 不等待，将所有元素出队并移动到out，返回出队的数量
+    template<typename OutputIterator>
+    size_type drain(OutputIterator out);
+    // 关闭队列，唤醒所有等待的线程
+    void close();
+private:
+    Container c; // 元素容器
+    size_type cap; // 队列容量
+    mutable std::mutex m; // 保护容器、等待者数量和统计
+    std::condition_variable not_empty; // 消费者等待的条件
+    std::condition_variable not_full; // 生产者等待的条件
+    int consumers; // 休眠的消费者数量
+    int producers; // 休眠的生产者数量
+    std::atomic<size_type> n; // 元素数量，持锁修改，自旋时不加锁读取
+    std::atomic<bool> is_closed; // 队列是否已关闭，持锁修改
+    Counters stats; // 等待统计
+
+    // 判断消费者或生产者的等待条件是否满足
+    bool ready(bool consumer) const;
+    // 等待条件满足或超时，返回条件是否满足，deadline为空时不超时
+    bool wait(std::unique_lock<std::mutex>& lock, bool consumer, const clock::time_point* deadline);
+    // 入队
+    template<typename T>
+    bool push(T&& elem, const clock::time_point* deadline);
+    // 出队至多max个元素
+    template<typename OutputIterator>
+    size_type pop(OutputIterator out, size_type max, const clock::time_point* deadline);
+    // 持锁时将至多max个元素出队
+    template<typename OutputIterator>
+    size_type take(OutputIterator out, size_type max);
+    // 返回从现在起经过timeout的时间点
+    template<typename Rep, typename Period>
+    static clock::time_point deadline_after(const std::chrono::duration<Rep, Period>& timeout)
+    { return clock::now() + std::chrono::duration_cast<clock::duration>(timeout); }
+};
+
+/**
+ * 构造函数.
+ *
+ * @param capacity: 队列容量，至少为1
+ */
+template<typename E, typename Container>
+BlockingQueue<E, Container>::BlockingQueue(size_type capacity)
+    : cap(std::max(capacity, size_type(1))), consumers(0), producers(0),
+      n(0), is_closed(false), stats()
+{
+}
+
+/**
+ * 返回等待统计.
+ *
+ * @return 等待统计的快照
+ */
+template<typename E, typename Container>
+typename BlockingQueue<E, Container>::Counters BlockingQueue<E, Container>::counters() const
+{
+    std::lock_guard<std::mutex> lock(m);
+    return stats;
+}
+
+/**
+ * 入队，队满时至多等待timeout.
+ *
+ * @param elem: 要添加的元素
+ *        timeout: 最长等待时间
+ * @return true: 入队成功
+ *         false: 超时或队列已关闭
+ */
+template<typename E, typename Container>
+template<typename Rep, typename Period>
+bool BlockingQueue<E, Container>::try_enqueue(const E& elem,
+                                              const std::chrono::duration<Rep, Period>& timeout)
+{
+    clock::time_point deadline = deadline_after(timeout);
+    return push(elem, &deadline);
+}
+
+/**
+ * 移动元素入队，队满时至多等待timeout.
+ *
+ * @param elem: 要添加的元素，失败时不被移动
+ *        timeout: 最长等待时间
+ * @return true: 入队成功
+ *         false: 超时或队列已关闭
+ */
+template<typename E, typename Container>
+template<typename Rep, typename Period>
+bool BlockingQueue<E, Container>::try_enqueue(E&& elem,
+                                              const std::chrono::duration<Rep, Period>& timeout)
+{
+    clock::time_point deadline = deadline_after(timeout);
+    return push(std::move(elem), &deadline);
+}
+
+/**
+ * 批量入队.
+ * 队列有空位时一次加锁移入尽可能多的元素，并一次唤醒所有休眠的消费者，
+ * 队满时等待，直到全部入队或队列关闭.
+ *
+ * @param first: 输入迭代器，元素被移动
+ *        count: 要入队的元素数量
+ * @return 入队的元素数量，队列关闭时可能少于count
+ */
+template<typename E, typename Container>
+template<typename InputIterator>
+typename BlockingQueue<E, Container>::size_type
+BlockingQueue<E, Container>::enqueue_batch(InputIterator first, size_type count)
+{
+    std::unique_lock<std::mutex> lock(m);
+    size_type done = 0;
+
+    while (done < count)
+    {
+        if (!wait(lock, false, nullptr) || closed())
+            break;
+        size_type k = n.load(std::memory_order_relaxed);
+        size_type room = std::min(cap - k, count - done);
+        for (size_type i = 0; i < room; ++i, ++first)
+            c.insert_back(std::move(*first));
+        done += room;
+        n.store(k + room, std::memory_order_relaxed);
+        if (consumers > 0 && room == 1)
+            not_empty.notify_one();
+        else if (consumers > 0 && room > 1)
+            not_empty.notify_all();
+    }
+    return done;
+}
+
+/**
+ * 出队，队空时至多等待timeout.
+ *
+ * @param elem: 保存队首元素
+ *        timeout: 最长等待时间
+ * @return true: 出队成功
+ *         false: 超时或队列已关闭且为空
+ */
+template<typename E, typename Container>
+template<typename Rep, typename Period>
+bool BlockingQueue<E, Container>::try_dequeue(E& elem,
+                                              const std::chrono::duration<Rep, Period>& timeout)
+{
+    clock::time_point deadline = deadline_after(timeout);
+    return pop(&elem, 1, &deadline) == 1;
+}
+
+/**
+ * 批量出队.
+ * 至多等待timeout直到队列非空，之后不再等待，取走当时可用的至多max个元素.
+ * 一次加锁取走多个元素，并一次唤醒所有休眠的生产者.
+ *
+ * @param out: 输出迭代器
+ *        max: 最多出队的元素数量
+ *        timeout: 最长等待时间
+ * @return 出队的元素数量，超时或队列已关闭且为空时为0
+ */
+template<typename E, typename Container>
+template<typename OutputIterator, typename Rep, typename Period>
+typename BlockingQueue<E, Container>::size_type
+BlockingQueue<E, Container>::dequeue_batch(OutputIterator out, size_type max,
+                                           const std::chrono::duration<Rep, Period>& timeout)
+{
+    clock::time_point deadline = deadline_after(timeout);
+    return pop(out, max, &deadline);
+}
+
+/**
+ * 不等待的批量出队.
+ * 取走当前可用的至多max个元素，队空时立即返回0，
+ * 不自旋也不计入等待统计，适合在持有其它锁时调用.
+ *
+ * @param out: 输出迭代器
+ *        max: 最多出队的元素数量
+ * @return 出队的元素数量
+ */
+template<typename E, typename Container>
+template<typename OutputIterator>
+typename BlockingQueue<E, Container>::size_type
+BlockingQueue<E, Container>::try_dequeue_batch(OutputIterator out, size_type max)
+{
+    std::unique_lock<std::mutex> lock(m);
+    return take(out, max);
+}
+
+/**
+ * 等待队列非空.
+ * 至多等待timeout，不取走元素，返回后其它消费者仍可能先取走元素.
+ * 与try_dequeue_batch()配合，使调用者在等待时不必持有自己的锁.
+ *
+ * @param timeout: 最长等待时间
+ * @return true: 队列非空或已关闭
+ *         false: 超时
+ */
+template<typename E, typename Container>
+template<typename Rep, typename Period>
+bool BlockingQueue<E, Container>::wait_not_empty(const std::chrono::duration<Rep, Period>& timeout)
+{
+    clock::time_point deadline = deadline_after(timeout);
+    std::unique_lock<std::mutex> lock(m);
+    return wait(lock, true, &deadline);
+}
+
+/**
+ * 将所有元素出队并移动到out，不等待.
+ * 关闭队列后调用可以取走剩余的元素.
+ *
+ * @param out: 输出迭代器
+ * @return 出队的元素数量
+ */
+template<typename E, typename Container>
+template<typename OutputIterator>
+typename BlockingQueue<E, Container>::size_type BlockingQueue<E, Container>::drain(OutputIterator out)
+{
+    std::lock_guard<std::mutex> lock(m);
+    size_type count = 0;
+
+    for (; !c.empty(); ++count, ++out)
+    {
+        *out = std::move(c.front());
+        c.remove_front();
+    }
+    n.store(0, std::memory_order_relaxed);
+    if (producers > 0 && count > 0)
+        not_full.notify_all();
+    return count;
+}
+
+/**
+ * 关闭队列.
+ * 之后的入队都失败，等待中的生产者返回false，
+ * 消费者取完剩余元素后返回false.
+ */
+template<typename E, typename Container>
+void BlockingQueue<E, Container>::close()
+{
+    std::lock_guard<std::mutex> lock(m);
+    is_closed.store(true, std::memory_order_release);
+    not_empty.notify_all();
+    not_full.notify_all();
+}
+
+/**
+ * 判断等待条件是否满足.
+ * 持锁时结果是准确的，自旋时不加锁调用只作为提示.
+ *
+ * @param consumer: true为消费者（队列非空），false为生产者（队列未满）
+ * @return 条件是否满足，队列已关闭时总是满足
+ */
+template<typename E, typename Container>
+bool BlockingQueue<E, Container>::ready(bool consumer) const
+{
+    if (is_closed.load(std::memory_order_acquire))
+        return true;
+    size_type k = n.load(std::memory_order_relaxed);
+    return consumer ? k > 0 : k < cap;
+}
+
+/**
+ * 等待条件满足.
+ * 先释放锁自旋SPIN_COUNT轮，条件仍不满足时登记为等待者并在条件变量上休眠，
+ * 因此短暂的等待不需要唤醒，而通知方只在有等待者时才调用notify.
+ * 调用前后都持有锁.
+ *
+ * @param lock: 已加锁的互斥锁
+ *        consumer: true为消费者，false为生产者
+ *        deadline: 超时时间点，为空时不超时
+ * @return true: 条件满足
+ *         false: 超时
+ */
+template<typename E, typename Container>
+bool BlockingQueue<E, Container>::wait(std::unique_lock<std::mutex>& lock, bool consumer,
+                                       const clock::time_point* deadline)
+{
+    if (ready(consumer))
+        return true;
+
+    clock::time_point start = clock::now();
+    bool ok = true;
+
+    lock.unlock();
+    for (int i = 0; i < SPIN_COUNT && !ready(consumer); ++i)
+        continue;
+    lock.lock();
+    if (ready(consumer))
+        stats.spins++;
+    else
+    {
+        std::condition_variable& cv = consumer ? not_empty : not_full;
+        int& waiters = consumer ? consumers : producers;
+
+        ++waiters;
+        stats.parks++;
+        while (!ready(consumer))
+        {
+            if (deadline == nullptr)
+                cv.wait(lock);
+            else if (cv.wait_until(lock, *deadline) == std::cv_status::timeout)
+            {
+                ok = ready(consumer);
+                break;
+            }
+            stats.wakeups++;
+        }
+        --waiters;
+    }
+    if (!ok)
+        stats.timeouts++;
+
+    unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - start).count();
+    stats.wait_ns += ns;
+    stats.max_wait_ns = std::max(stats.max_wait_ns, ns);
+    return ok;
+}
+
+/**
+ * 入队.
+ *
+ * @param elem: 要添加的元素，失败时不被移动
+ *        deadline: 超时时间点，为空时不超时
+ * @return true: 入队成功
+ *         false: 超时或队列已关闭
+ */
+template<typename E, typename Container>
+template<typename T>
+bool BlockingQueue<E, Container>::push(T&& elem, const clock::time_point* deadline)
+{
+    std::unique_lock<std::mutex> lock(m);
+
+    if (!wait(lock, false, deadline) || closed())
+        return false;
+    c.insert_back(std::forward<T>(elem));
+    n.store(n.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (consumers > 0)
+        not_empty.notify_one();
+    return true;
+}
+
+/**
+ * 出队至多max个元素.
+ *
+ * @param out: 输出迭代器
+ *        max: 最多出队的元素数量
+ *        deadline: 超时时间点，为空时不超时
+ * @return 出队的元素数量
+ */
+template<typename E, typename Container>
+template<typename OutputIterator>
+typename BlockingQueue<E, Container>::size_type
+BlockingQueue<E, Container>::pop(OutputIterator out, size_type max, const clock::time_point* deadline)
+{
+    std::unique_lock<std::mutex> lock(m);
+
+    if (!wait(lock, true, deadline))
+        return 0;
+    return take(out, max);
+}
+
+/**
+ * 持锁时将至多max个元素出队.
+ * 一次唤醒所有休眠的生产者.
+ *
+ * @param out: 输出迭代器
+ *        max: 最多出队的元素数量
+ * @return 出队的元素数量
+ */
+template<typename E, typename Container>
+template<typename OutputIterator>
+typename BlockingQueue<E, Container>::size_type
+BlockingQueue<E, Container>::take(OutputIterator out, size_type max)
+{
+    size_type count = 0;
+
+    for (; count < max && !c.empty(); ++count, ++out)
+    {
+        *out = std::move(c.front());
+        c.remove_front();
+    }
+    n.store(n.load(std::memory_order_relaxed) - count, std::memory_order_relaxed);
+    if (producers > 0 && count == 1)
+        not_full.notify_one();
+    else if (producers > 0 && count > 1)
+        not_full.notify_all();
+    return count;
+}
+
+} // namespace cpplib
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * Channel.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.9
+ ******************************************************************************/
+
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "Deque.h"
+#include "Executor.h"
+
+namespace cpplib
+{
+
+/**
+ * 协程之间传递元素的通道.
+ * co_await ch.send(x)在通道满时挂起发送方，co_await ch.receive()在通道空时挂起接收方，
+ * 挂起的协程不占用线程，条件满足时由对方放回自己的执行器的就绪队列.
+ * 元素和等待者都保存在Deque中，由一个互斥锁保护，可以在多线程执行器中使用.
+ * 有接收方等待时发送的元素直接交给接收方，不经过缓冲区.
+ * 关闭通道后发送失败，接收方取完剩余元素后收到空值.
+ * 等待的协程必须由Executor启动，恢复时放回启动它的执行器.
+ */
+template<typename E>
+class Channel
+{
+    class SendAwaiter;
+    class ReceiveAwaiter;
+public:
+    // 无界通道的容量
+    static constexpr size_t UNBOUNDED = size_t(-1);
+
+    explicit Channel(size_t capacity = UNBOUNDED) : cap(capacity > 0 ? capacity : 1), is_closed(false) {}
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // 返回通道的容量
+    size_t capacity() const { return cap; }
+    // 返回缓冲的元素数量
+    size_t size() const { std::lock_guard<std::mutex> lock(m); return buffer.size(); }
+    // 判断通道是否已关闭
+    bool closed() const { std::lock_guard<std::mutex> lock(m); return is_closed; }
+
+    // 发送元素，co_await的结果为false表示通道已关闭
+    SendAwaiter send(E elem) { return SendAwaiter(*this, std::move(elem)); }
+    // 接收元素，co_await的结果为空表示通道已关闭且取空
+    ReceiveAwaiter receive() { return ReceiveAwaiter(*this); }
+    // 关闭通道，唤醒所有等待的协程
+    void close();
+private:
+    // 挂起的协程及其执行器
+    struct Waiter
+    {
+        std::coroutine_handle<> handle;
+        Executor* executor;
+        void wake() { executor->schedule(handle); }
+    };
+
+    // 发送的等待体
+    class SendAwaiter : Waiter
+    {
+    public:
+        SendAwaiter(Channel& ch, E elem) : ch(ch), elem(std::move(elem)), ok(false) {}
+
+        bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> h);
+        bool await_resume() const noexcept { return ok; }
+    private:
+        friend class Channel;
+
+        Channel& ch; // 所属通道
+        E elem; // 要发送的元素
+        bool ok; // 是否发送成功
+    };
+
+    // 接收的等待体
+    class ReceiveAwaiter : Waiter
+    {
+    public:
+        explicit ReceiveAwaiter(Channel& ch) : ch(ch) {}
+
+        bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> h);
+        std::optional<E> await_resume() { return std::move(elem); }
+    private:
+        friend class Channel;
+
+        Channel& ch; // 所属通道
+        std::optional<E> elem; // 收到的元素
+    };
+
+    size_t cap; // 容量
+    mutable std::mutex m; // 保护缓冲区、等待者和关闭状态
+    Deque<E> buffer; // 缓冲的元素
+    Deque<SendAwaiter*> senders; // 等待的发送方
+    Deque<ReceiveAwaiter*> receivers; // 等待的接收方
+    bool is_closed; // 是否已关闭
+};
+
+/**
+ * 发送元素.
+ * 在await_suspend中持锁完成所有判断，不需要挂起时返回false，协程直接继续运行.
+ * 挂起时登记为等待者，解锁后本对象可能立即被其它线程恢复，不能再访问成员.
+ *
+ * @param h: 发送方协程
+ * @return true: 挂起
+ *         false: 已发送或通道已关闭，不挂起
+ */
+template<typename E>
+template<typename Promise>
+bool Channel<E>::SendAwaiter::await_suspend(std::coroutine_handle<Promise> h)
+{
+    std::unique_lock<std::mutex> lock(ch.m);
+
+    if (ch.is_closed)
+        return false;
+    if (!ch.receivers.empty())
+    {
+        ReceiveAwaiter* r = ch.receivers.front();
+        ch.receivers.remove_front();
+        r->elem.emplace(std::move(elem));
+        ok = true;
+        lock.unlock();
+        r->wake();
+        return false;
+    }
+    if (ch.buffer.size() < ch.cap)
+    {
+        ch.buffer.insert_back(std::move(elem));
+        ok = true;
+        return false;
+    }
+    this->handle = h;
+    this->executor = h.promise().executor;
+    ch.senders.insert_back(this);
+    return true;
+}
+
+/**
+ * 接收元素.
+ * 取走队首元素后，如果有发送方等待，把它的元素移入缓冲区并唤醒它.
+ *
+ * @param h: 接收方协程
+ * @return true: 挂起
+ *         false: 已收到元素或通道已关闭且取空，不挂起
+ */
+template<typename E>
+template<typename Promise>
+bool Channel<E>::ReceiveAwaiter::await_suspend(std::coroutine_handle<Promise> h)
+{
+    std::unique_lock<std::mutex> lock(ch.m);
+
+    if (!ch.buffer.empty())
+    {
+        elem.emplace(std::move(ch.buffer.front()));
+        ch.buffer.remove_front();
+        if (!ch.senders.empty())
+        {
+            SendAwaiter* s = ch.senders.front();
+            ch.senders.remove_front();
+            ch.buffer.insert_back(std::move(s->elem));
+            s->ok = true;
+            lock.unlock();
+            s->wake();
+        }
+        return false;
+    }
+    if (ch.is_closed)
+        return false;
+    this->handle = h;
+    this->executor = h.promise().executor;
+    ch.receivers.insert_back(this);
+    return true;
+}
+
+/**
+ * 关闭通道.
+ * 等待的发送方恢复后得到false，等待的接收方恢复后得到空值，
+ * 缓冲区中的元素仍可被接收.
+ */
+template<typename E>
+void Channel<E>::close()
+{
+    Deque<SendAwaiter*> s;
+    Deque<ReceiveAwaiter*> r;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        is_closed = true;
+        std::swap(s, senders);
+        std::swap(r, receivers);
+    }
+    for (; !s.empty(); s.remove_front())
+        s.front()->wake();
+    for (; !r.empty(); r.remove_front())
+        r.front()->wake();
+}
+
+} // namespace cpplib
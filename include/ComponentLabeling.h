@@ -0,0 +1,322 @@
+/*******************************************************************************
+ * ComponentLabeling.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.30
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "UnionFind.h"
+
+namespace cpplib
+{
+
+/**
+ * 二维图像和三维体数据的连通区域标记.
+ * 非零像素为前景，二维支持4邻接和8邻接，三维支持6邻接和26邻接，二维图像即深度为1的体数据.
+ * 两趟扫描：第一趟把每行的前景提取为游程，每个游程是UnionFind中的一个触点，
+ * 与之前相邻行中重叠的游程合并（8或26邻接时游程向两侧各扩展一格再比较）；
+ * 第二趟按游程填写标号，并统计每个区域的面积和包围盒.
+ * 多线程时沿最外层的轴（三维为z，二维为y）把数据切成若干块，
+ * 每块用自己的UnionFind独立完成第一趟，再在块的边界上合并相邻块的局部标号.
+ * 标号从1开始连续，0为背景，按区域第一个像素的扫描顺序编号，与线程数无关.
+ */
+class ComponentLabeling
+{
+public:
+    // 区域的面积和包围盒
+    struct Region
+    {
+        long long area;          // 像素数
+        int min_x, min_y, min_z; // 包围盒的最小坐标
+        int max_x, max_y, max_z; // 包围盒的最大坐标，包含在内
+    };
+
+    ComponentLabeling(const std::vector<uint8_t>& voxels, int width, int height, int depth,
+                      int connectivity, unsigned threads = 1);
+
+    // 返回区域数
+    int count() const { return int(regions.size()); }
+    // 返回(x, y, z)的标号，背景为0
+    int label(int x, int y, int z = 0) const;
+    // 返回所有像素的标号，下标为(z * height + y) * width + x
+    const std::vector<int>& labels() const { return image; }
+    // 返回标号为l的区域
+    const Region& region(int l) const;
+private:
+    // 一行中连续的前景像素[begin, end)
+    struct Run
+    {
+        int begin, end;
+    };
+
+    // 一块连续的行
+    struct Tile
+    {
+        int first, last;             // 块中行的范围[first, last)
+        std::vector<Run> runs;       // 所有游程，按行排列
+        std::vector<size_t> row;     // 第r行的游程为runs[row[r - first]]到runs[row[r - first + 1] - 1]
+        std::vector<int> local;      // 每个游程的局部标号
+        std::vector<Region> regions; // 每个局部标号的区域
+        int offset;                  // 局部标号在全局标号中的起点
+    };
+
+    int width, height, depth; // 尺寸
+    bool full;                // 是否为8或26邻接
+    std::vector<int> image;   // 标号
+    std::vector<Region> regions; // 下标为标号减一
+
+    // 第一趟扫描一块
+    void scan(const std::vector<uint8_t>& voxels, Tile& tile) const;
+    // 对a中第r行的游程与b中相邻的之前的行中重叠的游程调用f(i, j)
+    template<typename F>
+    void neighbors(const Tile& a, const Tile& b, int r, F f) const;
+    // 第二趟填写一块的标号
+    void paint(const Tile& tile, const std::vector<int>& global);
+};
+
+/**
+ * 构造函数，标记连通区域.
+ *
+ * @param voxels: 像素，非零为前景，下标为(z * height + y) * width + x
+ *        width: 宽度
+ *        height: 高度
+ *        depth: 深度，二维图像为1
+ *        connectivity: 邻接方式，二维为4或8，三维为6或26
+ *        threads: 线程数
+ * @throws std::invalid_argument: 尺寸与数据不符或邻接方式不合法
+ */
+inline ComponentLabeling::ComponentLabeling(const std::vector<uint8_t>& voxels, int width, int height,
+                                            int depth, int connectivity, unsigned threads)
+    : width(width), height(height), depth(depth), full(connectivity == 8 || connectivity == 26)
+{
+    if (width < 0 || height < 0 || depth < 0 || voxels.size() != size_t(width) * height * depth)
+        throw std::invalid_argument("ComponentLabeling::ComponentLabeling() size mismatch.");
+    if (!(connectivity == 6 || connectivity == 26 || (depth <= 1 && (connectivity == 4 || connectivity == 8))))
+        throw std::invalid_argument("ComponentLabeling::ComponentLabeling() invalid connectivity.");
+    image.assign(voxels.size(), 0);
+
+    // 按最外层的轴分块，块的边界落在整层上，跨块的相邻行只在相邻两块之间
+    int slices = depth > 1 ? depth : height * depth;
+    int per_slice = depth > 1 ? height : 1;
+    int tiles = std::max(1, std::min(int(std::max(threads, 1u)), slices));
+    std::vector<Tile> tile(tiles);
+    for (int t = 0; t < tiles; ++t)
+    {
+        tile[t].first = int((long long)slices * t / tiles) * per_slice;
+        tile[t].last = int((long long)slices * (t + 1) / tiles) * per_slice;
+    }
+
+    // 第一趟，各块独立
+    std::vector<std::thread> workers;
+    for (int t = 1; t < tiles; ++t)
+        workers.emplace_back([&, t] { scan(voxels, tile[t]); });
+    scan(voxels, tile[0]);
+    for (auto& w : workers)
+        w.join();
+
+    // 合并块的边界：每块第一层的行与上一块最后一层中相邻的行
+    int total = 0;
+    for (auto& t : tile)
+    {
+        t.offset = total;
+        total += int(t.regions.size());
+    }
+    UnionFind uf(total);
+    for (int t = 1; t < tiles; ++t)
+    {
+        const Tile& a = tile[t];
+        const Tile& b = tile[t - 1];
+        for (int r = a.first; r < a.first + per_slice; ++r)
+        {
+            neighbors(a, b, r, [&](size_t i, size_t j)
+            {
+                uf.join(a.offset + a.local[i], b.offset + b.local[j]);
+            });
+        }
+    }
+    std::vector<int> global = uf.flatten();
+
+    // 汇总区域
+    regions.assign(uf.count(), Region{ 0, width, height, depth, -1, -1, -1 });
+    for (auto& t : tile)
+    {
+        for (size_t k = 0; k < t.regions.size(); ++k)
+        {
+            Region& to = regions[global[t.offset + k]];
+            const Region& from = t.regions[k];
+            to.area += from.area;
+            to.min_x = std::min(to.min_x, from.min_x);
+            to.min_y = std::min(to.min_y, from.min_y);
+            to.min_z = std::min(to.min_z, from.min_z);
+            to.max_x = std::max(to.max_x, from.max_x);
+            to.max_y = std::max(to.max_y, from.max_y);
+            to.max_z = std::max(to.max_z, from.max_z);
+        }
+    }
+
+    // 第二趟，各块独立填写标号
+    workers.clear();
+    for (int t = 1; t < tiles; ++t)
+        workers.emplace_back([&, t] { paint(tile[t], global); });
+    paint(tile[0], global);
+    for (auto& w : workers)
+        w.join();
+}
+
+/**
+ * 返回(x, y, z)的标号.
+ *
+ * @param x: 列
+ *        y: 行
+ *        z: 层
+ * @return 标号，背景为0
+ * @throws std::out_of_range: 坐标不合法
+ */
+inline int ComponentLabeling::label(int x, int y, int z) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height || z < 0 || z >= depth)
+        throw std::out_of_range("ComponentLabeling::label() index out of range.");
+    return image[(size_t(z) * height + y) * width + x];
+}
+
+/**
+ * 返回标号为l的区域.
+ *
+ * @param l: 标号，从1开始
+ * @return 区域的面积和包围盒
+ * @throws std::out_of_range: 标号不合法
+ */
+inline const ComponentLabeling::Region& ComponentLabeling::region(int l) const
+{
+    if (l < 1 || l > count())
+        throw std::out_of_range("ComponentLabeling::region() index out of range.");
+    return regions[l - 1];
+}
+
+/**
+ * 第一趟扫描一块.
+ * 逐行提取游程并与块内之前相邻行中重叠的游程合并，
+ * 然后把块内的连通分量压平为局部标号，统计每个局部标号的区域.
+ *
+ * @param voxels: 像素
+ *        tile: 块
+ */
+inline void ComponentLabeling::scan(const std::vector<uint8_t>& voxels, Tile& tile) const
+{
+    tile.row.assign(tile.last - tile.first + 1, 0);
+    for (int r = tile.first; r < tile.last; ++r)
+    {
+        tile.row[r - tile.first] = tile.runs.size();
+        const uint8_t* line = voxels.data() + size_t(r) * width;
+        for (int x = 0; x < width; )
+        {
+            if (!line[x])
+            {
+                ++x;
+                continue;
+            }
+            int begin = x;
+            while (x < width && line[x])
+                ++x;
+            tile.runs.push_back({ begin, x });
+        }
+    }
+    tile.row.back() = tile.runs.size();
+
+    UnionFind uf(int(tile.runs.size()));
+    for (int r = tile.first; r < tile.last; ++r)
+        neighbors(tile, tile, r, [&](size_t i, size_t j) { uf.join(int(i), int(j)); });
+    tile.local = uf.flatten();
+
+    tile.regions.assign(uf.count(), Region{ 0, width, height, depth, -1, -1, -1 });
+    for (int r = tile.first; r < tile.last; ++r)
+    {
+        int y = r % height, z = r / height;
+        for (size_t i = tile.row[r - tile.first]; i < tile.row[r - tile.first + 1]; ++i)
+        {
+            Region& g = tile.regions[tile.local[i]];
+            g.area += tile.runs[i].end - tile.runs[i].begin;
+            g.min_x = std::min(g.min_x, tile.runs[i].begin);
+            g.max_x = std::max(g.max_x, tile.runs[i].end - 1);
+            g.min_y = std::min(g.min_y, y);
+            g.max_y = std::max(g.max_y, y);
+            g.min_z = std::min(g.min_z, z);
+            g.max_z = std::max(g.max_z, z);
+        }
+    }
+}
+
+/**
+ * 对a中第r行的游程与b中相邻的之前的行中重叠的游程调用f(i, j).
+ * 之前相邻的行为同一层的上一行，以及上一层的同一行，8或26邻接时还有上一层的上下两行.
+ * 两行的游程都按列排列，按结束位置归并，每对重叠的游程只访问一次.
+ *
+ * @param a: 第r行所在的块
+ *        b: 相邻行所在的块，只考虑落在b中的行
+ *        r: 行号，即z * height + y
+ *        f: 回调，参数为两个游程在a和b中的下标
+ */
+template<typename F>
+void ComponentLabeling::neighbors(const Tile& a, const Tile& b, int r, F f) const
+{
+    int y = r % height, z = r / height;
+    int adjacent[4];
+    int k = 0;
+    if (y > 0)
+        adjacent[k++] = r - 1;
+    if (z > 0)
+    {
+        adjacent[k++] = r - height;
+        if (full && y > 0)
+            adjacent[k++] = r - height - 1;
+        if (full && y < height - 1)
+            adjacent[k++] = r - height + 1;
+    }
+    int d = full ? 1 : 0; // 对角邻接时游程向两侧各扩展一格
+    for (int n = 0; n < k; ++n)
+    {
+        int s = adjacent[n];
+        if (s < b.first || s >= b.last)
+            continue;
+        size_t i = a.row[r - a.first], i_end = a.row[r - a.first + 1];
+        size_t j = b.row[s - b.first], j_end = b.row[s - b.first + 1];
+        while (i < i_end && j < j_end)
+        {
+            const Run& p = a.runs[i];
+            const Run& q = b.runs[j];
+            if (q.begin < p.end + d && p.begin < q.end + d)
+                f(i, j);
+            if (p.end < q.end)
+                ++i;
+            else
+                ++j;
+        }
+    }
+}
+
+/**
+ * 第二趟填写一块的标号.
+ *
+ * @param tile: 块
+ *        global: 全局标号到最终标号的映射，最终标号从0开始
+ */
+inline void ComponentLabeling::paint(const Tile& tile, const std::vector<int>& global)
+{
+    for (int r = tile.first; r < tile.last; ++r)
+    {
+        int* line = image.data() + size_t(r) * width;
+        for (size_t i = tile.row[r - tile.first]; i < tile.row[r - tile.first + 1]; ++i)
+        {
+            int l = global[tile.offset + tile.local[i]] + 1;
+            std::fill(line + tile.runs[i].begin, line + tile.runs[i].end, l);
+        }
+    }
+}
+
+} // namespace cpplib
@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * ConcurrentUnionFind.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.15
+ ******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * 无锁并发并查集.
+ * 多个线程可以同时调用find、join和connected.
+ * 根结点指向自身，合并时用CAS把优先级低的根指向优先级高的根，
+ * 根之间的全序保证不会形成环；CAS失败说明根已被其它线程合并，重新查找后重试.
+ * 查找时用CAS做路径分裂，CAS失败说明其它线程已经更新了该结点，直接跳过，
+ * 路径上的结点只会指向更高的祖先，压缩不影响正确性.
+ * 优先级默认是下标的随机置换（Jayanti-Tarjan随机合并），
+ * 期望树高为O(log n)，也可以直接按下标合并（Anderson-Woll）.
+ */
+template<typename Index = int>
+class ConcurrentUnionFind
+{
+    static_assert(std::is_signed<Index>::value, "ConcurrentUnionFind: Index must be a signed integer type");
+public:
+    // 成员类型定义
+    using index_type = Index;
+
+    explicit ConcurrentUnionFind(Index size, bool random_priority = true);
+    ConcurrentUnionFind(const ConcurrentUnionFind&) = delete;
+    ConcurrentUnionFind& operator=(const ConcurrentUnionFind&) = delete;
+
+    // 返回触点数
+    Index size() const { return n; }
+    // 返回连通分量数，并发修改时只是近似值
+    Index count() const { return components.load(std::memory_order_relaxed); }
+    // 找到p所属连通分量的根触点，并发合并时根可能随即改变
+    Index find(Index p);
+    // 判断p与q是否属于同一个连通分量
+    bool connected(Index p, Index q);
+    // 合并p与q所属的连通分量，返回是否由本次调用合并
+    bool join(Index p, Index q);
+private:
+    Index n; // 并查集大小
+    std::atomic<Index> components; // 连通分量的数量
+    std::unique_ptr<std::atomic<Index>[]> parent; // parent[i]为i的父触点，根触点指向自身
+    bool random; // 是否按随机优先级合并
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < n; }
+    // 判断根p的优先级是否低于根q
+    bool lower(Index p, Index q) const
+    {
+        return random ? LinkByRandomIndex::priority(p) < LinkByRandomIndex::priority(q) : p < q;
+    }
+    // 不检查下标的查找
+    Index root(Index p);
+};
+
+/**
+ * 构造函数，每个触点都是一个单独的连通分量.
+ *
+ * @param size: 并查集大小
+ *        random_priority: true按下标的随机置换合并，false按下标合并
+ */
+template<typename Index>
+ConcurrentUnionFind<Index>::ConcurrentUnionFind(Index size, bool random_priority)
+    : n(size), components(size), parent(new std::atomic<Index>[size]), random(random_priority)
+{
+    for (Index i = 0; i < n; ++i)
+        parent[i].store(i, std::memory_order_relaxed);
+}
+
+/**
+ * 找到p所属连通分量的根触点.
+ *
+ * @param p: 触点p
+ * @return 根触点
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+Index ConcurrentUnionFind<Index>::find(Index p)
+{
+    if (!valid(p))
+        throw std::out_of_range("ConcurrentUnionFind::find() index out of range.");
+    return root(p);
+}
+
+/**
+ * 查找根触点并分裂路径.
+ * 每个结点尝试指向其祖父结点，失败时其它线程已经把它指向了更高的祖先.
+ *
+ * @param p: 触点p
+ * @return 根触点
+ */
+template<typename Index>
+Index ConcurrentUnionFind<Index>::root(Index p)
+{
+    while (true)
+    {
+        Index q = parent[p].load(std::memory_order_acquire);
+        if (q == p)
+            return p;
+        Index r = parent[q].load(std::memory_order_acquire);
+        if (q != r)
+            parent[p].compare_exchange_weak(q, r, std::memory_order_release, std::memory_order_relaxed);
+        p = q;
+    }
+}
+
+/**
+ * 判断p与q是否属于同一个连通分量.
+ * 两次查找之间p的根可能被合并，根不同时确认p的根仍是根才返回false.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @return true: 属于同一个连通分量
+ *         false: 返回前的某一时刻不属于同一个连通分量
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+bool ConcurrentUnionFind<Index>::connected(Index p, Index q)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("ConcurrentUnionFind::connected() index out of range.");
+    while (true)
+    {
+        p = root(p);
+        q = root(q);
+        if (p == q)
+            return true;
+        if (parent[p].load(std::memory_order_seq_cst) == p)
+            return false;
+    }
+}
+
+/**
+ * 合并p与q所属的连通分量.
+ * 优先级低的根指向优先级高的根，CAS失败说明该根已不是根，重新查找.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @return true: 本次调用合并了两个连通分量
+ *         false: 已经属于同一个连通分量
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+bool ConcurrentUnionFind<Index>::join(Index p, Index q)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("ConcurrentUnionFind::join() index out of range.");
+    while (true)
+    {
+        p = root(p);
+        q = root(q);
+        if (p == q)
+            return false;
+        if (!lower(p, q))
+            std::swap(p, q);
+        Index expected = p;
+        if (parent[p].compare_exchange_strong(expected, q, std::memory_order_seq_cst))
+        {
+            components.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+} // namespace cpplib
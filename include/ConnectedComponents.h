@@ -0,0 +1,365 @@
+/*******************************************************************************
+ * ConnectedComponents.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.17
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * 并行连通分量.
+ * 一次性计算整个图的连通分量，按Afforest算法分三个阶段：
+ * 1. 采样：每个触点只处理少量邻边（边表则按步长抽取一部分边），
+ *    此时大部分触点已经并入最大的连通分量；
+ * 2. 跳过：随机抽样触点找出最大的连通分量，其中触点的剩余邻边不再处理；
+ * 3. 完成：处理剩余的边，最后压缩标号，得到从0开始的连续编号.
+ * 合并采用Shiloach-Vishkin的最小标号挂接，根指向更小的下标，
+ * 用CAS修改根，多个线程可以同时挂接.
+ * 输入可以是边表或压缩邻接表（CSR），CSR要求是无向图，每条边在两端各出现一次.
+ */
+template<typename Index = int>
+class ConnectedComponents
+{
+    static_assert(std::is_signed<Index>::value, "ConnectedComponents: Index must be a signed integer type");
+public:
+    // 成员类型定义
+    using index_type = Index;
+    using edge_type = std::pair<Index, Index>;
+
+    ConnectedComponents(Index size, const std::vector<edge_type>& edges, unsigned threads = 0);
+    ConnectedComponents(const std::vector<size_t>& offsets, const std::vector<Index>& neighbors,
+                        unsigned threads = 0);
+
+    // 返回触点数
+    Index vertices() const { return Index(label.size()); }
+    // 返回连通分量数
+    Index count() const { return Index(sizes.size()); }
+    // 返回p所属连通分量的编号
+    Index id(Index p) const;
+    // 返回p所属连通分量的大小
+    Index size(Index p) const { return sizes[id(p)]; }
+    // 判断p与q是否属于同一个连通分量
+    bool connected(Index p, Index q) const { return id(p) == id(q); }
+    // 返回所有触点的连通分量编号
+    const std::vector<Index>& labels() const { return label; }
+    // 返回所有连通分量的大小，下标为编号
+    const std::vector<Index>& component_sizes() const { return sizes; }
+private:
+    static const int NEIGHBOR_ROUNDS = 2;  // 采样阶段每个触点处理的邻边数
+    static const int SAMPLES = 1024;       // 寻找最大连通分量时抽样的触点数
+    static const size_t GRAIN = 4096;      // 每个线程每次领取的任务数
+
+    std::vector<Index> label; // 每个触点的连通分量编号，从0开始连续
+    std::vector<Index> sizes; // 每个连通分量的大小
+    std::unique_ptr<std::atomic<Index>[]> comp; // 计算过程中每个触点的父触点
+    unsigned workers; // 线程数
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < vertices(); }
+    // 把[0, count)分块交给多个线程执行f(first, last)
+    template<typename F>
+    void parallel_for(size_t count, F f) const;
+    // 合并u与v所在的树
+    void link(Index u, Index v);
+    // 把每个触点直接指向根
+    void compress();
+    // 抽样找出最大连通分量的根
+    Index sample_largest() const;
+    // 把根换成连续编号并统计大小
+    void finish();
+};
+
+/**
+ * 由边表计算连通分量.
+ * 先按步长抽取约2n条边分两轮合并，再跳过两端都已在最大连通分量中的边.
+ *
+ * @param size: 触点数
+ *        edges: 边表
+ *        threads: 线程数，0表示使用硬件线程数
+ * @throws std::out_of_range: 边的端点不合法
+ */
+template<typename Index>
+ConnectedComponents<Index>::ConnectedComponents(Index size, const std::vector<edge_type>& edges,
+                                                unsigned threads)
+    : label(size), comp(new std::atomic<Index>[size]),
+      workers(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+    std::atomic<bool> bad(false);
+    parallel_for(edges.size(), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            if (!valid(edges[i].first) || !valid(edges[i].second))
+                bad.store(true, std::memory_order_relaxed);
+    });
+    if (bad.load())
+        throw std::out_of_range("ConnectedComponents::ConnectedComponents() index out of range.");
+
+    parallel_for(size_t(size), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            comp[i].store(Index(i), std::memory_order_relaxed);
+    });
+    // 采样阶段，每隔stride条边抽取一条，分NEIGHBOR_ROUNDS轮处理，每轮之后压缩
+    size_t stride = std::max<size_t>(1, edges.size() / (NEIGHBOR_ROUNDS * std::max<size_t>(1, size)));
+    size_t samples = (edges.size() + stride - 1) / stride;
+    for (int r = 0; r < NEIGHBOR_ROUNDS; ++r)
+    {
+        size_t begin = samples * r / NEIGHBOR_ROUNDS;
+        parallel_for(samples * (r + 1) / NEIGHBOR_ROUNDS - begin, [&](size_t first, size_t last)
+        {
+            for (size_t i = begin + first; i < begin + last; ++i)
+                link(edges[i * stride].first, edges[i * stride].second);
+        });
+        compress();
+    }
+    // 完成阶段，两端都已在最大连通分量中的边可以跳过
+    Index largest = sample_largest();
+    if (stride > 1)
+    {
+        parallel_for(edges.size(), [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                if (i % stride == 0)
+                    continue;
+                Index u = edges[i].first, v = edges[i].second;
+                if (comp[u].load(std::memory_order_relaxed) == largest
+                    && comp[v].load(std::memory_order_relaxed) == largest)
+                    continue;
+                link(u, v);
+            }
+        });
+    }
+    finish();
+}
+
+/**
+ * 由无向图的压缩邻接表计算连通分量.
+ * 触点u的邻居为neighbors[offsets[u]]到neighbors[offsets[u + 1] - 1].
+ * 先让每个触点处理前两条邻边，再跳过最大连通分量中触点的剩余邻边，
+ * 这些边的另一端若不在最大连通分量中，会从另一端处理.
+ *
+ * @param offsets: 每个触点邻边的起始位置，共n + 1个
+ *        neighbors: 邻居数组
+ *        threads: 线程数，0表示使用硬件线程数
+ * @throws std::out_of_range: 偏移或邻居不合法
+ */
+template<typename Index>
+ConnectedComponents<Index>::ConnectedComponents(const std::vector<size_t>& offsets,
+                                                const std::vector<Index>& neighbors, unsigned threads)
+    : label(offsets.empty() ? 0 : offsets.size() - 1), comp(new std::atomic<Index>[label.size()]),
+      workers(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+    Index n = vertices();
+    std::atomic<bool> bad(false);
+
+    if (!offsets.empty() && offsets.back() != neighbors.size())
+        bad = true;
+    parallel_for(size_t(n), [&](size_t first, size_t last)
+    {
+        for (size_t u = first; u < last; ++u)
+            if (offsets[u] > offsets[u + 1])
+                bad.store(true, std::memory_order_relaxed);
+    });
+    parallel_for(neighbors.size(), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            if (!valid(neighbors[i]))
+                bad.store(true, std::memory_order_relaxed);
+    });
+    if (bad.load())
+        throw std::out_of_range("ConnectedComponents::ConnectedComponents() index out of range.");
+
+    parallel_for(size_t(n), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            comp[i].store(Index(i), std::memory_order_relaxed);
+    });
+    // 采样阶段，每轮每个触点处理一条邻边
+    for (int r = 0; r < NEIGHBOR_ROUNDS; ++r)
+    {
+        parallel_for(size_t(n), [&](size_t first, size_t last)
+        {
+            for (size_t u = first; u < last; ++u)
+                if (offsets[u] + r < offsets[u + 1])
+                    link(Index(u), neighbors[offsets[u] + r]);
+        });
+        compress();
+    }
+    // 完成阶段，跳过最大连通分量中的触点
+    Index largest = sample_largest();
+    parallel_for(size_t(n), [&](size_t first, size_t last)
+    {
+        for (size_t u = first; u < last; ++u)
+        {
+            if (comp[u].load(std::memory_order_relaxed) == largest)
+                continue;
+            for (size_t i = offsets[u] + NEIGHBOR_ROUNDS; i < offsets[u + 1]; ++i)
+                link(Index(u), neighbors[i]);
+        }
+    });
+    finish();
+}
+
+/**
+ * 返回p所属连通分量的编号.
+ *
+ * @param p: 触点p
+ * @return 连通分量编号
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+Index ConnectedComponents<Index>::id(Index p) const
+{
+    if (!valid(p))
+        throw std::out_of_range("ConnectedComponents::id() index out of range.");
+    return label[p];
+}
+
+/**
+ * 把[0, count)分成大小为GRAIN的块，多个线程轮流领取执行.
+ * 任务较少时直接在当前线程执行.
+ *
+ * @param count: 任务数
+ *        f: 处理一块任务的函数f(first, last)
+ */
+template<typename Index>
+template<typename F>
+void ConnectedComponents<Index>::parallel_for(size_t count, F f) const
+{
+    if (workers <= 1 || count <= GRAIN)
+    {
+        f(size_t(0), count);
+        return;
+    }
+    std::atomic<size_t> next(0);
+    auto work = [&]
+    {
+        size_t first;
+        while ((first = next.fetch_add(GRAIN, std::memory_order_relaxed)) < count)
+            f(first, std::min(count, first + GRAIN));
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < workers; ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto& t : threads)
+        t.join();
+}
+
+/**
+ * 合并u与v所在的树.
+ * 较大的根挂到较小的触点下，CAS失败说明该根已被其它线程挂接，沿父触点继续.
+ *
+ * @param u: 触点u
+ *        v: 触点v
+ */
+template<typename Index>
+void ConnectedComponents<Index>::link(Index u, Index v)
+{
+    Index p1 = comp[u].load(std::memory_order_relaxed);
+    Index p2 = comp[v].load(std::memory_order_relaxed);
+    while (p1 != p2)
+    {
+        Index high = std::max(p1, p2);
+        Index low = std::min(p1, p2);
+        Index parent = comp[high].load(std::memory_order_relaxed);
+        if (parent == low)
+            break;
+        if (parent == high && comp[high].compare_exchange_strong(parent, low, std::memory_order_relaxed))
+            break;
+        p1 = comp[comp[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+        p2 = comp[low].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * 把每个触点直接指向根.
+ * 父触点总是不大于自身，沿父触点走到不再变化即为根.
+ */
+template<typename Index>
+void ConnectedComponents<Index>::compress()
+{
+    parallel_for(label.size(), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            Index p = comp[i].load(std::memory_order_relaxed);
+            Index q;
+            while (p != (q = comp[p].load(std::memory_order_relaxed)))
+                p = q;
+            comp[i].store(p, std::memory_order_relaxed);
+        }
+    });
+}
+
+/**
+ * 抽样找出最大连通分量的根.
+ * 抽样前已经压缩过，每个触点直接指向根，出现次数最多的根即为所求.
+ *
+ * @return 最大连通分量的根，图为空时返回-1
+ */
+template<typename Index>
+Index ConnectedComponents<Index>::sample_largest() const
+{
+    if (label.empty())
+        return -1;
+    std::vector<Index> roots(SAMPLES);
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        size_t p = LinkByRandomIndex::priority(uint64_t(i)) % label.size();
+        roots[i] = comp[p].load(std::memory_order_relaxed);
+    }
+    std::sort(roots.begin(), roots.end());
+    Index best = roots[0];
+    int best_count = 0;
+    for (int i = 0, j; i < SAMPLES; i = j)
+    {
+        for (j = i; j < SAMPLES && roots[j] == roots[i]; ++j) {}
+        if (j - i > best_count)
+        {
+            best = roots[i];
+            best_count = j - i;
+        }
+    }
+    return best;
+}
+
+/**
+ * 把根换成连续编号并统计大小.
+ * 根是连通分量中最小的触点，按下标顺序编号，编号的顺序即最小触点的顺序.
+ */
+template<typename Index>
+void ConnectedComponents<Index>::finish()
+{
+    compress();
+    for (size_t i = 0; i < label.size(); ++i)
+    {
+        Index root = comp[i].load(std::memory_order_relaxed);
+        if (root == Index(i))
+        {
+            label[i] = Index(sizes.size());
+            sizes.push_back(0);
+        }
+        else
+            label[i] = label[root];
+        sizes[label[i]]++;
+    }
+    comp.reset();
+}
+
+} // namespace cpplib
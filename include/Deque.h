@@ -6,6 +6,7 @@
  ******************************************************************************/
 
 #pragma once
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -152,7 +153,7 @@ private:
     // 移除区块映射尾部的区块
     void remove_block_at_back();
     // 检查迭代器是否合法
-    bool valid(size_type i) const { return i >= 0 && i < size(); }
+    bool valid(size_type i) const { return i < size(); }
     // // 得到allocator
     // allocator_type allocator const noexcept { return allocator_type(); }
     // // 得到map_allocator
@@ -188,7 +189,8 @@ Deque<E>::Deque(size_type count, const E& value)
 template<typename E>
 Deque<E>::Deque(std::initializer_list<value_type> ilist)
 {
-
+    initialize_map(ilist.size());
+    uninitialized_copy(ilist.begin(), ilist.end(), it_begin);
 }
 
 /**
@@ -218,7 +220,7 @@ Deque<E>::Deque(Deque&& that) noexcept
     map = that.map;
     it_begin = that.it_begin;
     it_end = that.it_end;
-    that.map = nullptr; // 指向空指针，退出被析构
+    that.map = nullptr; // 指向空指针，析构时不再释放区块
 }
 
 /**
@@ -227,6 +229,9 @@ Deque<E>::Deque(Deque&& that) noexcept
 template<typename E>
 Deque<E>::~Deque()
 {
+    // 已被移动的双端队列不持有区块
+    if (map == nullptr)
+        return;
     // 析构掉所有区块内的元素
     if (it_begin.block == it_end.block)
         for (auto i = it_begin.current; i < it_end.current; ++i)
@@ -479,20 +484,25 @@ void Deque<E>::remove_back()
  * 移除双端队列迭代器指定位置的元素.
  *
  * @param pos: 指向移除位置的迭代器
+ * @throws std::out_of_range: pos不指向双端队列中的元素
  */
 template<typename E>
 void Deque<E>::remove(const_iterator pos)
 {
+    iterator it(pos);
+
+    if (it < it_begin || !(it < it_end))
+        throw std::out_of_range("Deque::remove");
     // 移除位置位于前半部分，则元素前移
-    if (pos - it_begin < difference_type(size() >> 1))
+    if (it - it_begin < difference_type(size() >> 1))
     {
-        std::copy_backward(it_begin, pos, std::next(it_begin));
+        std::move_backward(it_begin, it, std::next(it));
         remove_front();
     }
     // 移除位置位于后半部分，则元素后移
     else
     {
-        std::copy(std::next(pos), it_end, pos);
+        std::move(std::next(it), it_end, it);
         remove_back();
     }
 }
@@ -550,7 +560,9 @@ void Deque<E>::clear()
     // 移除[it_begin.block, it_end.block)范围的区块空间
     remove_block(it_begin.block, it_end.block);
     // 最后一个区块映射放到映射中央
-    std::swap(central_block, it_end.block);
+    *central_block = *it_end.block;
+    it_end.set_block(central_block);
+    it_end.current = it_end.head;
     it_begin = it_end;
 }
 
@@ -580,6 +592,8 @@ void Deque<E>::initialize_map(size_type count)
 
 /**
  * 重新安排映射的容量.
+ * 已使用的区块不到映射容量的一半时，只在原映射中居中区块，不扩容，
+ * 避免只在一端入队、另一端出队时映射无限增长.
  *
  * @param new_count: 新的映射容量
  * @param at_front: 标识是否将新增的容量安排在映射头部
@@ -587,21 +601,35 @@ void Deque<E>::initialize_map(size_type count)
 template<typename E>
 void Deque<E>::reserve_map(size_type new_count, bool at_front)
 {
+    // 已使用的区块数量
+    difference_type num_blocks = it_end.block - it_begin.block + 1;
+    map_pointer new_block_begin;
+
+    if (size_type(2 * num_blocks) < M)
+    {
+        new_block_begin = map + (M - num_blocks) / 2;
+        if (new_block_begin < it_begin.block)
+            std::copy(it_begin.block, it_end.block + 1, new_block_begin);
+        else
+            std::copy_backward(it_begin.block, it_end.block + 1, new_block_begin + num_blocks);
+    }
     // 如果新的容量小于当前映射容量，则映射不改变
-    if (new_count > M)
+    else if (new_count > M)
     {
         map_pointer new_map = map_allocator_traits::allocate(map_allocator, new_count);
         // 如果at_front，则将新增容量安排在映射头部，否则头部剩余容量不变
-        map_pointer new_block_begin = new_map + (it_begin.block - map)
-                                     + (at_front ? new_count - M : 0);
+        new_block_begin = new_map + (it_begin.block - map)
+                          + (at_front ? new_count - M : 0);
         // 复制区块映射指针到新的映射，不改变区块
         std::copy(it_begin.block, it_end.block + 1, new_block_begin);
         map_allocator_traits::deallocate(map_allocator, map, M);
         map = new_map;
         M = new_count;
-        it_begin.set_block(new_block_begin);
-        it_end.set_block(new_block_begin + size() - 1);
     }
+    else
+        return;
+    it_begin.set_block(new_block_begin);
+    it_end.set_block(new_block_begin + num_blocks - 1);
 }
 
 /**
@@ -772,7 +800,7 @@ public:
     using iterator          = DequeIterator<E, E*, E&>;
     using const_iterator    = DequeIterator<E, const E*, const E&>;
 private:
-    using map_pointer       = pointer*;
+    using map_pointer       = E**;
     // 区块大小
     static constexpr size_t BLOCK_SIZE = block_size(sizeof(E));
 public:
@@ -783,7 +811,9 @@ public:
     DequeIterator(const iterator& that) noexcept
     : block(that.block), current(that.current), head(that.head), tail(that.tail) {}
     DequeIterator(const const_iterator& that) noexcept
-    : block(that.block), current(that.current), head(that.head), tail(that.tail) {}
+    : block(that.block), current(const_cast<pointer>(that.current)),
+      head(const_cast<pointer>(that.head)), tail(const_cast<pointer>(that.tail)) {}
+    DequeIterator& operator=(const DequeIterator&) = default;
 
     reference operator*() const noexcept
     { return *current; }
@@ -798,7 +828,7 @@ public:
         if (current == tail)
         {
             set_block(block + 1);
-            current = 0;
+            current = head;
         }
         return *this;
     }
@@ -832,8 +862,12 @@ public:
     }
     DequeIterator& operator--() noexcept
     {
+        // 当前区块已到头，则跳到上一个区块的尾部
         if (current == head)
+        {
             set_block(block - 1);
+            current = tail;
+        }
         --current;
         return *this;
     }
@@ -886,17 +920,19 @@ private:
     friend class DequeIterator<E, E*, E&>;
     friend class DequeIterator<E, const E*, const E&>;
 
-    friend void uninitialized_fill(iterator& first, iterator& last, const value_type& value);
-    friend void uninitialized_copy(iterator& first, iterator& last, iterator destination);
+    template<typename T>
+    friend void uninitialized_fill(const DequeIterator<T, T*, T&>& first,
+                                   const DequeIterator<T, T*, T&>& last,
+                                   const T& value);
 };
 
-template<typename E, typename Ptr, typename Ref>
+template<typename E>
 void uninitialized_fill(const DequeIterator<E, E*, E&>& first,
                         const DequeIterator<E, E*, E&>& last,
                         const E& value)
 {
     using map_pointer = typename DequeIterator<E, E*, E&>::map_pointer;
-    using BLOCK_SIZE = DequeIterator<E, E*, E&>::BLOCK_SIZE;
+    const size_t BLOCK_SIZE = DequeIterator<E, E*, E&>::BLOCK_SIZE;
 
     map_pointer block;
 
@@ -920,12 +956,12 @@ void uninitialized_fill(const DequeIterator<E, E*, E&>& first,
 
 }
 
-template<typename E, typename Ptr, typename Ref>
-void uninitialized_copy(const DequeIterator<E, E*, E&>& first,
-                        const DequeIterator<E, E*, E&>& last,
+template<typename InputIterator, typename E>
+void uninitialized_copy(InputIterator first, InputIterator last,
                         DequeIterator<E, E*, E&> destination)
 {
-
+    for (; first != last; ++first, ++destination)
+        new (&*destination) E(*first);
 }
 
 } // namespace cpplib
@@ -0,0 +1,912 @@
+/*******************************************************************************
+ * DisjointSets.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.12
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpplib
+{
+
+/**
+ * 合并策略.
+ * link(parent, n, rootP, rootQ)把两个不同的根结点合并，返回新的根结点.
+ * 根结点在parent数组中保存负数，负数的含义由策略决定，
+ * 因此父结点和秩（或大小）共用一个数组，访问一个结点只触及一个缓存行.
+ * 每个策略有一个编号id，保存快照时记录在文件头中，载入时据此确认负数的含义相同；
+ * stores_size表示负数是否就是分量大小的相反数，此时分量大小直接从根结点读出.
+ */
+
+// 按秩合并，根结点保存-(秩+1)，秩小的树合并到秩大的树
+struct LinkByRank
+{
+    static const uint32_t id = 1; // 快照中记录的编号
+    static const bool stores_size = false; // 根结点是否保存分量大小
+
+    template<typename Index>
+    static Index link(Index* parent, Index, Index rootP, Index rootQ)
+    {
+        if (parent[rootP] > parent[rootQ])
+            std::swap(rootP, rootQ);
+        if (parent[rootP] == parent[rootQ])
+            parent[rootP]--; // 两棵树的秩相等，合并后秩加一
+        parent[rootQ] = rootP;
+        return rootP;
+    }
+};
+
+// 按大小合并，根结点保存-大小，小的树合并到大的树
+struct LinkBySize
+{
+    static const uint32_t id = 2; // 快照中记录的编号
+    static const bool stores_size = true; // 根结点是否保存分量大小
+
+    template<typename Index>
+    static Index link(Index* parent, Index, Index rootP, Index rootQ)
+    {
+        if (parent[rootP] > parent[rootQ])
+            std::swap(rootP, rootQ);
+        parent[rootP] += parent[rootQ];
+        parent[rootQ] = rootP;
+        return rootP;
+    }
+};
+
+// 按随机下标合并，结点的优先级是下标的随机置换，优先级低的根合并到优先级高的根，根结点保存-1
+struct LinkByRandomIndex
+{
+    static const uint32_t id = 3; // 快照中记录的编号
+    static const bool stores_size = false; // 根结点是否保存分量大小
+
+    template<typename Index>
+    static Index link(Index* parent, Index, Index rootP, Index rootQ)
+    {
+        if (priority(rootP) < priority(rootQ))
+            std::swap(rootP, rootQ);
+        parent[rootQ] = rootP;
+        return rootP;
+    }
+
+    // splitmix64的混合函数，是64位整数上的双射，不同下标的优先级不同
+    static uint64_t priority(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+};
+
+// 直接把p的根合并到q的根，即快速合并，根结点保存-1
+struct LinkNaive
+{
+    static const uint32_t id = 4; // 快照中记录的编号
+    static const bool stores_size = false; // 根结点是否保存分量大小
+
+    template<typename Index>
+    static Index link(Index* parent, Index, Index rootP, Index rootQ)
+    {
+        parent[rootP] = rootQ;
+        return rootQ;
+    }
+};
+
+// 把p的分量的所有结点直接指向q的根，即快速查找，树的高度始终不超过1，根结点保存-1
+struct LinkRelabel
+{
+    static const uint32_t id = 5; // 快照中记录的编号
+    static const bool stores_size = false; // 根结点是否保存分量大小
+
+    template<typename Index>
+    static Index link(Index* parent, Index n, Index rootP, Index rootQ)
+    {
+        parent[rootP] = rootQ;
+        for (Index i = 0; i < n; ++i)
+            if (parent[i] == rootP)
+                parent[i] = rootQ;
+        return rootQ;
+    }
+};
+
+/**
+ * 路径压缩策略.
+ * find(parent, p)返回p的根结点，并按策略缩短经过的路径.
+ * find(parent, offset, p, potential)用于带权并查集，offset[i]为i相对父结点的偏移，
+ * 压缩时一并更新偏移，potential返回p相对根结点的偏移，偏移所在的群需满足交换律.
+ */
+
+// 完全压缩，两趟遍历，第二趟把路径上的结点都指向根
+struct CompressFull
+{
+    template<typename Index>
+    static Index find(Index* parent, Index p)
+    {
+        Index root = p;
+        while (parent[root] >= 0)
+            root = parent[root];
+        while (parent[p] >= 0 && parent[p] != root)
+        {
+            Index next = parent[p];
+            parent[p] = root;
+            p = next;
+        }
+        return root;
+    }
+
+    // 第一趟求出p相对根的偏移，第二趟把路径上的结点指向根并改为相对根的偏移
+    template<typename Index, typename G>
+    static Index find(Index* parent, G* offset, Index p, G& potential)
+    {
+        Index root = p;
+        G sum = G();
+        while (parent[root] >= 0)
+        {
+            sum = sum + offset[root];
+            root = parent[root];
+        }
+        potential = sum;
+        while (parent[p] >= 0 && parent[p] != root)
+        {
+            Index next = parent[p];
+            G old = offset[p];
+            parent[p] = root;
+            offset[p] = sum;
+            sum = sum - old;
+            p = next;
+        }
+        return root;
+    }
+};
+
+// 路径减半，每隔一个结点指向其祖父结点
+struct CompressHalving
+{
+    template<typename Index>
+    static Index find(Index* parent, Index p)
+    {
+        while (parent[p] >= 0)
+        {
+            Index q = parent[p];
+            if (parent[q] < 0)
+                return q;
+            parent[p] = parent[q];
+            p = parent[q];
+        }
+        return p;
+    }
+
+    // 跳过的结点不在p的新路径上，沿新路径累加偏移即为p相对根的偏移
+    template<typename Index, typename G>
+    static Index find(Index* parent, G* offset, Index p, G& potential)
+    {
+        potential = G();
+        while (parent[p] >= 0)
+        {
+            Index q = parent[p];
+            if (parent[q] >= 0)
+            {
+                offset[p] = offset[p] + offset[q];
+                parent[p] = parent[q];
+            }
+            potential = potential + offset[p];
+            p = parent[p];
+        }
+        return p;
+    }
+};
+
+// 路径分裂，每个结点指向其祖父结点
+struct CompressSplitting
+{
+    template<typename Index>
+    static Index find(Index* parent, Index p)
+    {
+        while (parent[p] >= 0)
+        {
+            Index q = parent[p];
+            if (parent[q] < 0)
+                return q;
+            parent[p] = parent[q];
+            p = q;
+        }
+        return p;
+    }
+
+    // 分裂后p的路径已经缩短，再沿新路径累加一次偏移
+    template<typename Index, typename G>
+    static Index find(Index* parent, G* offset, Index p, G& potential)
+    {
+        Index start = p;
+        while (parent[p] >= 0)
+        {
+            Index q = parent[p];
+            if (parent[q] < 0)
+                break;
+            offset[p] = offset[p] + offset[q];
+            parent[p] = parent[q];
+            p = q;
+        }
+        potential = G();
+        for (p = start; parent[p] >= 0; p = parent[p])
+            potential = potential + offset[p];
+        return p;
+    }
+};
+
+// 不压缩路径
+struct CompressNone
+{
+    template<typename Index>
+    static Index find(Index* parent, Index p)
+    {
+        while (parent[p] >= 0)
+            p = parent[p];
+        return p;
+    }
+
+    // 沿路径累加偏移
+    template<typename Index, typename G>
+    static Index find(Index* parent, G* offset, Index p, G& potential)
+    {
+        potential = G();
+        for (; parent[p] >= 0; p = parent[p])
+            potential = potential + offset[p];
+        return p;
+    }
+};
+
+/**
+ * 并查集快照的文件头.
+ * 文件由文件头和parent数组组成，记录成员的并查集之后还有next数组，
+ * 合并策略不保存大小时再有sizes数组，flags记录包含哪些数组，
+ * 数组按本机字节序原样保存，文件头长40字节，每个数组末尾补零到8字节的整数倍，
+ * 因此每个数组都从8字节对齐的位置开始，可以直接映射到内存中使用.
+ * 版本号在格式改变时递增，下标宽度和合并策略不符的快照拒绝载入.
+ */
+struct DisjointSetsHeader
+{
+    static const uint32_t VERSION = 2; // 当前的格式版本
+    static const uint32_t FLAT = 1;    // 每个触点都直接指向根
+    static const uint32_t NEXT = 2;    // 包含next数组
+    static const uint32_t SIZES = 4;   // 包含sizes数组
+
+    char magic[8];       // 文件标识"CPPLIBDS"
+    uint32_t version;    // 格式版本
+    uint32_t index_size; // 下标类型的字节数
+    uint32_t link;       // 合并策略的编号，决定根结点中负数的含义
+    uint32_t flags;      // FLAT、NEXT和SIZES的组合
+    uint64_t size;       // 触点数
+    uint64_t components; // 连通分量数
+
+    // 检查文件头，link为0时不检查合并策略
+    void check(uint32_t index_bytes, uint32_t link_id, const char* what) const;
+    // 返回一个数组连同补齐在文件中占用的字节数
+    uint64_t array_bytes() const { return (size * index_size + 7) / 8 * 8; }
+};
+
+/**
+ * 检查文件头.
+ * 依次检查文件标识、版本、下标宽度和合并策略.
+ *
+ * @param index_bytes: 下标类型的字节数
+ *        link_id: 合并策略的编号，0表示不检查
+ *        what: 异常信息
+ * @throws std::invalid_argument: 文件头与要求不符
+ */
+inline void DisjointSetsHeader::check(uint32_t index_bytes, uint32_t link_id, const char* what) const
+{
+    if (std::memcmp(magic, "CPPLIBDS", sizeof(magic)) != 0 || version != VERSION ||
+        index_size != index_bytes || (link_id != 0 && link != link_id) || components > size)
+        throw std::invalid_argument(what);
+}
+
+/**
+ * 基于策略的并查集.
+ * 所有结点的父结点保存在一个数组中，根结点保存负数，
+ * 负数的含义（秩或大小）由LinkPolicy决定，路径压缩由CompressPolicy决定.
+ * QuickFind、QuickUnion、WeightedUnion和UnionFind都是它的别名.
+ * make_set()追加新的触点，数组容量不足时翻倍，均摊O(1).
+ * save()把数组写入带版本的快照文件，load()读回为可修改的并查集，
+ * MappedDisjointSets把快照只读地映射到内存中用于查询.
+ * TrackMembers为true时每个连通分量的触点还串成一个环，next[i]为同一分量中的下一个触点，
+ * 合并时交换两个根的后继即把两个环连成一个，枚举分量的成员为O(分量大小)；
+ * 合并策略不保存大小时另用sizes数组记录根的分量大小.
+ * 默认只有parent一个数组，合并只触及两个根，需要枚举成员时才打开TrackMembers.
+ * component_size()在合并策略保存大小或TrackMembers为true时可用，只需一次查找.
+ */
+template<typename Index = int, typename LinkPolicy = LinkByRank, typename CompressPolicy = CompressHalving,
+         bool TrackMembers = false>
+class DisjointSets
+{
+    static_assert(std::is_signed<Index>::value, "DisjointSets: Index must be a signed integer type");
+
+    // 是否需要sizes数组
+    static constexpr bool track_sizes = TrackMembers && !LinkPolicy::stores_size;
+private:
+    Index n;          // 并查集大小
+    Index components; // 连通分量的数量
+    Index capacity;   // 数组的容量
+    Index* parent;    // parent[i]为i的父结点，根结点为负数
+    Index* next;      // next[i]为与i同一连通分量的下一个触点，构成环，不记录成员时为空
+    Index* sizes;     // sizes[i]为以i为根的连通分量的大小，只对根有效，不需要时为空
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < n; }
+    // 根据parent数组重建成员环和分量大小
+    void rebuild_members();
+    // 检查载入的数组是否构成合法的并查集
+    void validate(bool has_next, bool has_sizes) const;
+public:
+    // 成员类型定义
+    using index_type = Index;
+    using link_policy = LinkPolicy;
+    using compress_policy = CompressPolicy;
+
+    explicit DisjointSets(Index size = 0);
+    DisjointSets(const DisjointSets& that);
+    DisjointSets(DisjointSets&& that) noexcept;
+    ~DisjointSets() { delete[] parent; delete[] next; delete[] sizes; }
+
+    // 判断p与q是否属于同一个连通分量
+    bool connected(Index p, Index q) { return find(p) == find(q); }
+    // 返回连通分量数
+    Index count() const { return components; }
+    // 返回触点数
+    Index size() const { return n; }
+    // 找到p所属连通分量的标识符
+    Index find(Index p);
+    // 返回p所属连通分量的大小
+    Index component_size(Index p);
+    // 返回与p同一连通分量的下一个触点，从p出发沿next_member()回到p即遍历整个分量
+    Index next_member(Index p) const;
+    // 返回p所属连通分量的所有触点
+    std::vector<Index> members(Index p) const;
+    // 压缩所有路径，返回每个触点的连通分量编号，编号从0开始连续
+    std::vector<Index> flatten();
+    // 压缩所有路径，每个触点直接指向根
+    void compress();
+    // 保存快照
+    void save(const std::string& path) const;
+    // 载入快照
+    static DisjointSets load(const std::string& path);
+    // 合并p与q所属的连通分量，返回是否合并了两个不同的分量
+    bool join(Index p, Index q);
+    // 追加一个单独的触点，返回其下标
+    Index make_set();
+    // 预留至少size个触点的空间
+    void reserve(Index size);
+    // 内容与另一个DisjointSets对象交换
+    void swap(DisjointSets& that);
+
+    DisjointSets& operator=(DisjointSets that);
+};
+
+/**
+ * 并查集构造函数，初始化并查集.
+ * 将每个触点都初始化为一个单独的连通分量，根结点保存-1，
+ * 即秩为0、大小为1，记录成员时每个触点自成一个环.
+ *
+ * @param size: 指定的并查集大小
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::DisjointSets(Index size)
+{
+    n = size;
+    components = n; // n个连通分量
+    capacity = n;
+    parent = n > 0 ? new Index[n] : nullptr;
+    next = TrackMembers && n > 0 ? new Index[n] : nullptr;
+    sizes = track_sizes && n > 0 ? new Index[n] : nullptr;
+    for (Index i = 0; i < n; i++)
+    {
+        parent[i] = -1;
+        if (TrackMembers) next[i] = i;
+        if (track_sizes) sizes[i] = 1;
+    }
+}
+
+/**
+ * 并查集复制构造函数.
+ *
+ * @param that: 被复制的并查集
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::DisjointSets(const DisjointSets& that)
+{
+    n = that.n;
+    components = that.components;
+    capacity = n;
+    parent = n > 0 ? new Index[n] : nullptr;
+    next = TrackMembers && n > 0 ? new Index[n] : nullptr;
+    sizes = track_sizes && n > 0 ? new Index[n] : nullptr;
+    std::copy(that.parent, that.parent + n, parent);
+    if (next) std::copy(that.next, that.next + n, next);
+    if (sizes) std::copy(that.sizes, that.sizes + n, sizes);
+}
+
+/**
+ * 并查集移动构造函数.
+ *
+ * @param that: 被移动的并查集
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::DisjointSets(DisjointSets&& that) noexcept
+{
+    n = that.n;
+    components = that.components;
+    capacity = that.capacity;
+    parent = that.parent;
+    next = that.next;
+    sizes = that.sizes;
+    that.n = 0;            // 被移动的并查集成为合法的空并查集
+    that.components = 0;
+    that.capacity = 0;
+    that.parent = nullptr; // 指向空指针，退出被析构
+    that.next = nullptr;
+    that.sizes = nullptr;
+}
+
+/**
+ * 找到p所属连通分量的标识符.
+ *
+ * @param p: 触点p
+ * @return p所属连通分量的根触点
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+Index DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::find(Index p)
+{
+    if (!valid(p))
+        throw std::out_of_range("DisjointSets::find() index out of range.");
+    return CompressPolicy::find(parent, p);
+}
+
+/**
+ * 合并p与q所属的连通分量.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @return true: 合并了两个不同的连通分量
+ *         false: p与q已经属于同一个连通分量
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+bool DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::join(Index p, Index q)
+{
+    Index rootP = find(p);
+    Index rootQ = find(q);
+
+    // 已经属于同一个连通分量中则返回
+    if (rootP == rootQ) return false;
+    Index root = LinkPolicy::link(parent, n, rootP, rootQ);
+    if (track_sizes)
+        sizes[root] = sizes[rootP] + sizes[rootQ];
+    if (TrackMembers)
+        std::swap(next[rootP], next[rootQ]); // 两个环在交换处断开后连成一个环
+    components--;
+    return true;
+}
+
+/**
+ * 返回p所属连通分量的大小.
+ * 合并策略保存大小时直接读根结点，否则读sizes数组.
+ *
+ * @param p: 触点p
+ * @return 连通分量的大小
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+Index DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::component_size(Index p)
+{
+    static_assert(LinkPolicy::stores_size || TrackMembers,
+                  "DisjointSets::component_size() requires LinkBySize or TrackMembers");
+    Index root = find(p);
+    return LinkPolicy::stores_size ? Index(-parent[root]) : sizes[root];
+}
+
+/**
+ * 返回与p同一连通分量的下一个触点.
+ *
+ * @param p: 触点p
+ * @return 环上p的后继
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+Index DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::next_member(Index p) const
+{
+    static_assert(TrackMembers, "DisjointSets::next_member() requires TrackMembers");
+    if (!valid(p))
+        throw std::out_of_range("DisjointSets::next_member() index out of range.");
+    return next[p];
+}
+
+/**
+ * 返回p所属连通分量的所有触点.
+ * 沿环走一圈，时间与分量大小成正比，从p开始按环的顺序排列.
+ *
+ * @param p: 触点p
+ * @return 连通分量的所有触点
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+std::vector<Index> DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::members(Index p) const
+{
+    static_assert(TrackMembers, "DisjointSets::members() requires TrackMembers");
+    if (!valid(p))
+        throw std::out_of_range("DisjointSets::members() index out of range.");
+    std::vector<Index> result;
+    Index q = p;
+    do
+    {
+        result.push_back(q);
+        q = next[q];
+    } while (q != p);
+    return result;
+}
+
+/**
+ * 压缩所有路径并给连通分量编号.
+ * 按下标顺序一趟扫描，每个触点直接指向根，按根第一次出现的顺序编号，
+ * 结果数组同时作为根的编号表：根r的编号保存在labels[r]中，
+ * 根在自身被扫描之前就可能被其成员分配编号.
+ *
+ * @return 每个触点的连通分量编号，从0到count() - 1
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+std::vector<Index> DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::flatten()
+{
+    std::vector<Index> labels(n, -1);
+    Index next_label = 0;
+    for (Index i = 0; i < n; ++i)
+    {
+        Index root = CompressFull::find(parent, i);
+        if (labels[root] < 0)
+            labels[root] = next_label++;
+        labels[i] = labels[root];
+    }
+    return labels;
+}
+
+/**
+ * 压缩所有路径.
+ * 按下标顺序完全压缩每个触点的路径，之后每个触点直接指向根，
+ * 保存快照前调用可使映射后的查找只需一步.
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::compress()
+{
+    for (Index i = 0; i < n; ++i)
+        CompressFull::find(parent, i);
+}
+
+/**
+ * 保存快照.
+ * 写入文件头和parent数组，以及存在的next、sizes数组，每个数组补齐到8字节，
+ * 文件头记录下标宽度、合并策略、包含的数组以及是否每个触点都直接指向根.
+ *
+ * @param path: 文件路径
+ * @throws std::runtime_error: 文件无法写入
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::save(const std::string& path) const
+{
+    DisjointSetsHeader header;
+    std::memcpy(header.magic, "CPPLIBDS", sizeof(header.magic));
+    header.version = DisjointSetsHeader::VERSION;
+    header.index_size = sizeof(Index);
+    header.link = LinkPolicy::id;
+    header.flags = DisjointSetsHeader::FLAT;
+    if (TrackMembers) header.flags |= DisjointSetsHeader::NEXT;
+    if (track_sizes) header.flags |= DisjointSetsHeader::SIZES;
+    header.size = uint64_t(n);
+    header.components = uint64_t(components);
+    for (Index i = 0; i < n; ++i)
+    {
+        if (parent[i] >= 0 && parent[parent[i]] >= 0)
+        {
+            header.flags &= ~DisjointSetsHeader::FLAT;
+            break;
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::streamsize bytes = std::streamsize(n) * std::streamsize(sizeof(Index));
+    std::streamsize pad = std::streamsize(header.array_bytes()) - bytes;
+    const char zeros[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(parent), bytes);
+    out.write(zeros, pad);
+    if (TrackMembers)
+    {
+        out.write(reinterpret_cast<const char*>(next), bytes);
+        out.write(zeros, pad);
+    }
+    if (track_sizes)
+    {
+        out.write(reinterpret_cast<const char*>(sizes), bytes);
+        out.write(zeros, pad);
+    }
+    out.close();
+    if (!out)
+        throw std::runtime_error("DisjointSets::save() cannot write " + path);
+}
+
+/**
+ * 载入快照.
+ * 检查文件头后把数组直接读入新的并查集，压缩策略可以与保存时不同.
+ * 快照与并查集是否记录成员可以不同：多余的数组被跳过，缺少的成员环和分量大小由parent重建.
+ * 分配数组之前先核对文件长度，读入后用O(n)时间检查数组内容，损坏的快照不会造成过量分配、越界访问或死循环.
+ *
+ * @param path: 文件路径
+ * @return 并查集
+ * @throws std::runtime_error: 文件无法读取或长度不足
+ *         std::invalid_argument: 不是快照文件，版本、下标宽度、合并策略不符，或数组内容不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    DisjointSetsHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("DisjointSets::load() cannot read " + path);
+    header.check(sizeof(Index), LinkPolicy::id, "DisjointSets::load() incompatible snapshot.");
+    if (header.size > uint64_t(std::numeric_limits<Index>::max()))
+        throw std::invalid_argument("DisjointSets::load() incompatible snapshot.");
+    // 分配数组之前按文件长度检查头部声明的触点数，先比较除法的结果以免乘法溢出
+    uint64_t arrays = 1 + ((header.flags & DisjointSetsHeader::NEXT) != 0) +
+                      ((header.flags & DisjointSetsHeader::SIZES) != 0);
+    in.seekg(0, std::ios::end);
+    uint64_t room = (uint64_t(in.tellg()) - sizeof(DisjointSetsHeader)) / arrays;
+    if (!in || header.size > room / sizeof(Index) || header.array_bytes() > room)
+        throw std::runtime_error("DisjointSets::load() truncated " + path);
+    in.seekg(sizeof(DisjointSetsHeader), std::ios::beg);
+
+    DisjointSets result;
+    result.reserve(Index(header.size));
+    std::streamsize bytes = std::streamsize(header.size) * std::streamsize(sizeof(Index));
+    std::streamsize pad = std::streamsize(header.array_bytes()) - bytes;
+    in.read(reinterpret_cast<char*>(result.parent), bytes);
+    in.seekg(pad, std::ios::cur);
+    if (header.flags & DisjointSetsHeader::NEXT)
+    {
+        if (TrackMembers) in.read(reinterpret_cast<char*>(result.next), bytes);
+        else              in.seekg(bytes, std::ios::cur);
+        in.seekg(pad, std::ios::cur);
+    }
+    if (header.flags & DisjointSetsHeader::SIZES)
+    {
+        if (track_sizes) in.read(reinterpret_cast<char*>(result.sizes), bytes);
+        else             in.seekg(bytes, std::ios::cur);
+    }
+    if (!in)
+        throw std::runtime_error("DisjointSets::load() truncated " + path);
+    result.n = Index(header.size);
+    result.components = Index(header.components);
+    result.validate(TrackMembers && (header.flags & DisjointSetsHeader::NEXT),
+                    track_sizes && (header.flags & DisjointSetsHeader::SIZES));
+    if ((TrackMembers && !(header.flags & DisjointSetsHeader::NEXT)) ||
+        (track_sizes && !(header.flags & DisjointSetsHeader::SIZES)))
+        result.rebuild_members();
+    return result;
+}
+
+/**
+ * 检查载入的数组是否构成合法的并查集.
+ * 父结点必须在范围内且不成环，根的数量等于连通分量数；
+ * 分量大小（sizes数组或LinkBySize的根结点）必须与实际相符；
+ * next数组必须是一个排列，且每个连通分量恰好构成一个环. O(n).
+ *
+ * @param has_next: 是否载入了next数组
+ *        has_sizes: 是否载入了sizes数组
+ * @throws std::invalid_argument: 数组内容不合法
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::validate(bool has_next, bool has_sizes) const
+{
+    const char* what = "DisjointSets::load() corrupt snapshot.";
+    // 非根结点的owner为其根，根结点的owner为-(分量大小+1)，n表示尚未确定
+    std::vector<Index> owner(n, n);
+    Index roots = 0;
+
+    for (Index i = 0; i < n; ++i)
+    {
+        if (parent[i] >= n)
+            throw std::invalid_argument(what);
+        if (parent[i] < 0)
+        {
+            owner[i] = -1;
+            roots++;
+        }
+    }
+    if (roots != components)
+        throw std::invalid_argument(what);
+    // 沿父结点走到根已确定的结点，再给路径上的结点填上根，每个结点只走过一次
+    for (Index i = 0; i < n; ++i)
+    {
+        Index p = i;
+        for (Index steps = 0; owner[p] == n; ++steps)
+        {
+            if (steps == n)
+                throw std::invalid_argument(what); // 路径长于n说明有环
+            p = parent[p];
+        }
+        Index r = owner[p] < 0 ? p : owner[p];
+        for (Index q = i; owner[q] == n; q = parent[q])
+            owner[q] = r;
+        owner[r]--;
+    }
+    for (Index r = 0; r < n; ++r)
+    {
+        if (parent[r] >= 0)
+            continue;
+        Index size = Index(-owner[r] - 1);
+        if ((has_sizes && sizes[r] != size) || (LinkPolicy::stores_size && -parent[r] != size))
+            throw std::invalid_argument(what);
+    }
+    if (!has_next)
+        return;
+    // next是排列且不跨越分量时，环数等于分量数即每个分量恰好一个环
+    std::vector<bool> seen(n, false);
+    for (Index i = 0; i < n; ++i)
+    {
+        if (next[i] < 0 || next[i] >= n || seen[next[i]] ||
+            (owner[next[i]] < 0 ? next[i] : owner[next[i]]) != (owner[i] < 0 ? i : owner[i]))
+            throw std::invalid_argument(what);
+        seen[next[i]] = true;
+    }
+    Index rings = 0;
+    std::fill(seen.begin(), seen.end(), false);
+    for (Index i = 0; i < n; ++i)
+    {
+        if (seen[i])
+            continue;
+        rings++;
+        for (Index q = i; !seen[q]; q = next[q])
+            seen[q] = true;
+    }
+    if (rings != components)
+        throw std::invalid_argument(what);
+}
+
+/**
+ * 根据parent数组重建成员环和分量大小.
+ * 每个触点插到其根之后，根的环逐个增长，查找时完全压缩路径，
+ * 即使快照来自不压缩路径的并查集也不会退化.
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::rebuild_members()
+{
+    for (Index i = 0; i < n; ++i)
+    {
+        if (TrackMembers) next[i] = i;
+        if (track_sizes) sizes[i] = 1;
+    }
+    for (Index i = 0; i < n; ++i)
+    {
+        Index root = CompressFull::find(parent, i);
+        if (root == i)
+            continue;
+        if (TrackMembers)
+        {
+            next[i] = next[root];
+            next[root] = i;
+        }
+        if (track_sizes)
+            sizes[root]++;
+    }
+}
+
+/**
+ * 追加一个单独的触点.
+ * 容量不足时翻倍，均摊时间为O(1)，翻倍会溢出时取Index的最大值.
+ *
+ * @return 新触点的下标
+ * @throws std::length_error: 触点数已达到Index的最大值
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+Index DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::make_set()
+{
+    const Index limit = std::numeric_limits<Index>::max();
+
+    if (n == capacity)
+    {
+        if (n == limit)
+            throw std::length_error("DisjointSets::make_set() too many sites.");
+        reserve(capacity < 8 ? 8 : capacity > limit / 2 ? limit : Index(capacity * 2));
+    }
+    parent[n] = -1;
+    if (TrackMembers) next[n] = n;
+    if (track_sizes) sizes[n] = 1;
+    components++;
+    return n++;
+}
+
+/**
+ * 预留至少size个触点的空间.
+ *
+ * @param size: 预留的触点数
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::reserve(Index size)
+{
+    if (size <= capacity)
+        return;
+    Index* array = new Index[size];
+    std::copy(parent, parent + n, array);
+    delete[] parent;
+    parent = array;
+    if (TrackMembers)
+    {
+        array = new Index[size];
+        std::copy(next, next + n, array);
+        delete[] next;
+        next = array;
+    }
+    if (track_sizes)
+    {
+        array = new Index[size];
+        std::copy(sizes, sizes + n, array);
+        delete[] sizes;
+        sizes = array;
+    }
+    capacity = size;
+}
+
+/**
+ * 交换当前DisjointSets对象和另一个DisjointSets对象.
+ *
+ * @param that: DisjointSets对象that
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::swap(DisjointSets& that)
+{
+    using std::swap;
+    swap(n, that.n);
+    swap(components, that.components);
+    swap(capacity, that.capacity);
+    swap(parent, that.parent);
+    swap(next, that.next);
+    swap(sizes, that.sizes);
+}
+
+/**
+ * =操作符重载.
+ *
+ * @param that: DisjointSets对象that
+ * @return 当前DisjointSets对象
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>&
+DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>::operator=(DisjointSets that)
+{
+    swap(that);
+    return *this;
+}
+
+/**
+ * 交换两个DisjointSets对象.
+ *
+ * @param lhs: DisjointSets对象lhs
+ *        rhs: DisjointSets对象rhs
+ */
+template<typename Index, typename LinkPolicy, typename CompressPolicy, bool TrackMembers>
+void swap(DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>& lhs,
+          DisjointSets<Index, LinkPolicy, CompressPolicy, TrackMembers>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace cpplib
@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * DynamicConnectivity.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.21
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "RollbackUnionFind.h"
+
+namespace cpplib
+{
+
+/**
+ * 离线动态连通性.
+ * 先记录加边、删边和查询的操作序列，solve()一次性回答所有查询.
+ * 每条边存在于一段连续的查询区间内，把区间挂到以查询序号为下标的线段树的O(log q)个结点上，
+ * 深度优先遍历线段树，进入结点时合并其上的边，离开时用RollbackUnionFind撤销，
+ * 到达叶结点时并查集恰好包含该查询时存在的边.
+ * 总时间为O(m log q log n)，m为加边次数，q为查询次数.
+ * 同一条边可以重复添加，每次删除对应最近一次尚未删除的添加.
+ */
+template<typename Index = int>
+class DynamicConnectivity
+{
+public:
+    // 成员类型定义
+    using index_type = Index;
+
+    explicit DynamicConnectivity(Index size);
+
+    // 返回触点数
+    Index size() const { return n; }
+    // 返回查询数
+    size_t queries() const { return asked.size(); }
+    // 添加边p-q
+    void add_edge(Index p, Index q);
+    // 删除边p-q
+    void remove_edge(Index p, Index q);
+    // 查询此时p与q是否连通，返回查询序号
+    size_t query_connected(Index p, Index q);
+    // 查询此时的连通分量数，返回查询序号
+    size_t query_count();
+    // 回答所有查询，连通查询的答案为1或0，连通分量数查询的答案为分量数
+    std::vector<Index> solve() const;
+private:
+    // 一次加边或删边
+    struct Event
+    {
+        Index p, q;   // 边的两端，p <= q
+        size_t time;  // 此前的查询数
+        bool add;     // 是否为加边
+    };
+
+    Index n;                                // 触点数
+    std::vector<Event> events;              // 加边和删边
+    std::vector<std::pair<Index, Index>> asked; // 查询，连通分量数查询的两端为-1
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < n; }
+    // 遍历线段树的结点node，其查询区间为[lo, hi)
+    void dfs(size_t node, size_t lo, size_t hi, const std::vector<size_t>& first,
+             const std::vector<std::pair<Index, Index>>& edges, RollbackUnionFind<Index>& uf,
+             std::vector<Index>& answers) const;
+};
+
+/**
+ * 构造函数.
+ *
+ * @param size: 触点数
+ */
+template<typename Index>
+DynamicConnectivity<Index>::DynamicConnectivity(Index size)
+    : n(size)
+{
+}
+
+/**
+ * 添加边p-q.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+void DynamicConnectivity<Index>::add_edge(Index p, Index q)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("DynamicConnectivity::add_edge() index out of range.");
+    events.push_back({ std::min(p, q), std::max(p, q), asked.size(), true });
+}
+
+/**
+ * 删除边p-q.
+ * 删除不存在的边在solve()时报告.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+void DynamicConnectivity<Index>::remove_edge(Index p, Index q)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("DynamicConnectivity::remove_edge() index out of range.");
+    events.push_back({ std::min(p, q), std::max(p, q), asked.size(), false });
+}
+
+/**
+ * 查询此时p与q是否连通.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @return 查询序号，即solve()结果中的下标
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+size_t DynamicConnectivity<Index>::query_connected(Index p, Index q)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("DynamicConnectivity::query_connected() index out of range.");
+    asked.emplace_back(p, q);
+    return asked.size() - 1;
+}
+
+/**
+ * 查询此时的连通分量数.
+ *
+ * @return 查询序号，即solve()结果中的下标
+ */
+template<typename Index>
+size_t DynamicConnectivity<Index>::query_count()
+{
+    asked.emplace_back(-1, -1);
+    return asked.size() - 1;
+}
+
+/**
+ * 回答所有查询.
+ * 按边和时间排序后配对加边与删除，得到每条边存在的查询区间[l, r)，
+ * 区间按自底向上的方式分解到线段树结点，结点上的边按计数排序连续存放.
+ *
+ * @return 按查询序号排列的答案
+ * @throws std::invalid_argument: 删除了不存在的边
+ */
+template<typename Index>
+std::vector<Index> DynamicConnectivity<Index>::solve() const
+{
+    size_t q = asked.size();
+    size_t leaves = 1;
+    while (leaves < q)
+        leaves *= 2;
+
+    // 同一条边的事件按时间相邻，用栈配对加边和删边
+    std::vector<Event> sorted(events);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Event& a, const Event& b)
+    {
+        return a.p != b.p ? a.p < b.p : a.q < b.q;
+    });
+    std::vector<std::pair<size_t, size_t>> spans; // 每条边存在的查询区间
+    std::vector<std::pair<Index, Index>> ends;    // 区间对应的边
+    std::vector<size_t> open;
+    for (size_t i = 0, j; i < sorted.size(); i = j)
+    {
+        open.clear();
+        for (j = i; j < sorted.size() && sorted[j].p == sorted[i].p && sorted[j].q == sorted[i].q; ++j)
+        {
+            if (sorted[j].add)
+                open.push_back(sorted[j].time);
+            else if (open.empty())
+                throw std::invalid_argument("DynamicConnectivity::solve() removing an absent edge.");
+            else
+            {
+                if (open.back() < sorted[j].time)
+                {
+                    spans.emplace_back(open.back(), sorted[j].time);
+                    ends.emplace_back(sorted[i].p, sorted[i].q);
+                }
+                open.pop_back();
+            }
+        }
+        for (size_t t : open)
+        {
+            if (t < q)
+            {
+                spans.emplace_back(t, q);
+                ends.emplace_back(sorted[i].p, sorted[i].q);
+            }
+        }
+    }
+
+    // 两趟把边分配到线段树结点：先计数，再按结点连续存放
+    std::vector<size_t> first(2 * leaves + 1, 0);
+    std::vector<std::pair<Index, Index>> edges;
+    auto place = [&](size_t node, size_t i, bool fill)
+    {
+        if (fill)
+            edges[first[node]++] = ends[i];
+        else
+            first[node + 1]++;
+    };
+    for (bool fill : { false, true })
+    {
+        if (fill)
+        {
+            for (size_t i = 1; i < first.size(); ++i)
+                first[i] += first[i - 1];
+            edges.resize(first.back());
+        }
+        for (size_t i = 0; i < spans.size(); ++i)
+        {
+            size_t l = spans[i].first + leaves, r = spans[i].second + leaves;
+            for (; l < r; l /= 2, r /= 2)
+            {
+                if (l & 1)
+                    place(l++, i, fill);
+                if (r & 1)
+                    place(--r, i, fill);
+            }
+        }
+    }
+    // 填充后first[i]为结点i的结束位置，整体后移一位得到起始位置
+    std::copy_backward(first.begin(), first.end() - 1, first.end());
+    first[0] = 0;
+
+    std::vector<Index> answers(q);
+    RollbackUnionFind<Index> uf(n);
+    if (q > 0)
+        dfs(1, 0, leaves, first, edges, uf, answers);
+    return answers;
+}
+
+/**
+ * 遍历线段树的结点.
+ * 合并结点上的边，到叶结点时回答查询，离开前撤销本结点的合并.
+ * 查询区间以外的子树没有边和查询，直接跳过.
+ *
+ * @param node: 结点编号，根为1
+ *        lo: 结点查询区间的起点
+ *        hi: 结点查询区间的终点
+ *        first: 结点i的边为edges[first[i]]到edges[first[i + 1] - 1]
+ *        edges: 按结点存放的边
+ *        uf: 可撤销的并查集
+ *        answers: 答案
+ */
+template<typename Index>
+void DynamicConnectivity<Index>::dfs(size_t node, size_t lo, size_t hi, const std::vector<size_t>& first,
+                                     const std::vector<std::pair<Index, Index>>& edges,
+                                     RollbackUnionFind<Index>& uf, std::vector<Index>& answers) const
+{
+    if (lo >= asked.size())
+        return;
+    size_t point = uf.checkpoint();
+    for (size_t i = first[node]; i < first[node + 1]; ++i)
+        uf.join(edges[i].first, edges[i].second);
+    if (hi - lo == 1)
+    {
+        const std::pair<Index, Index>& query = asked[lo];
+        answers[lo] = query.first < 0 ? uf.count() : Index(uf.connected(query.first, query.second));
+    }
+    else
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        dfs(2 * node, lo, mid, first, edges, uf, answers);
+        dfs(2 * node + 1, mid, hi, first, edges, uf, answers);
+    }
+    uf.rollback(point);
+}
+
+} // namespace cpplib
@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * Executor.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.9
+ ******************************************************************************/
+
+#pragma once
+#if __cplusplus < 202002L
+#error "Executor.h requires C++20 coroutines, configure with -DCPPLIB_BUILD_COROUTINE=ON"
+#endif
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "BlockingQueue.h"
+#include "Deque.h"
+
+namespace cpplib
+{
+
+class Executor;
+
+/**
+ * 交给执行器运行的协程.
+ * 协程创建后先挂起，由Executor::spawn启动，结束时自行销毁并通知执行器.
+ * 协程的参数要按值传递，引用参数在协程挂起后可能失效.
+ */
+class Task
+{
+public:
+    // 协程的promise，记录运行协程的执行器，Channel用它恢复挂起的协程
+    struct promise_type
+    {
+        Executor* executor = nullptr; // 运行协程的执行器
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept;
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Task(Task&& that) noexcept : handle(std::exchange(that.handle, nullptr)) {}
+    Task& operator=(Task that) noexcept { std::swap(handle, that.handle); return *this; }
+    ~Task() { if (handle) handle.destroy(); }
+private:
+    friend class Executor;
+
+    std::coroutine_handle<promise_type> handle; // 未启动的协程，启动后为空
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+};
+
+/**
+ * 执行器接口.
+ * schedule把可以继续运行的协程放入就绪队列，由执行器的线程恢复.
+ */
+class Executor
+{
+public:
+    virtual ~Executor() = default;
+
+    // 启动协程
+    void spawn(Task task)
+    {
+        auto h = std::exchange(task.handle, nullptr);
+        h.promise().executor = this;
+        started();
+        schedule(h);
+    }
+    // 把协程放入就绪队列
+    virtual void schedule(std::coroutine_handle<> h) = 0;
+    // 协程结束时调用
+    virtual void finished() {}
+protected:
+    // 协程启动时调用
+    virtual void started() {}
+};
+
+/**
+ * 协程结束时先取出执行器，再销毁协程帧，最后通知执行器.
+ *
+ * @return 结束时的等待体
+ */
+inline auto Task::promise_type::final_suspend() noexcept
+{
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> h) noexcept
+        {
+            Executor* executor = h.promise().executor;
+            h.destroy();
+            executor->finished();
+        }
+        void await_resume() noexcept {}
+    };
+    return FinalAwaiter();
+}
+
+/**
+ * 单线程执行器.
+ * 在调用run的线程中依次恢复就绪队列中的协程，就绪队列为空时run返回.
+ * 只能在调用run的线程中使用，适合不跨线程的协程服务.
+ */
+class SingleThreadExecutor : public Executor
+{
+public:
+    // 把协程放入就绪队列
+    void schedule(std::coroutine_handle<> h) override { ready.insert_back(h); }
+    // 运行协程直到没有就绪的协程，返回恢复的次数
+    size_t run();
+private:
+    Deque<std::coroutine_handle<>> ready; // 就绪队列
+};
+
+/**
+ * 运行协程直到没有就绪的协程.
+ * 此时所有协程都已结束，或者都在等待其它执行器或线程唤醒.
+ *
+ * @return 恢复协程的次数
+ */
+inline size_t SingleThreadExecutor::run()
+{
+    size_t count = 0;
+
+    while (!ready.empty())
+    {
+        auto h = ready.front();
+        ready.remove_front();
+        h.resume();
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * 多线程执行器.
+ * 固定数量的工作线程从共享的BlockingQueue取出就绪的协程并恢复，
+ * 协程被唤醒后可能在另一个工作线程上继续运行.
+ * wait等待所有启动的协程结束，析构时关闭就绪队列并等待工作线程退出.
+ */
+class ThreadPoolExecutor : public Executor
+{
+public:
+    explicit ThreadPoolExecutor(int threads = std::thread::hardware_concurrency());
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+    ~ThreadPoolExecutor();
+
+    // 把协程放入就绪队列
+    void schedule(std::coroutine_handle<> h) override { ready.enqueue(h); }
+    // 协程结束时减少计数，全部结束时唤醒wait
+    void finished() override;
+    // 等待所有启动的协程结束
+    void wait();
+private:
+    BlockingQueue<std::coroutine_handle<>> ready; // 就绪队列
+    std::vector<std::thread> workers; // 工作线程
+    std::mutex m; // 保护未结束的协程数量
+    std::condition_variable all_done; // 所有协程结束
+    size_t active; // 未结束的协程数量
+
+    // 协程启动时增加计数
+    void started() override;
+};
+
+/**
+ * 构造函数，启动工作线程.
+ * 就绪队列的容量不限制协程数量，只在所有工作线程都忙时缓冲.
+ *
+ * @param threads: 工作线程数量，至少为1
+ */
+inline ThreadPoolExecutor::ThreadPoolExecutor(int threads)
+    : ready(size_t(-1) / 2), active(0)
+{
+    for (int i = 0; i < std::max(threads, 1); ++i)
+    {
+        workers.emplace_back([this]
+        {
+            std::coroutine_handle<> h;
+            while (ready.dequeue(h))
+                h.resume();
+        });
+    }
+}
+
+/**
+ * 析构函数.
+ * 关闭就绪队列，工作线程运行完已就绪的协程后退出.
+ */
+inline ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+    ready.close();
+    for (auto& t : workers)
+        t.join();
+}
+
+/**
+ * 协程启动时增加计数.
+ */
+inline void ThreadPoolExecutor::started()
+{
+    std::lock_guard<std::mutex> lock(m);
+    ++active;
+}
+
+/**
+ * 协程结束时减少计数，全部结束时唤醒wait.
+ */
+inline void ThreadPoolExecutor::finished()
+{
+    std::lock_guard<std::mutex> lock(m);
+    if (--active == 0)
+        all_done.notify_all();
+}
+
+/**
+ * 等待所有启动的协程结束.
+ * 如果有协程永远等待在Channel上，wait不会返回.
+ */
+inline void ThreadPoolExecutor::wait()
+{
+    std::unique_lock<std::mutex> lock(m);
+    all_done.wait(lock, [this] { return active == 0; });
+}
+
+} // namespace cpplib
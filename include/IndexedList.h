@@ -0,0 +1,628 @@
+/*******************************************************************************
+ * IndexedList.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.12
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace cpplib
+{
+
+/**
+ * 使用带跨度的跳表实现的索引链表.
+ * 接口与List相同，另外支持按位置访问、添加和移除元素.
+ * 每个结点的每一层链接记录跨越的底层结点数（跨度），
+ * 按位置查找时沿跨度累加，期望复杂度为O(log n).
+ * 所有层都首尾相接到头结点，头结点同时作为尾后位置.
+ * 实现了索引链表的双向迭代器.
+ */
+template<typename E>
+class IndexedList
+{
+    static constexpr int MAX_LEVEL = 32; // 跳表的最大层数
+
+    struct Node;
+    // 一层链接，width为从当前结点到next跨越的底层结点数
+    struct Link
+    {
+        Node* next;
+        int width;
+    };
+    // 链接数组紧跟在结点之后，与结点一起分配
+    struct Node
+    {
+        E elem;
+        Node* prev;
+        int height;
+        Node() : elem(), prev(this), height(MAX_LEVEL) {}
+        Node(E elem, int height) : elem(std::move(elem)), prev(nullptr), height(height) {}
+
+        Link* links() { return reinterpret_cast<Link*>(this + 1); }
+    };
+    static_assert(alignof(Link) <= alignof(Node), "Link must fit after Node");
+public:
+    IndexedList();
+    IndexedList(const IndexedList& that);
+    IndexedList(IndexedList&& that) noexcept;
+    ~IndexedList();
+
+    class iterator;
+
+    // 返回链表元素的数量
+    int size() const { return n; }
+    // 判断是否为空链表
+    bool empty() const { return n == 0; }
+    // 返回指定位置元素的引用，带边界检查，O(log n)
+    E& at(int i) { return const_cast<E&>(static_cast<const IndexedList&>(*this).at(i)); }
+    // 返回指定位置元素的const引用，带边界检查，O(log n)
+    const E& at(int i) const;
+    // 添加元素到指定位置，O(log n)
+    void insert_at(int i, E elem);
+    // 移除指定位置的元素，O(log n)
+    void erase_at(int i);
+    // 返回迭代器指向元素的位置，尾后迭代器返回size()，O(log n)
+    int rank(iterator pos) const;
+    // 添加元素到迭代器指定位置
+    void insert(iterator pos, E elem) { insert_at(rank(pos), std::move(elem)); }
+    // 添加元素到链表头部
+    void insert_front(E elem) { insert_at(0, std::move(elem)); }
+    // 添加元素到链表尾部
+    void insert_back(E elem) { insert_at(n, std::move(elem)); }
+    // 移除迭代器指定位置的元素
+    void remove(iterator pos);
+    // 移除链表头部元素
+    void remove_front();
+    // 移除链表尾部元素
+    void remove_back();
+    // 返回链表头部元素的引用
+    E& front() { return const_cast<E&>(static_cast<const IndexedList&>(*this).front()); }
+    // 返回链表头部元素的const引用
+    const E& front() const;
+    // 返回链表尾部元素的引用
+    E& back() { return const_cast<E&>(static_cast<const IndexedList&>(*this).back()); }
+    // 返回链表尾部元素的const引用
+    const E& back() const;
+    // 内容与另一个IndexedList对象交换
+    void swap(IndexedList& that);
+    // 清空链表
+    void clear();
+
+    IndexedList& operator=(IndexedList that);
+    IndexedList& operator+=(const IndexedList& that);
+
+    class iterator : public std::iterator<std::bidirectional_iterator_tag, E>
+    {
+        friend class IndexedList;
+    private:
+        Node* pn;
+    public:
+        iterator() : pn(nullptr) {}
+        iterator(Node* x) : pn(x) {}
+
+        E& operator*() const
+        { return pn->elem; }
+        E* operator->() const
+        { return &pn->elem; }
+        iterator& operator++()
+        {
+            pn = pn->links()[0].next;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        iterator& operator--()
+        {
+            pn = pn->prev;
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator tmp(*this);
+            --*this;
+            return tmp;
+        }
+        bool operator==(const iterator& that) const
+        { return pn == that.pn; }
+        bool operator!=(const iterator& that) const
+        { return pn != that.pn; }
+    };
+    iterator begin() const { return iterator(head->links()[0].next); }
+    iterator end() const { return iterator(head); }
+private:
+    int n;            // 链表大小
+    int level;        // 当前使用的层数
+    Node* head;       // 头结点，同时作为尾后位置
+    uint32_t seed;    // 生成结点层数的随机数状态
+
+    // 分配并构造一个指定层数的结点
+    static Node* create_node(E elem, int height);
+    // 析构并释放结点
+    static void destroy_node(Node* x);
+    // 生成新结点的随机层数，第k层出现的概率为1/2^k
+    int random_height();
+    // 查找位置i之前的结点，记录每一层的前驱及其位置
+    void find_prev(int i, Node** update, int* pos) const;
+    // 检查索引是否合法
+    bool valid(int i) const { return i >= 0 && i < n; }
+};
+
+/**
+ * 索引链表构造函数.
+ */
+template<typename E>
+IndexedList<E>::IndexedList() : n(0), level(1), seed(2463534242u)
+{
+    void* raw = ::operator new(sizeof(Node) + MAX_LEVEL * sizeof(Link));
+    head = ::new (raw) Node();
+    head->links()[0] = Link{head, 1};
+}
+
+/**
+ * 索引链表复制构造函数.
+ * 复制另一个索引链表作为这个链表的初始化.
+ *
+ * @param that: 被复制的索引链表
+ */
+template<typename E>
+IndexedList<E>::IndexedList(const IndexedList& that) : IndexedList()
+{
+    for (auto& i : that)
+        insert_back(i);
+}
+
+/**
+ * 索引链表移动构造函数.
+ * 移动另一个索引链表，其资源所有权转移到新创建的对象.
+ *
+ * @param that: 被移动的索引链表
+ */
+template<typename E>
+IndexedList<E>::IndexedList(IndexedList&& that) noexcept
+{
+    n = that.n;
+    level = that.level;
+    head = that.head;
+    seed = that.seed;
+    that.n = 0;
+    that.head = nullptr; // 指向空指针，退出被析构
+}
+
+/**
+ * 索引链表析构函数.
+ */
+template<typename E>
+IndexedList<E>::~IndexedList()
+{
+    if (head == nullptr) return;
+    clear();
+    destroy_node(head);
+    head = nullptr;
+}
+
+/**
+ * 返回指定位置元素的const引用，并进行越界检查.
+ *
+ * @param i: 元素的位置
+ * @return 指定位置元素的const引用
+ * @throws std::out_of_range: 索引不合法
+ */
+template<typename E>
+const E& IndexedList<E>::at(int i) const
+{
+    if (!valid(i))
+        throw std::out_of_range("IndexedList::at");
+
+    Node* x = head;
+    int pos = 0; // 头结点位于0，第i个元素位于i + 1
+
+    for (int l = level - 1; l >= 0; --l)
+    {
+        while (x->links()[l].next != head && pos + x->links()[l].width <= i + 1)
+        {
+            pos += x->links()[l].width;
+            x = x->links()[l].next;
+        }
+        if (pos == i + 1) break;
+    }
+    return x->elem;
+}
+
+/**
+ * 添加元素到指定位置.
+ *
+ * @param i: 添加后元素所在的位置
+ *        elem: 要添加的元素
+ * @throws std::out_of_range: 索引不合法
+ */
+template<typename E>
+void IndexedList<E>::insert_at(int i, E elem)
+{
+    if (i < 0 || i > n)
+        throw std::out_of_range("IndexedList::insert_at");
+
+    Node* update[MAX_LEVEL];
+    int pos[MAX_LEVEL];
+    int height = random_height();
+    Node* x = create_node(std::move(elem), height);
+
+    // 新增的层由头结点直接链接到自身，跨度为整个链表
+    for (; level < height; ++level)
+        head->links()[level] = Link{head, n + 1};
+    find_prev(i, update, pos);
+    // 新结点位于i + 1，拆分前驱在每一层的跨度
+    for (int l = 0; l < height; ++l)
+    {
+        Link& link = update[l]->links()[l];
+        x->links()[l] = Link{link.next, pos[l] + link.width - i};
+        link = Link{x, i + 1 - pos[l]};
+    }
+    // 更高层的链接跨过了新结点
+    for (int l = height; l < level; ++l)
+        update[l]->links()[l].width++;
+    x->prev = update[0];
+    x->links()[0].next->prev = x;
+    n++;
+}
+
+/**
+ * 移除指定位置的元素.
+ *
+ * @param i: 要移除元素的位置
+ * @throws std::out_of_range: 索引不合法
+ */
+template<typename E>
+void IndexedList<E>::erase_at(int i)
+{
+    if (!valid(i))
+        throw std::out_of_range("IndexedList::erase_at");
+
+    Node* update[MAX_LEVEL];
+    int pos[MAX_LEVEL];
+
+    find_prev(i, update, pos);
+    Node* x = update[0]->links()[0].next;
+    // 前驱在每一层合并被移除结点的跨度
+    for (int l = 0; l < x->height; ++l)
+    {
+        Link& link = update[l]->links()[l];
+        link = Link{x->links()[l].next, link.width + x->links()[l].width - 1};
+    }
+    for (int l = x->height; l < level; ++l)
+        update[l]->links()[l].width--;
+    x->links()[0].next->prev = update[0];
+    destroy_node(x);
+    n--;
+    // 降低不再使用的层
+    while (level > 1 && head->links()[level - 1].next == head)
+        level--;
+}
+
+/**
+ * 返回迭代器指向元素的位置.
+ * 从该结点出发，每次沿所在结点的最高层前进直到头结点，
+ * 累加的跨度即为该结点到尾后位置的距离.
+ *
+ * @param pos: 指向元素的迭代器
+ * @return 元素的位置，尾后迭代器返回size()
+ */
+template<typename E>
+int IndexedList<E>::rank(iterator pos) const
+{
+    Node* x = pos.pn;
+    int distance = 0;
+
+    while (x != head)
+    {
+        Link& link = x->links()[x->height - 1];
+        distance += link.width;
+        x = link.next;
+    }
+    // 结点位于n + 1 - distance，其索引比位置小1
+    return n - distance;
+}
+
+/**
+ * 移除迭代器指定位置的元素.
+ *
+ * @param pos: 指向要移除元素的迭代器
+ * @throws std::out_of_range: pos为尾后迭代器
+ */
+template<typename E>
+void IndexedList<E>::remove(iterator pos)
+{
+    if (pos.pn == head)
+        throw std::out_of_range("IndexedList::remove");
+    erase_at(rank(pos));
+}
+
+/**
+ * 移除链表头部元素.
+ *
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E>
+void IndexedList<E>::remove_front()
+{
+    if (empty())
+        throw std::out_of_range("IndexedList::remove_front");
+    erase_at(0);
+}
+
+/**
+ * 移除链表尾部元素.
+ *
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E>
+void IndexedList<E>::remove_back()
+{
+    if (empty())
+        throw std::out_of_range("IndexedList::remove_back");
+    erase_at(n - 1);
+}
+
+/**
+ * 返回链表头部元素的const引用.
+ *
+ * @return 链表头部元素的const引用
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E>
+const E& IndexedList<E>::front() const
+{
+    if (empty())
+        throw std::out_of_range("IndexedList::front");
+    return *begin();
+}
+
+/**
+ * 返回链表尾部元素的const引用.
+ *
+ * @return 链表尾部元素的const引用
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E>
+const E& IndexedList<E>::back() const
+{
+    if (empty())
+        throw std::out_of_range("IndexedList::back");
+    return *std::prev(end());
+}
+
+/**
+ * 交换当前IndexedList对象和另一个IndexedList对象.
+ *
+ * @param that: IndexedList对象that
+ */
+template<typename E>
+void IndexedList<E>::swap(IndexedList& that)
+{
+    using std::swap;
+    swap(n, that.n);
+    swap(level, that.level);
+    swap(head, that.head);
+    swap(seed, that.seed);
+}
+
+/**
+ * 清空该链表元素.
+ */
+template<typename E>
+void IndexedList<E>::clear()
+{
+    Node* current = head->links()[0].next;
+    // 释放每个结点内存
+    while (current != head)
+    {
+        Node* next = current->links()[0].next;
+        destroy_node(current);
+        current = next;
+    }
+    n = 0;
+    level = 1;
+    head->prev = head;
+    head->links()[0] = Link{head, 1};
+}
+
+/**
+ * =操作符重载.
+ * 让当前IndexedList对象等于给定IndexedList对象that.
+ *
+ * @param that: IndexedList对象that
+ * @return 当前IndexedList对象
+ */
+template<typename E>
+IndexedList<E>& IndexedList<E>::operator=(IndexedList that)
+{
+    swap(that);
+    return *this;
+}
+
+/**
+ * +=操作符重载.
+ * 复制另一个对象所有元素,添加到当前对象.
+ *
+ * @param that: IndexedList对象that
+ * @return 当前IndexedList对象
+ */
+template<typename E>
+IndexedList<E>& IndexedList<E>::operator+=(const IndexedList& that)
+{
+    int count = that.n; // that可能就是*this，只复制原有的元素
+    auto it = that.begin();
+
+    while (count-- > 0)
+        insert_back(*it++);
+    return *this;
+}
+
+/**
+ * 分配并构造一个指定层数的结点，链接数组与结点一起分配.
+ *
+ * @param elem: 结点元素
+ *        height: 结点层数
+ * @return 新结点
+ */
+template<typename E>
+typename IndexedList<E>::Node* IndexedList<E>::create_node(E elem, int height)
+{
+    void* raw = ::operator new(sizeof(Node) + height * sizeof(Link));
+
+    try
+    {
+        return ::new (raw) Node(std::move(elem), height);
+    }
+    catch (...)
+    {
+        ::operator delete(raw);
+        throw;
+    }
+}
+
+/**
+ * 析构并释放结点.
+ *
+ * @param x: 要释放的结点
+ */
+template<typename E>
+void IndexedList<E>::destroy_node(Node* x)
+{
+    x->~Node();
+    ::operator delete(x);
+}
+
+/**
+ * 生成新结点的随机层数.
+ * 使用xorshift生成随机位，第k层出现的概率为1/2^k.
+ *
+ * @return 新结点的层数
+ */
+template<typename E>
+int IndexedList<E>::random_height()
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    int height = 1;
+    uint32_t bits = seed;
+    while ((bits & 1) && height < MAX_LEVEL)
+    {
+        height++;
+        bits >>= 1;
+    }
+    return height;
+}
+
+/**
+ * 查找位置i之前的结点.
+ * update[l]为第l层中位于i + 1之前的最后一个结点，pos[l]为其位置.
+ *
+ * @param i: 元素的索引
+ *        update: 每一层的前驱结点
+ *        pos: 每一层前驱结点的位置
+ */
+template<typename E>
+void IndexedList<E>::find_prev(int i, Node** update, int* pos) const
+{
+    Node* x = head;
+    int p = 0;
+
+    for (int l = level - 1; l >= 0; --l)
+    {
+        while (x->links()[l].next != head && p + x->links()[l].width <= i)
+        {
+            p += x->links()[l].width;
+            x = x->links()[l].next;
+        }
+        update[l] = x;
+        pos[l] = p;
+    }
+}
+
+/**
+ * +操作符重载.
+ * 返回一个包含lhs和rhs所有元素的对象.
+ *
+ * @param lhs: IndexedList对象lhs
+ *        rhs: IndexedList对象rhs
+ * @return 包含lhs和rhs所有元素的IndexedList对象
+ */
+template<typename E>
+IndexedList<E> operator+(IndexedList<E> lhs, const IndexedList<E>& rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+/**
+ * ==操作符重载函数，比较两个IndexedList对象是否相等.
+ *
+ * @param lhs: IndexedList对象lhs
+ *        rhs: IndexedList对象rhs
+ * @return true: 相等
+ *         false: 不等
+ */
+template<typename E>
+bool operator==(const IndexedList<E>& lhs, const IndexedList<E>& rhs)
+{
+    if (&lhs == &rhs)             return true;
+    if (lhs.size() != rhs.size()) return false;
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+/**
+ * !=操作符重载函数，比较两个IndexedList对象是否不等.
+ *
+ * @param lhs: IndexedList对象lhs
+ *        rhs: IndexedList对象rhs
+ * @return true: 不等
+ *         false: 相等
+ */
+template<typename E>
+bool operator!=(const IndexedList<E>& lhs, const IndexedList<E>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+/**
+ * <<操作符重载函数，打印所有链表元素.
+ *
+ * @param os: 输出流对象
+ *        list: 要输出的链表
+ * @return 输出流对象
+ */
+template<typename E>
+std::ostream& operator<<(std::ostream& os, const IndexedList<E>& list)
+{
+    for (auto& i : list)
+        os << i << " ";
+    return os;
+}
+
+/**
+ * 交换两个IndexedList对象.
+ *
+ * @param lhs: IndexedList对象lhs
+ *        rhs: IndexedList对象rhs
+ */
+template<typename E>
+void swap(IndexedList<E>& lhs, IndexedList<E>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace cpplib
@@ -0,0 +1,373 @@
+/*******************************************************************************
+ * IntrusiveList.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.8
+ ******************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace cpplib
+{
+
+template<typename T, typename Hook, Hook T::*Member>
+class BasicIntrusiveList;
+
+/**
+ * 侵入式链表的链接钩子.
+ * 作为成员嵌入到对象中，由链表通过钩子链接对象，链表本身不分配结点.
+ * 一个对象可以包含多个钩子，从而同时位于多个链表中.
+ * 安全模式（Safe为true）下钩子记录自身是否已链接，
+ * 对象析构时自动从所在链表断开，重复链接会抛出异常，重复断开被忽略.
+ */
+template<bool Safe>
+class BasicListHook
+{
+    template<typename T, typename Hook, Hook T::*Member>
+    friend class BasicIntrusiveList;
+public:
+    static constexpr bool safe = Safe; // 是否为安全模式
+
+    BasicListHook() : prev(nullptr), next(nullptr) {}
+    // 钩子的链接关系不随对象复制，复制得到的钩子未链接
+    BasicListHook(const BasicListHook&) : BasicListHook() {}
+    BasicListHook& operator=(const BasicListHook&) { return *this; }
+    ~BasicListHook() { if (Safe && is_linked()) unlink(); }
+
+    // 判断钩子是否已链接到链表，非安全模式下的结果仅在链接前有效
+    bool is_linked() const { return next != nullptr; }
+    // 从所在链表断开，O(1)，安全模式下未链接的钩子不做任何操作
+    void unlink()
+    {
+        if (Safe && !is_linked())
+            return;
+        prev->next = next;
+        next->prev = prev;
+        if (Safe) prev = next = nullptr;
+    }
+private:
+    BasicListHook* prev;
+    BasicListHook* next;
+
+    // 链接到结点succ之前
+    void link_before(BasicListHook* succ)
+    {
+        if (Safe && is_linked())
+            throw std::invalid_argument("ListHook::link_before already linked");
+        prev = succ->prev;
+        next = succ;
+        prev->next = this;
+        succ->prev = this;
+    }
+};
+
+// 析构时自动断开的安全钩子
+using ListHook = BasicListHook<true>;
+// 不做链接检查的钩子，对象必须在析构前从链表移除
+using UnsafeListHook = BasicListHook<false>;
+
+/**
+ * 使用模板实现的侵入式链表.
+ * 通过对象的钩子成员Member链接对象，添加和移除元素都不分配内存.
+ * 链表不拥有元素，元素的生命周期由调用者管理.
+ * 安全模式的元素可以在任何时候析构或直接断开，因此链表不记录大小，
+ * size()需要遍历链表.
+ * 实现了链表的双向迭代器.
+ */
+template<typename T, typename Hook, Hook T::*Member>
+class BasicIntrusiveList
+{
+public:
+    using value_type = T;
+    using hook_type  = Hook;
+
+    BasicIntrusiveList() { sentinel.prev = sentinel.next = &sentinel; }
+    BasicIntrusiveList(const BasicIntrusiveList&) = delete;
+    BasicIntrusiveList(BasicIntrusiveList&& that) noexcept;
+    ~BasicIntrusiveList();
+    BasicIntrusiveList& operator=(const BasicIntrusiveList&) = delete;
+
+    class iterator;
+
+    // 返回链表元素的数量，O(n)
+    int size() const;
+    // 判断是否为空链表
+    bool empty() const { return sentinel.next == &sentinel; }
+    // 添加元素到指定位置
+    void insert(iterator pos, T& elem) { (elem.*Member).link_before(pos.ph); }
+    // 添加元素到链表头部
+    void insert_front(T& elem) { (elem.*Member).link_before(sentinel.next); }
+    // 添加元素到链表尾部
+    void insert_back(T& elem) { (elem.*Member).link_before(&sentinel); }
+    // 移除指定位置的元素，返回指向后继元素的迭代器
+    iterator remove(iterator pos);
+    // 移除链表头部元素
+    void remove_front();
+    // 移除链表尾部元素
+    void remove_back();
+    // 从所在链表断开指定元素，不需要知道链表对象
+    static void unlink(T& elem) { (elem.*Member).unlink(); }
+    // 返回链表头部元素的引用
+    T& front() const;
+    // 返回链表尾部元素的引用
+    T& back() const;
+    // 返回指向指定元素的迭代器，O(1)
+    static iterator iterator_to(T& elem) { return iterator(&(elem.*Member)); }
+    // 内容与另一个BasicIntrusiveList对象交换
+    void swap(BasicIntrusiveList& that);
+    // 清空链表，元素不被析构
+    void clear();
+
+    class iterator : public std::iterator<std::bidirectional_iterator_tag, T>
+    {
+        friend class BasicIntrusiveList;
+    private:
+        Hook* ph;
+    public:
+        iterator() : ph(nullptr) {}
+        explicit iterator(Hook* x) : ph(x) {}
+
+        T& operator*() const
+        { return *owner(ph); }
+        T* operator->() const
+        { return owner(ph); }
+        iterator& operator++()
+        {
+            ph = ph->next;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        iterator& operator--()
+        {
+            ph = ph->prev;
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator tmp(*this);
+            --*this;
+            return tmp;
+        }
+        bool operator==(const iterator& that) const
+        { return ph == that.ph; }
+        bool operator!=(const iterator& that) const
+        { return ph != that.ph; }
+    };
+    iterator begin() const { return iterator(sentinel.next); }
+    iterator end() const { return iterator(const_cast<Hook*>(&sentinel)); }
+private:
+    Hook sentinel; // 哨兵钩子，不属于任何对象
+
+    // 由钩子地址得到所属对象的地址
+    static T* owner(Hook* h);
+    // 将that的所有元素转移到当前空链表
+    void take(BasicIntrusiveList& that);
+};
+
+// 使用安全钩子ListHook的侵入式链表
+template<typename T, ListHook T::*Member>
+using IntrusiveList = BasicIntrusiveList<T, ListHook, Member>;
+// 使用UnsafeListHook的侵入式链表
+template<typename T, UnsafeListHook T::*Member>
+using UnsafeIntrusiveList = BasicIntrusiveList<T, UnsafeListHook, Member>;
+
+/**
+ * 侵入式链表移动构造函数.
+ * 移动另一个链表的所有元素到新创建的对象，元素本身不移动.
+ *
+ * @param that: 被移动的链表
+ */
+template<typename T, typename Hook, Hook T::*Member>
+BasicIntrusiveList<T, Hook, Member>::BasicIntrusiveList(BasicIntrusiveList&& that) noexcept
+{
+    sentinel.prev = sentinel.next = &sentinel;
+    take(that);
+}
+
+/**
+ * 侵入式链表析构函数.
+ * 断开所有元素，元素本身不被析构.
+ */
+template<typename T, typename Hook, Hook T::*Member>
+BasicIntrusiveList<T, Hook, Member>::~BasicIntrusiveList()
+{
+    clear();
+    sentinel.prev = sentinel.next = nullptr;
+}
+
+/**
+ * 返回链表元素的数量.
+ *
+ * @return 链表元素的数量
+ */
+template<typename T, typename Hook, Hook T::*Member>
+int BasicIntrusiveList<T, Hook, Member>::size() const
+{
+    int count = 0;
+
+    for (const Hook* h = sentinel.next; h != &sentinel; h = h->next)
+        count++;
+    return count;
+}
+
+/**
+ * 移除链表中指定位置的元素.
+ *
+ * @param pos: 指向要移除元素的迭代器
+ * @return 指向被移除元素后继的迭代器
+ * @throws std::out_of_range: pos指向链表尾部
+ */
+template<typename T, typename Hook, Hook T::*Member>
+typename BasicIntrusiveList<T, Hook, Member>::iterator
+BasicIntrusiveList<T, Hook, Member>::remove(iterator pos)
+{
+    if (pos.ph == &sentinel)
+        throw std::out_of_range("IntrusiveList::remove");
+
+    Hook* succ = pos.ph->next;
+    pos.ph->unlink();
+    return iterator(succ);
+}
+
+/**
+ * 移除链表头部元素.
+ *
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename T, typename Hook, Hook T::*Member>
+void BasicIntrusiveList<T, Hook, Member>::remove_front()
+{
+    if (empty())
+        throw std::out_of_range("IntrusiveList::remove_front");
+    sentinel.next->unlink();
+}
+
+/**
+ * 移除链表尾部元素.
+ *
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename T, typename Hook, Hook T::*Member>
+void BasicIntrusiveList<T, Hook, Member>::remove_back()
+{
+    if (empty())
+        throw std::out_of_range("IntrusiveList::remove_back");
+    sentinel.prev->unlink();
+}
+
+/**
+ * 返回链表头部元素的引用.
+ *
+ * @return 链表头部元素的引用
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename T, typename Hook, Hook T::*Member>
+T& BasicIntrusiveList<T, Hook, Member>::front() const
+{
+    if (empty())
+        throw std::out_of_range("IntrusiveList::front");
+    return *begin();
+}
+
+/**
+ * 返回链表尾部元素的引用.
+ *
+ * @return 链表尾部元素的引用
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename T, typename Hook, Hook T::*Member>
+T& BasicIntrusiveList<T, Hook, Member>::back() const
+{
+    if (empty())
+        throw std::out_of_range("IntrusiveList::back");
+    return *std::prev(end());
+}
+
+/**
+ * 交换当前BasicIntrusiveList对象和另一个BasicIntrusiveList对象.
+ * 哨兵钩子嵌入在链表对象中，需要修正首尾元素指向哨兵的指针.
+ *
+ * @param that: BasicIntrusiveList对象that
+ */
+template<typename T, typename Hook, Hook T::*Member>
+void BasicIntrusiveList<T, Hook, Member>::swap(BasicIntrusiveList& that)
+{
+    if (&that == this) return;
+
+    BasicIntrusiveList tmp(std::move(that));
+    that.take(*this);
+    take(tmp);
+}
+
+/**
+ * 清空链表.
+ * 安全模式下逐个重置元素钩子，非安全模式下只重置哨兵.
+ */
+template<typename T, typename Hook, Hook T::*Member>
+void BasicIntrusiveList<T, Hook, Member>::clear()
+{
+    if (Hook::safe)
+    {
+        while (!empty())
+            sentinel.next->unlink();
+    }
+    else
+        sentinel.prev = sentinel.next = &sentinel;
+}
+
+/**
+ * 由钩子地址得到所属对象的地址.
+ * 钩子在对象中的偏移由成员指针在一个对齐的伪地址上计算得到，
+ * 计算过程不访问该地址.
+ *
+ * @param h: 对象中的钩子
+ * @return 钩子所属的对象
+ */
+template<typename T, typename Hook, Hook T::*Member>
+T* BasicIntrusiveList<T, Hook, Member>::owner(Hook* h)
+{
+    const std::uintptr_t base = alignof(T) * 64;
+    const std::ptrdiff_t offset =
+            reinterpret_cast<std::uintptr_t>(&(reinterpret_cast<T*>(base)->*Member)) - base;
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset);
+}
+
+/**
+ * 将that的所有元素转移到当前空链表.
+ *
+ * @param that: 被转移的链表，转移后为空
+ */
+template<typename T, typename Hook, Hook T::*Member>
+void BasicIntrusiveList<T, Hook, Member>::take(BasicIntrusiveList& that)
+{
+    if (that.empty()) return;
+    sentinel.next = that.sentinel.next;
+    sentinel.prev = that.sentinel.prev;
+    sentinel.next->prev = &sentinel;
+    sentinel.prev->next = &sentinel;
+    that.sentinel.prev = that.sentinel.next = &that.sentinel;
+}
+
+/**
+ * 交换两个BasicIntrusiveList对象.
+ *
+ * @param lhs: BasicIntrusiveList对象lhs
+ *        rhs: BasicIntrusiveList对象rhs
+ */
+template<typename T, typename Hook, Hook T::*Member>
+void swap(BasicIntrusiveList<T, Hook, Member>& lhs, BasicIntrusiveList<T, Hook, Member>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace cpplib
@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * KeyedDisjointSets.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.19
+ ******************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * 以任意可哈希的键为触点的并查集.
+ * 第一次出现的键通过make_set()分配连续的下标，键到下标的映射是开放寻址的哈希表，
+ * 线性探测，表中只保存下标，键按下标保存在数组中，负载因子不超过1/2.
+ * 哈希值再经过一次混合，64位整数的std::hash是恒等映射也能均匀分布.
+ */
+template<typename Key, typename Hash = std::hash<Key>, typename Sets = DisjointSets<>>
+class KeyedDisjointSets
+{
+public:
+    // 成员类型定义
+    using key_type = Key;
+    using index_type = typename Sets::index_type;
+    using sets_type = Sets;
+
+    explicit KeyedDisjointSets(index_type size = 0, const Hash& hash = Hash());
+
+    // 返回键的数量
+    index_type size() const { return index_type(keys.size()); }
+    // 返回连通分量数
+    index_type count() const { return sets.count(); }
+    // 判断键是否出现过
+    bool contains(const Key& key) const { return lookup(key) >= 0; }
+    // 返回键的下标，不存在时返回-1
+    index_type lookup(const Key& key) const;
+    // 返回键的下标，不存在时添加为单独的连通分量
+    index_type index(const Key& key);
+    // 返回下标对应的键
+    const Key& key(index_type p) const { return keys.at(p); }
+    // 找到键所属连通分量的根触点的键，不存在时添加
+    const Key& find(const Key& key) { return keys[sets.find(index(key))]; }
+    // 判断两个键是否属于同一个连通分量，没出现过的键自成一个连通分量
+    bool connected(const Key& p, const Key& q);
+    // 合并两个键所属的连通分量，没出现过的键先添加，返回是否合并了两个不同的分量
+    bool join(const Key& p, const Key& q);
+    // 预留至少size个键的空间
+    void reserve(index_type size);
+    // 返回下标上的并查集
+    Sets& disjoint_sets() { return sets; }
+private:
+    Sets sets;                       // 下标上的并查集
+    std::vector<Key> keys;           // 下标到键
+    std::vector<index_type> table;   // 开放寻址的哈希表，保存下标，-1为空
+    size_t mask;                     // 哈希表大小减一
+    Hash hasher;                     // 哈希函数
+
+    // 键的混合哈希值
+    size_t slot(const Key& key) const { return LinkByRandomIndex::priority(hasher(key)) & mask; }
+    // 哈希表扩容到buckets个桶并重新插入所有下标
+    void rehash(size_t buckets);
+};
+
+/**
+ * 构造函数.
+ *
+ * @param size: 预留的键数
+ *        hash: 哈希函数
+ */
+template<typename Key, typename Hash, typename Sets>
+KeyedDisjointSets<Key, Hash, Sets>::KeyedDisjointSets(index_type size, const Hash& hash)
+    : mask(0), hasher(hash)
+{
+    rehash(16);
+    reserve(size);
+}
+
+/**
+ * 返回键的下标.
+ *
+ * @param key: 键
+ * @return 键的下标，不存在时返回-1
+ */
+template<typename Key, typename Hash, typename Sets>
+typename KeyedDisjointSets<Key, Hash, Sets>::index_type
+KeyedDisjointSets<Key, Hash, Sets>::lookup(const Key& key) const
+{
+    for (size_t i = slot(key); table[i] >= 0; i = (i + 1) & mask)
+        if (keys[table[i]] == key)
+            return table[i];
+    return -1;
+}
+
+/**
+ * 返回键的下标，不存在时添加.
+ * 新的键由make_set()分配下标，插入后负载因子超过1/2时哈希表翻倍.
+ *
+ * @param key: 键
+ * @return 键的下标
+ */
+template<typename Key, typename Hash, typename Sets>
+typename KeyedDisjointSets<Key, Hash, Sets>::index_type
+KeyedDisjointSets<Key, Hash, Sets>::index(const Key& key)
+{
+    size_t i = slot(key);
+    for (; table[i] >= 0; i = (i + 1) & mask)
+        if (keys[table[i]] == key)
+            return table[i];
+    index_type p = sets.make_set();
+    keys.push_back(key);
+    table[i] = p;
+    if (keys.size() * 2 > table.size())
+        rehash(table.size() * 2);
+    return p;
+}
+
+/**
+ * 判断两个键是否属于同一个连通分量.
+ * 不添加没出现过的键.
+ *
+ * @param p: 键p
+ *        q: 键q
+ * @return 是否属于同一个连通分量
+ */
+template<typename Key, typename Hash, typename Sets>
+bool KeyedDisjointSets<Key, Hash, Sets>::connected(const Key& p, const Key& q)
+{
+    index_type i = lookup(p);
+    index_type j = lookup(q);
+    if (i < 0 || j < 0)
+        return p == q;
+    return sets.connected(i, j);
+}
+
+/**
+ * 合并两个键所属的连通分量.
+ * 没出现过的键先按p、q的顺序添加.
+ *
+ * @param p: 键p
+ *        q: 键q
+ * @return true: 合并了两个不同的连通分量
+ *         false: 已经属于同一个连通分量
+ */
+template<typename Key, typename Hash, typename Sets>
+bool KeyedDisjointSets<Key, Hash, Sets>::join(const Key& p, const Key& q)
+{
+    index_type i = index(p);
+    index_type j = index(q);
+    return sets.join(i, j);
+}
+
+/**
+ * 预留至少size个键的空间，之后添加size个键不会扩容.
+ *
+ * @param size: 预留的键数
+ */
+template<typename Key, typename Hash, typename Sets>
+void KeyedDisjointSets<Key, Hash, Sets>::reserve(index_type size)
+{
+    sets.reserve(size);
+    keys.reserve(size);
+    size_t buckets = table.size();
+    while (buckets < size_t(size) * 2)
+        buckets *= 2;
+    if (buckets > table.size())
+        rehash(buckets);
+}
+
+/**
+ * 哈希表扩容.
+ * 按下标顺序重新插入，不需要比较键.
+ *
+ * @param buckets: 新的桶数，为2的幂
+ */
+template<typename Key, typename Hash, typename Sets>
+void KeyedDisjointSets<Key, Hash, Sets>::rehash(size_t buckets)
+{
+    table.assign(buckets, -1);
+    mask = buckets - 1;
+    for (size_t p = 0; p < keys.size(); ++p)
+    {
+        size_t i = slot(keys[p]);
+        while (table[i] >= 0)
+            i = (i + 1) & mask;
+        table[i] = index_type(p);
+    }
+}
+
+} // namespace cpplib
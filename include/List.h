@@ -6,35 +6,53 @@
  ******************************************************************************/
 
 #pragma once
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <stdexcept>
+#include "NodePool.h"
 
 namespace cpplib
 {
 
+/**
+ * 链表结点.
+ * 定义在链表外部，使结点分配器可以按结点类型实例化.
+ */
+template<typename E>
+struct ListNode
+{
+    E elem;
+    ListNode* prev;
+    ListNode* next;
+    ListNode() : elem(), prev(this), next(this) {}
+    ListNode(E elem) : elem(std::move(elem)), prev(this), next(this) {}
+};
+
 /**
  * 使用模板实现的链表.
  * 实现了链表的双向迭代器.
+ * 结点由Pool分配，默认使用NodePool按区块批量分配并复用结点.
+ * 哨兵结点单独分配，空链表不占用结点池的区块.
  */
-template<typename E>
+template<typename E, typename Pool = NodePool<ListNode<E>>>
 class List
 {
-	using iterator = class ListIterator;
-
-    struct Node
-    {
-        E elem;
-        Node* prev;
-        Node* next;
-        Node() : elem(), prev(this), next(this) {}
-        Node(E elem) : elem(std::move(elem)), prev(this), next(this) {}
-    };
+    using Node = ListNode<E>;
 public:
+    // 成员类型定义，使List可以作为Queue和Stack的容器
+    using value_type      = E;
+    using reference       = E&;
+    using const_reference = const E&;
+    using size_type       = int;
+
     List() : n(0), sentinel(new Node) {}
     List(const List& that);
     List(List&& that) noexcept;
     ~List();
 
+    class iterator;
+
     // 返回链表元素的数量
     int size() const { return n; }
     // 判断是否为空链表
@@ -63,17 +81,36 @@ public:
     void swap(List& that);
     // 清空链表
     void clear();
+    // 将that的所有元素转移到指定位置，O(1)
+    void splice(iterator pos, List& that);
+    // 将that中it指向的元素转移到指定位置，O(1)
+    void splice(iterator pos, List& that, iterator it);
+    // 将that中[first, last)的元素转移到指定位置
+    void splice(iterator pos, List& that, iterator first, iterator last);
+    // 合并另一个有序链表，合并后that为空
+    void merge(List& that) { merge(that, std::less<E>()); }
+    // 按comp合并另一个有序链表，合并后that为空
+    template<typename Compare>
+    void merge(List& that, Compare comp);
+    // 对链表元素进行稳定排序
+    void sort() { sort(std::less<E>()); }
+    // 按comp对链表元素进行稳定排序
+    template<typename Compare>
+    void sort(Compare comp);
 
     List& operator=(List that);
     List& operator+=(const List& that);
-    template<typename T>
-    friend List<T> operator+(List<T> lhs, const List<T>& rhs);
-    template <typename T>
-    friend bool operator==(const List<T>& lhs, const List<T>& rhs);
-    template <typename T>
-    friend bool operator!=(const List<T>& lhs, const List<T>& rhs);
-    template<typename T>
-    friend std::ostream& operator<<(std::ostream& os, const List<T>& list);
+    List& operator+=(List&& that);
+    template<typename T, typename P>
+    friend List<T, P> operator+(List<T, P> lhs, const List<T, P>& rhs);
+    template<typename T, typename P>
+    friend List<T, P> operator+(List<T, P> lhs, List<T, P>&& rhs);
+    template <typename T, typename P>
+    friend bool operator==(const List<T, P>& lhs, const List<T, P>& rhs);
+    template <typename T, typename P>
+    friend bool operator!=(const List<T, P>& lhs, const List<T, P>& rhs);
+    template<typename T, typename P>
+    friend std::ostream& operator<<(std::ostream& os, const List<T, P>& list);
 
     // 链表不支持随机访问
     class iterator : public std::iterator<std::bidirectional_iterator_tag, E>
@@ -84,8 +121,6 @@ public:
     public:
         iterator() : pn(nullptr) {}
         iterator(Node* x) : pn(x) {}
-        iterator(const iterator& that) : pn(that.pn) {}
-        ~iterator() {}
 
         E& operator*() const
         { return pn->elem; }
@@ -122,10 +157,16 @@ public:
     iterator end() const { return iterator(sentinel); }
 private:
     int n; // 链表大小
+    Pool pool; // 结点分配器
     Node* sentinel; // 哨兵指针
 
     // 定位指定元素
     Node* locate(int i) const;
+    // 将结点[first, last)转移到pos之前
+    static void transfer(Node* pos, Node* first, Node* last);
+    // 合并两个以nullptr结尾的有序单链表
+    template<typename Compare>
+    static Node* merge_runs(Node* first, Node* second, Compare& comp);
     // 检查索引是否合法
     bool valid(int i) const { return i >= 0 && i < n; }
 };
@@ -133,14 +174,16 @@ private:
 /**
  * 链表复制构造函数.
  * 复制另一个链表作为这个链表的初始化.
+ * 结点池预先一次性分配that.size()个结点.
  *
  * @param that: 被复制的链表
  */
-template<typename E>
-List<E>::List(const List& that)
+template<typename E, typename Pool>
+List<E, Pool>::List(const List& that)
 {
     n = 0;
-    sentinel = new Node();
+    sentinel = new Node;
+    pool.reserve(size_t(that.n));
     for (auto i : that)
         insert_back(i);
 }
@@ -151,20 +194,22 @@ List<E>::List(const List& that)
  *
  * @param that: 被移动的链表
  */
-template<typename E>
-List<E>::List(List&& that) noexcept
+template<typename E, typename Pool>
+List<E, Pool>::List(List&& that) noexcept
 {
     n = that.n;
     sentinel = that.sentinel;
+    pool = std::move(that.pool); // 结点随结点池一起转移
     that.sentinel = nullptr; // 指向空指针，退出被析构
 }
 
 /**
  * 链表析构函数.
  */
-template<typename E>
-List<E>::~List()
+template<typename E, typename Pool>
+List<E, Pool>::~List()
 {
+    if (sentinel == nullptr) return; // 已被移动
     clear();
     delete sentinel;
     sentinel = nullptr;
@@ -178,8 +223,8 @@ List<E>::~List()
  * @return 指向该位置元素的指针
  * @throws std::out_of_range: 索引不合法
  */
-template<typename E>
-typename List<E>::Node* List<E>::locate(int i) const
+template<typename E, typename Pool>
+typename List<E, Pool>::Node* List<E, Pool>::locate(int i) const
 {
     if (!valid(i))
         throw std::out_of_range("List::locate() index out of range.");
@@ -190,20 +235,17 @@ typename List<E>::Node* List<E>::locate(int i) const
 /**
  * 添加元素到链表指定位置.
  *
- * @param i: 要添加元素的索引
+ * @param pos: 指向添加位置的迭代器，元素添加到pos之前
  *        elem: 要添加的元素
- * @throws std::out_of_range: 索引不合法
  */
-template<typename E>
-void List<E>::insert(iterator pos, E elem)
+template<typename E, typename Pool>
+void List<E, Pool>::insert(iterator pos, E elem)
 {
     Node* prec = nullptr;
-    Node* succ = nullptr; // 指定位置的前驱和后继
+    Node* succ = pos.pn; // 指定位置的前驱和后继
     Node* pnew = nullptr;
 
-    if (i == n) succ = sentinel;
-    else        succ = locate(i);
-    pnew = new Node(std::move(elem));
+    pnew = pool.construct(std::move(elem));
     prec = succ->prev;
     prec->next = pnew;
     pnew->prev = prec;
@@ -217,11 +259,11 @@ void List<E>::insert(iterator pos, E elem)
  *
  * @param elem: 要添加的元素
  */
-template<typename E>
-void List<E>::insert_front(E elem)
+template<typename E, typename Pool>
+void List<E, Pool>::insert_front(E elem)
 {
     Node* succ = sentinel->next;
-    Node* pnew = new Node(std::move(elem));
+    Node* pnew = pool.construct(std::move(elem));
 
     sentinel->next = pnew;
     pnew->prev = sentinel;
@@ -235,11 +277,11 @@ void List<E>::insert_front(E elem)
  *
  * @param elem: 要添加的元素
  */
-template<typename E>
-void List<E>::insert_back(E elem)
+template<typename E, typename Pool>
+void List<E, Pool>::insert_back(E elem)
 {
     Node* prec = sentinel->prev;
-    Node* pnew = new Node(std::move(elem));
+    Node* pnew = pool.construct(std::move(elem));
 
     prec->next = pnew;
     pnew->prev = prec;
@@ -251,19 +293,22 @@ void List<E>::insert_back(E elem)
 /**
  * 移除链表中指定位置的元素.
  *
- * @param i: 要移除元素的索引
- * @throws std::out_of_range: 索引不合法
+ * @param pos: 指向要移除元素的迭代器
+ * @throws std::out_of_range: 链表为空
  */
-template<typename E>
-void List<E>::remove(iterator pos)
+template<typename E, typename Pool>
+void List<E, Pool>::remove(iterator pos)
 {
-    Node* pold = locate(i);
+    if (empty() || pos.pn == sentinel)
+        throw std::out_of_range("List::remove");
+
+    Node* pold = pos.pn;
     Node* prec = pold->prev;
     Node* succ = pold->next; // 指定位置的前驱和后继
 
     prec->next = succ;
     succ->prev = prec;
-    delete pold;
+    pool.destroy(pold);
     n--;
 }
 
@@ -272,8 +317,8 @@ void List<E>::remove(iterator pos)
  *
  * @throws std::out_of_range: 队空
  */
-template<typename E>
-void List<E>::remove_front()
+template<typename E, typename Pool>
+void List<E, Pool>::remove_front()
 {
     if (empty())
         throw std::out_of_range("List::remove_front");
@@ -283,7 +328,7 @@ void List<E>::remove_front()
 
     sentinel->next = succ;
     succ->prev = sentinel;
-    delete pold;
+    pool.destroy(pold);
     n--;
 }
 
@@ -292,8 +337,8 @@ void List<E>::remove_front()
  *
  * @throws std::out_of_range: 队空
  */
-template<typename E>
-void List<E>::remove_back()
+template<typename E, typename Pool>
+void List<E, Pool>::remove_back()
 {
     if (empty())
         throw std::out_of_range("List::remove_back");
@@ -303,7 +348,7 @@ void List<E>::remove_back()
 
     prec->next = sentinel;
     sentinel->prev = prec;
-    delete pold;
+    pool.destroy(pold);
     n--;
 }
 
@@ -313,8 +358,8 @@ void List<E>::remove_back()
  * @return 链表头部元素的const引用
  * @throws std::out_of_range: 链表为空
  */
-template<typename E>
-const E& List<E>::front() const
+template<typename E, typename Pool>
+const E& List<E, Pool>::front() const
 {
     if (empty())
         throw std::out_of_range("List::front");
@@ -327,8 +372,8 @@ const E& List<E>::front() const
  * @return 链表尾部元素的const引用
  * @throws std::out_of_range: 链表为空
  */
-template<typename E>
-const E& List<E>::back() const
+template<typename E, typename Pool>
+const E& List<E, Pool>::back() const
 {
     if (empty())
         throw std::out_of_range("List::back");
@@ -340,19 +385,20 @@ const E& List<E>::back() const
  *
  * @param that: List对象that
  */
-template<typename E>
-void List<E>::swap(List<E>& that)
+template<typename E, typename Pool>
+void List<E, Pool>::swap(List<E, Pool>& that)
 {
     using std::swap;
     swap(n, that.n);
     swap(sentinel, that.sentinel);
+    swap(pool, that.pool);
 }
 
 /**
  * 清空该链表元素.
  */
-template<typename E>
-void List<E>::clear()
+template<typename E, typename Pool>
+void List<E, Pool>::clear()
 {
     if (empty()) return;
     if (sentinel == nullptr) return;
@@ -362,13 +408,236 @@ void List<E>::clear()
     while (current != sentinel)
     {
         sentinel->next = current->next;
-        delete current;
+        pool.destroy(current);
         current = sentinel->next;
     }
     sentinel->prev = sentinel;
     n = 0;
 }
 
+/**
+ * 将另一个链表的所有元素转移到指定位置.
+ * 只修改结点的链接，不复制元素也不分配结点，O(1).
+ * 结点转移后由当前链表释放，因此当前链表的结点池需要共享that的结点池.
+ *
+ * @param pos: 指向转移位置的迭代器，元素添加到pos之前
+ *        that: 被转移的链表，转移后为空
+ */
+template<typename E, typename Pool>
+void List<E, Pool>::splice(iterator pos, List& that)
+{
+    if (&that == this || that.empty()) return;
+
+    pool.share(that.pool);
+    transfer(pos.pn, that.sentinel->next, that.sentinel);
+    n += that.n;
+    that.n = 0;
+}
+
+/**
+ * 将另一个链表中的一个元素转移到指定位置，O(1).
+ * that可以是当前链表本身.
+ *
+ * @param pos: 指向转移位置的迭代器，元素添加到pos之前
+ *        that: 元素所在的链表
+ *        it: 指向被转移元素的迭代器
+ * @throws std::out_of_range: it指向that的尾部
+ */
+template<typename E, typename Pool>
+void List<E, Pool>::splice(iterator pos, List& that, iterator it)
+{
+    if (it.pn == that.sentinel)
+        throw std::out_of_range("List::splice");
+    if (pos.pn == it.pn || pos.pn == it.pn->next) return;
+
+    if (&that != this)
+    {
+        pool.share(that.pool);
+        n++;
+        that.n--;
+    }
+    transfer(pos.pn, it.pn, it.pn->next);
+}
+
+/**
+ * 将另一个链表中[first, last)的元素转移到指定位置.
+ * 同一链表内转移为O(1)；链表间转移需要统计区间长度以维护size()，
+ * 为O(k)，k为区间长度，但同样不复制元素也不分配结点.
+ * that为当前链表时，pos不能位于(first, last)之中.
+ *
+ * @param pos: 指向转移位置的迭代器，元素添加到pos之前
+ *        that: 元素所在的链表
+ *        first: 区间起始
+ *        last: 区间结尾（不含）
+ */
+template<typename E, typename Pool>
+void List<E, Pool>::splice(iterator pos, List& that, iterator first, iterator last)
+{
+    if (first == last || pos == first || pos == last) return;
+
+    if (&that != this)
+    {
+        int count = std::distance(first, last);
+
+        pool.share(that.pool);
+        n += count;
+        that.n -= count;
+    }
+    transfer(pos.pn, first.pn, last.pn);
+}
+
+/**
+ * 按comp合并另一个有序链表.
+ * 两个链表都应按comp有序，合并是稳定的，相等元素中当前链表的元素在前.
+ * 只修改结点的链接，不分配结点，O(n + m).
+ *
+ * @param that: 有序链表，合并后为空
+ *        comp: 比较函数，comp(a, b)为true表示a应排在b之前
+ */
+template<typename E, typename Pool>
+template<typename Compare>
+void List<E, Pool>::merge(List& that, Compare comp)
+{
+    if (&that == this || that.empty()) return;
+
+    Node* p = sentinel->next;
+    Node* q = that.sentinel->next;
+
+    pool.share(that.pool);
+    while (p != sentinel && q != that.sentinel)
+    {
+        if (comp(q->elem, p->elem))
+        {
+            // 将that中所有应排在p之前的连续结点一次转移
+            Node* last = q->next;
+            while (last != that.sentinel && comp(last->elem, p->elem))
+                last = last->next;
+            transfer(p, q, last);
+            q = last;
+        }
+        else
+            p = p->next;
+    }
+    if (q != that.sentinel)
+        transfer(sentinel, q, that.sentinel);
+    n += that.n;
+    that.n = 0;
+}
+
+/**
+ * 按comp对链表元素进行稳定排序.
+ * 使用归并排序，bins[i]保存长度为2^i的有序段，
+ * 每取下一个结点就像二进制加法一样逐级进位合并，
+ * 使合并总是发生在最近访问过的结点上，比逐趟遍历整个链表的
+ * 自底向上归并对缓存更友好.
+ * 合并时只修改结点的next链接，排序完成后再统一恢复prev链接.
+ * 不复制元素也不分配内存，时间复杂度O(nlogn).
+ *
+ * @param comp: 比较函数，comp(a, b)为true表示a应排在b之前
+ */
+template<typename E, typename Pool>
+template<typename Compare>
+void List<E, Pool>::sort(Compare comp)
+{
+    if (n < 2) return;
+
+    const int MAX_BINS = 64;
+    Node* bins[MAX_BINS] = {}; // bins[i]为空或者是长度为2^i的有序段
+    int fill = 0; // 使用中的bins数量
+    Node* current = sentinel->next;
+
+    while (current != sentinel)
+    {
+        Node* carry = current;
+        current = current->next;
+        carry->next = nullptr;
+        // 靠后的bins保存更早的元素，合并时放在前面以保证稳定
+        int i = 0;
+        for (; i < fill && bins[i] != nullptr; ++i)
+        {
+            carry = merge_runs(bins[i], carry, comp);
+            bins[i] = nullptr;
+        }
+        bins[i] = carry;
+        if (i == fill) fill++;
+    }
+
+    Node* head = nullptr;
+    for (int i = 0; i < fill; ++i)
+        if (bins[i] != nullptr) head = merge_runs(bins[i], head, comp);
+
+    // 恢复prev链接和哨兵
+    Node* prec = sentinel;
+    for (current = head; current != nullptr; current = current->next)
+    {
+        prec->next = current;
+        current->prev = prec;
+        prec = current;
+    }
+    prec->next = sentinel;
+    sentinel->prev = prec;
+}
+
+/**
+ * 合并两个以nullptr结尾的有序单链表，只使用结点的next链接.
+ * 相等元素中first的元素在前.
+ *
+ * @param first: 有序单链表first
+ *        second: 有序单链表second
+ *        comp: 比较函数
+ * @return 合并后单链表的头结点
+ */
+template<typename E, typename Pool>
+template<typename Compare>
+typename List<E, Pool>::Node*
+List<E, Pool>::merge_runs(Node* first, Node* second, Compare& comp)
+{
+    Node* head = nullptr;
+    Node** link = &head; // 指向待链接的next指针
+
+    while (first != nullptr && second != nullptr)
+    {
+        if (comp(second->elem, first->elem))
+        {
+            *link = second;
+            second = second->next;
+        }
+        else
+        {
+            *link = first;
+            first = first->next;
+        }
+        link = &(*link)->next;
+    }
+    *link = first != nullptr ? first : second;
+    return head;
+}
+
+/**
+ * 将结点[first, last)转移到pos之前.
+ * 区间可以来自任意链表，调用者负责维护两个链表的大小.
+ *
+ * @param pos: 转移位置，结点添加到pos之前
+ *        first: 区间起始结点
+ *        last: 区间结尾结点（不含）
+ */
+template<typename E, typename Pool>
+void List<E, Pool>::transfer(Node* pos, Node* first, Node* last)
+{
+    if (pos == last) return;
+
+    Node* tail = last->prev;
+    // 从原位置断开
+    first->prev->next = last;
+    last->prev = first->prev;
+    // 链接到pos之前
+    Node* prec = pos->prev;
+    prec->next = first;
+    first->prev = prec;
+    tail->next = pos;
+    pos->prev = tail;
+}
+
 /**
  * =操作符重载.
  * 让当前List对象等于给定List对象that.
@@ -376,8 +645,8 @@ void List<E>::clear()
  * @param that: List对象that
  * @return 当前List对象
  */
-template<typename E>
-List<E>& List<E>::operator=(List<E> that)
+template<typename E, typename Pool>
+List<E, Pool>& List<E, Pool>::operator=(List<E, Pool> that)
 {
     swap(that);
     return *this;
@@ -386,15 +655,34 @@ List<E>& List<E>::operator=(List<E> that)
 /**
  * +=操作符重载.
  * 复制另一个对象所有元素,添加到当前对象.
+ * 结点池预先一次性分配that.size()个结点.
  *
  * @param that: List对象that
  * @return 当前List对象
  */
-template<typename E>
-List<E>& List<E>::operator+=(const List<E>& that)
+template<typename E, typename Pool>
+List<E, Pool>& List<E, Pool>::operator+=(const List<E, Pool>& that)
 {
-    for (auto i : that)
-        insert_back(i);
+    int count = that.n; // that可能就是*this，只复制原有的元素
+    auto it = that.begin();
+
+    pool.reserve(count);
+    while (count-- > 0)
+        insert_back(*it++);
+    return *this;
+}
+
+/**
+ * +=操作符重载.
+ * 将另一个临时对象的所有结点拼接到当前对象尾部，不复制元素，O(1).
+ *
+ * @param that: 被移动的List对象that
+ * @return 当前List对象
+ */
+template<typename E, typename Pool>
+List<E, Pool>& List<E, Pool>::operator+=(List<E, Pool>&& that)
+{
+    splice(end(), that);
     return *this;
 }
 
@@ -406,13 +694,28 @@ List<E>& List<E>::operator+=(const List<E>& that)
  *        rhs: List对象rhs
  * @return 包含lhs和rhs所有元素的List对象
  */
-template<typename E>
-List<E> operator+(List<E> lhs, const List<E>& rhs)
+template<typename E, typename Pool>
+List<E, Pool> operator+(List<E, Pool> lhs, const List<E, Pool>& rhs)
 {
     lhs += rhs;
     return lhs;
 }
 
+/**
+ * +操作符重载.
+ * rhs为临时对象时直接拼接其结点，不复制元素.
+ *
+ * @param lhs: List对象lhs
+ *        rhs: 临时List对象rhs
+ * @return 包含lhs和rhs所有元素的List对象
+ */
+template<typename E, typename Pool>
+List<E, Pool> operator+(List<E, Pool> lhs, List<E, Pool>&& rhs)
+{
+    lhs += std::move(rhs);
+    return lhs;
+}
+
 /**
  * ==操作符重载函数，比较两个List对象是否相等.
  *
@@ -421,8 +724,8 @@ List<E> operator+(List<E> lhs, const List<E>& rhs)
  * @return true: 相等
  *         false: 不等
  */
-template<typename E>
-bool operator==(const List<E>& lhs, const List<E>& rhs)
+template<typename E, typename Pool>
+bool operator==(const List<E, Pool>& lhs, const List<E, Pool>& rhs)
 {
     if (&lhs == &rhs)             return true;
     if (lhs.size() != rhs.size()) return false;
@@ -437,8 +740,8 @@ bool operator==(const List<E>& lhs, const List<E>& rhs)
  * @return true: 不等
  *         false: 相等
  */
-template<typename E>
-bool operator!=(const List<E>& lhs, const List<E>& rhs)
+template<typename E, typename Pool>
+bool operator!=(const List<E, Pool>& lhs, const List<E, Pool>& rhs)
 {
     return !(lhs == rhs);
 }
@@ -450,8 +753,8 @@ bool operator!=(const List<E>& lhs, const List<E>& rhs)
  *        list: 要输出的链表
  * @return 输出流对象
  */
-template<typename E>
-std::ostream& operator<<(std::ostream& os, const List<E>& list)
+template<typename E, typename Pool>
+std::ostream& operator<<(std::ostream& os, const List<E, Pool>& list)
 {
     for (auto i : list)
         os << i << " ";
@@ -464,8 +767,8 @@ std::ostream& operator<<(std::ostream& os, const List<E>& list)
  * @param lhs: List对象lhs
  *        rhs: List对象rhs
  */
-template<typename E>
-void swap(List<E>& lhs, List<E>& rhs)
+template<typename E, typename Pool>
+void swap(List<E, Pool>& lhs, List<E, Pool>& rhs)
 {
     lhs.swap(rhs);
 }
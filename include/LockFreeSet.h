@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * LockFreeSet.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.15
+ ******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "Reclaimer.h"
+
+namespace cpplib
+{
+
+/**
+ * 使用Harris-Michael算法实现的无锁有序集合.
+ * 元素按Compare升序保存在单链表中，多个线程可以同时添加、移除和查找元素.
+ * 移除元素分两步：先标记结点next指针的最低位（逻辑删除），
+ * 再把结点从链表中摘除（物理删除），遍历时遇到已标记的结点会帮助摘除.
+ * 被摘除的结点交给Reclaimer延迟释放，可选EpochReclaimer或HazardReclaimer.
+ * 添加、移除和查找的复杂度都是O(n).
+ */
+template<typename E, typename Reclaimer = EpochReclaimer, typename Compare = std::less<E>>
+class LockFreeSet
+{
+    // 结点与List的结点相同，只保留后继指针
+    struct Node
+    {
+        E elem;
+        std::atomic<Node*> next;
+        Node(E elem) : elem(std::move(elem)), next(nullptr) {}
+    };
+    static_assert(alignof(Node) >= 2, "the lowest bit of Node* is used as a mark");
+
+    // 查找得到的位置：prev指向cur，cur是第一个不小于查找元素的结点
+    struct Window
+    {
+        std::atomic<Node*>* prev;
+        Node* cur;
+        Node* next;
+    };
+    using Guard = typename Reclaimer::Guard;
+    // 危险指针槽位的用途
+    enum { NEXT_SLOT, CUR_SLOT, PREV_SLOT };
+public:
+    explicit LockFreeSet(Compare comp = Compare()) : head(nullptr), n(0), comp(comp) {}
+    LockFreeSet(const LockFreeSet&) = delete;
+    LockFreeSet& operator=(const LockFreeSet&) = delete;
+    ~LockFreeSet();
+
+    // 返回集合元素的数量，并发修改时只是近似值
+    int size() const { return n.load(std::memory_order_relaxed); }
+    // 判断集合是否为空
+    bool empty() const { return size() == 0; }
+    // 添加元素，元素已存在时返回false
+    bool insert(E elem);
+    // 移除元素，元素不存在时返回false
+    bool remove(const E& elem);
+    // 判断元素是否存在
+    bool contains(const E& elem);
+    // 按升序对每个元素调用f，并发修改时不保证看到一致的快照
+    template<typename F>
+    void for_each(F f);
+private:
+    std::atomic<Node*> head; // 链表头指针
+    std::atomic<int> n; // 集合大小
+    Compare comp; // 元素比较函数
+    Reclaimer reclaimer; // 结点回收器
+
+    // 查找第一个不小于elem的结点，返回是否与elem相等
+    bool find(Guard& guard, const E& elem, Window& w);
+
+    // 判断指针是否带有删除标记
+    static bool marked(Node* p) { return reinterpret_cast<std::uintptr_t>(p) & 1; }
+    // 返回带删除标记的指针
+    static Node* mark(Node* p)
+    { return reinterpret_cast<Node*>(reinterpret_cast<std::uintptr_t>(p) | 1); }
+    // 返回清除删除标记的指针
+    static Node* unmark(Node* p)
+    { return reinterpret_cast<Node*>(reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(1)); }
+};
+
+/**
+ * 无锁集合析构函数.
+ * 析构时不能有其它线程访问集合，直接释放所有结点.
+ */
+template<typename E, typename Reclaimer, typename Compare>
+LockFreeSet<E, Reclaimer, Compare>::~LockFreeSet()
+{
+    Node* current = head.load(std::memory_order_relaxed);
+    while (current != nullptr)
+    {
+        Node* succ = unmark(current->next.load(std::memory_order_relaxed));
+        delete current;
+        current = succ;
+    }
+}
+
+/**
+ * 添加元素.
+ * 找到插入位置后用CAS把新结点链接到prev，prev改变时重新查找.
+ *
+ * @param elem: 要添加的元素
+ * @return true: 添加成功
+ *         false: 元素已存在
+ */
+template<typename E, typename Reclaimer, typename Compare>
+bool LockFreeSet<E, Reclaimer, Compare>::insert(E elem)
+{
+    Guard guard(reclaimer);
+    // 发布前由unique_ptr持有，比较函数抛出异常时新结点被释放
+    std::unique_ptr<Node> pnew(new Node(std::move(elem)));
+    Window w;
+
+    while (true)
+    {
+        if (find(guard, pnew->elem, w))
+            return false;
+        pnew->next.store(w.cur, std::memory_order_relaxed);
+        if (w.prev->compare_exchange_strong(w.cur, pnew.get(), std::memory_order_release,
+                                            std::memory_order_relaxed))
+        {
+            pnew.release();
+            n.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+/**
+ * 移除元素.
+ * 先标记结点的next指针使其逻辑删除，标记成功的线程负责移除，
+ * 然后尝试摘除结点，失败时由之后的查找帮助摘除.
+ *
+ * @param elem: 要移除的元素
+ * @return true: 移除成功
+ *         false: 元素不存在
+ */
+template<typename E, typename Reclaimer, typename Compare>
+bool LockFreeSet<E, Reclaimer, Compare>::remove(const E& elem)
+{
+    Guard guard(reclaimer);
+    Window w;
+
+    while (true)
+    {
+        if (!find(guard, elem, w))
+            return false;
+        if (!w.cur->next.compare_exchange_strong(w.next, mark(w.next), std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed))
+            continue;
+        n.fetch_sub(1, std::memory_order_relaxed);
+        if (w.prev->compare_exchange_strong(w.cur, w.next, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed))
+            guard.retire(w.cur);
+        else
+            find(guard, elem, w);
+        return true;
+    }
+}
+
+/**
+ * 判断元素是否存在.
+ *
+ * @param elem: 要查找的元素
+ * @return true: 元素存在
+ *         false: 元素不存在
+ */
+template<typename E, typename Reclaimer, typename Compare>
+bool LockFreeSet<E, Reclaimer, Compare>::contains(const E& elem)
+{
+    Guard guard(reclaimer);
+    Window w;
+
+    return find(guard, elem, w);
+}
+
+/**
+ * 按升序对每个未被删除的元素调用f.
+ * 当前结点被摘除时，重新查找第一个大于已访问元素的结点继续遍历，
+ * 因此每个元素至多访问一次.
+ *
+ * @param f: 对元素调用的函数
+ */
+template<typename E, typename Reclaimer, typename Compare>
+template<typename F>
+void LockFreeSet<E, Reclaimer, Compare>::for_each(F f)
+{
+    Guard guard(reclaimer);
+    Window w;
+    std::atomic<Node*>* prev = &head;
+    Node* cur = guard.protect(CUR_SLOT, head);
+
+    while (cur != nullptr)
+    {
+        Node* succ = guard.protect(NEXT_SLOT, cur->next);
+        if (!marked(succ))
+            f(static_cast<const E&>(cur->elem));
+        if (prev->load(std::memory_order_acquire) == cur)
+        {
+            prev = &cur->next;
+            guard.set(PREV_SLOT, cur);
+            cur = unmark(succ);
+        }
+        else if (find(guard, E(cur->elem), w)) // 查找会改变cur的保护，先复制元素
+        {
+            // 跳过与已访问元素相等的结点
+            prev = &w.cur->next;
+            guard.set(PREV_SLOT, w.cur);
+            cur = w.next;
+        }
+        else
+        {
+            prev = w.prev;
+            cur = w.cur;
+        }
+        guard.set(CUR_SLOT, cur);
+    }
+}
+
+/**
+ * 查找第一个不小于elem的结点.
+ * 遍历时摘除遇到的已标记结点，prev改变时从头开始重新查找.
+ * 返回时w.prev、w.cur和w.next分别受PREV_SLOT、CUR_SLOT和NEXT_SLOT保护.
+ *
+ * @param guard: 当前线程的回收守卫
+ *        elem: 要查找的元素
+ *        w: 查找得到的位置
+ * @return true: w.cur的元素与elem相等
+ *         false: 不存在与elem相等的元素
+ */
+template<typename E, typename Reclaimer, typename Compare>
+bool LockFreeSet<E, Reclaimer, Compare>::find(Guard& guard, const E& elem, Window& w)
+{
+retry:
+    w.prev = &head;
+    w.cur = guard.protect(CUR_SLOT, head);
+    while (true)
+    {
+        if (w.cur == nullptr)
+            return false;
+        w.next = guard.protect(NEXT_SLOT, w.cur->next);
+        if (w.prev->load(std::memory_order_acquire) != w.cur)
+            goto retry;
+        if (!marked(w.next))
+        {
+            if (!comp(w.cur->elem, elem))
+                return !comp(elem, w.cur->elem);
+            w.prev = &w.cur->next;
+            guard.set(PREV_SLOT, w.cur);
+        }
+        else
+        {
+            w.next = unmark(w.next);
+            if (!w.prev->compare_exchange_strong(w.cur, w.next, std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed))
+                goto retry;
+            guard.retire(w.cur);
+        }
+        w.cur = w.next;
+        guard.set(CUR_SLOT, w.cur);
+    }
+}
+
+} // namespace cpplib
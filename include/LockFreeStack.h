@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * LockFreeStack.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.22
+ ******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include "Reclaimer.h"
+#include "Stack.h"
+
+namespace cpplib
+{
+
+/**
+ * 使用Treiber算法实现的无锁栈.
+ * 栈顶指针指向单链表的头结点，入栈和出栈都是对栈顶指针的一次CAS.
+ * 出栈的结点交给Reclaimer延迟释放，线程持有的结点不会被释放和复用，
+ * 因此CAS比较的地址相同时结点一定没有被替换，避免了ABA问题.
+ * CAS失败说明竞争激烈，此时线程随机选择消除数组中的一个槽位，
+ * 入栈线程在槽位中等待，出栈线程直接取走槽位中的结点，
+ * 一对入栈和出栈互相抵消，不再访问栈顶指针.
+ * 出栈线程取走结点时把槽位改为TAKEN而不是清空，槽位只由放入结点的入栈线程清空，
+ * 入栈线程离开之前其它线程不能占用槽位，被取走并释放的结点地址即使被复用，
+ * 也不会出现在这个槽位中，撤回时不会误取别人的结点.
+ * 可以作为Stack的容器，此时Stack只支持push和try_pop.
+ */
+template<typename E, typename Reclaimer = HazardReclaimer>
+class LockFreeStack
+{
+    static constexpr size_t CACHE_LINE = 64; // 缓存行大小
+    static constexpr int ELIMINATION_SPINS = 128; // 入栈线程在消除槽位中等待的轮数
+
+    // 结点与List的结点相同，只保留后继指针
+    struct Node
+    {
+        E elem;
+        Node* next;
+        Node(E elem) : elem(std::move(elem)), next(nullptr) {}
+    };
+
+    // 消除数组的槽位，每个槽位独占一个缓存行
+    struct Exchanger
+    {
+        std::atomic<Node*> offer; // 等待出栈线程取走的结点
+        char pad[CACHE_LINE - sizeof(std::atomic<Node*>)];
+        Exchanger() : offer(nullptr) {}
+    };
+    using Guard = typename Reclaimer::Guard;
+
+    // 槽位中的结点已被出栈线程取走，等待入栈线程清空槽位
+    static Node* taken() { return reinterpret_cast<Node*>(uintptr_t(1)); }
+public:
+    // 成员类型定义
+    using value_type      = E;
+    using reference       = E&;
+    using const_reference = const E&;
+    using size_type       = size_t;
+
+    explicit LockFreeStack(int width = std::thread::hardware_concurrency() / 2);
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+    ~LockFreeStack();
+
+    // 判断栈是否为空，并发修改时只是近似值
+    bool empty() const { return top.load(std::memory_order_relaxed) == nullptr; }
+    // 返回栈元素的数量，并发修改时只是近似值
+    size_type size() const { return n.load(std::memory_order_relaxed); }
+    // 返回消除数组的槽位数量
+    int elimination_width() const { return width; }
+
+    // 添加元素到栈顶
+    void insert_back(E elem);
+    // 尝试移除栈顶元素并移动到elem，栈空时返回false
+    bool try_remove_back(E& elem);
+private:
+    std::atomic<Node*> top; // 栈顶指针
+    std::atomic<size_t> n; // 栈的大小
+    int width; // 消除数组的槽位数量，为0时不使用消除
+    std::unique_ptr<Exchanger[]> exchangers; // 消除数组
+    Reclaimer reclaimer; // 结点回收器
+
+    // 在消除数组中等待出栈线程取走node，返回是否被取走
+    bool eliminate_push(Node* node);
+    // 尝试从消除数组中取走一个结点
+    Node* eliminate_pop();
+    // 随机返回消除数组的一个槽位
+    Exchanger& random_exchanger();
+};
+
+/**
+ * 构造函数.
+ *
+ * @param width: 消除数组的槽位数量，默认为处理器数量的一半，为0时不使用消除
+ */
+template<typename E, typename Reclaimer>
+LockFreeStack<E, Reclaimer>::LockFreeStack(int width)
+    : top(nullptr), n(0), width(width > 0 ? width : 0)
+{
+    if (this->width > 0)
+        exchangers.reset(new Exchanger[this->width]);
+}
+
+/**
+ * 析构函数.
+ * 析构时不能有其它线程访问栈.
+ */
+template<typename E, typename Reclaimer>
+LockFreeStack<E, Reclaimer>::~LockFreeStack()
+{
+    Node* p = top.load(std::memory_order_relaxed);
+    while (p != nullptr)
+    {
+        Node* next = p->next;
+        delete p;
+        p = next;
+    }
+}
+
+/**
+ * 添加元素到栈顶.
+ * 结点在发布前设置好后继，之后不再修改，出栈线程读取后继不需要同步.
+ *
+ * @param elem: 要添加的元素
+ */
+template<typename E, typename Reclaimer>
+void LockFreeStack<E, Reclaimer>::insert_back(E elem)
+{
+    Node* node = new Node(std::move(elem));
+
+    // 先增加计数再发布结点，计数不会小于实际的元素数量
+    n.fetch_add(1, std::memory_order_relaxed);
+    node->next = top.load(std::memory_order_relaxed);
+    while (!top.compare_exchange_weak(node->next, node,
+        std::memory_order_release, std::memory_order_relaxed))
+    {
+        if (width > 0)
+        {
+            if (eliminate_push(node))
+                return;
+            node->next = top.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * 尝试移除栈顶元素.
+ * 栈顶结点受危险指针或纪元保护，CAS成功前不会被释放.
+ *
+ * @param elem: 保存栈顶元素
+ * @return true: 出栈成功
+ *         false: 栈空
+ */
+template<typename E, typename Reclaimer>
+bool LockFreeStack<E, Reclaimer>::try_remove_back(E& elem)
+{
+    Guard guard(reclaimer);
+
+    while (true)
+    {
+        Node* node = guard.protect(0, top);
+        if (node == nullptr)
+            return false;
+        if (top.compare_exchange_weak(node, node->next,
+            std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            elem = std::move(node->elem);
+            n.fetch_sub(1, std::memory_order_relaxed);
+            guard.set(0, static_cast<Node*>(nullptr));
+            guard.retire(node);
+            return true;
+        }
+        if (width > 0)
+        {
+            Node* taken = eliminate_pop();
+            if (taken != nullptr)
+            {
+                // 结点从未进入栈，其它线程不会访问它，可以直接释放
+                elem = std::move(taken->elem);
+                n.fetch_sub(1, std::memory_order_relaxed);
+                delete taken;
+                return true;
+            }
+        }
+    }
+}
+
+/**
+ * 把node放入随机的消除槽位并等待出栈线程取走.
+ * 槽位由本线程独占直到清空：出栈线程只能把node换成TAKEN，
+ * 看到TAKEN或撤回失败都说明node已被取走，此时由本线程清空槽位.
+ * 等待和撤回都用acquire，与出栈线程取走结点的CAS同步.
+ *
+ * @param node: 要入栈的结点
+ * @return true: 已被出栈线程取走
+ *         false: 未被取走，需要重新入栈
+ */
+template<typename E, typename Reclaimer>
+bool LockFreeStack<E, Reclaimer>::eliminate_push(Node* node)
+{
+    Exchanger& ex = random_exchanger();
+    Node* expected = nullptr;
+
+    if (!ex.offer.compare_exchange_strong(expected, node,
+        std::memory_order_release, std::memory_order_relaxed))
+        return false;
+    for (int i = 0; i < ELIMINATION_SPINS; ++i)
+    {
+        if (ex.offer.load(std::memory_order_acquire) == taken())
+        {
+            ex.offer.store(nullptr, std::memory_order_release);
+            return true;
+        }
+    }
+    expected = node;
+    if (ex.offer.compare_exchange_strong(expected, nullptr,
+        std::memory_order_acquire, std::memory_order_acquire))
+        return false;
+    // 撤回失败时槽位一定是TAKEN
+    ex.offer.store(nullptr, std::memory_order_release);
+    return true;
+}
+
+/**
+ * 尝试从随机的消除槽位取走入栈线程放入的结点.
+ * 槽位为空或已被取走时直接返回，否则把结点换成TAKEN.
+ *
+ * @return 取走的结点，槽位为空或竞争失败时返回nullptr
+ */
+template<typename E, typename Reclaimer>
+typename LockFreeStack<E, Reclaimer>::Node* LockFreeStack<E, Reclaimer>::eliminate_pop()
+{
+    Exchanger& ex = random_exchanger();
+    Node* node = ex.offer.load(std::memory_order_acquire);
+
+    if (node != nullptr && node != taken() && ex.offer.compare_exchange_strong(node, taken(),
+        std::memory_order_acq_rel, std::memory_order_relaxed))
+        return node;
+    return nullptr;
+}
+
+/**
+ * 使用线程局部的xorshift随机数选择消除槽位.
+ *
+ * @return 消除槽位
+ */
+template<typename E, typename Reclaimer>
+typename LockFreeStack<E, Reclaimer>::Exchanger& LockFreeStack<E, Reclaimer>::random_exchanger()
+{
+    thread_local unsigned x = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return exchangers[x % width];
+}
+
+} // namespace cpplib
+
+// 使用无锁栈的并发栈，只支持push和try_pop
+template<typename E>
+using ConcurrentStack = Stack<E, cpplib::LockFreeStack<E>>;
@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * MappedDisjointSets.h
+ *
+ * Author: zhangyu
+ * Date: 2017.9.5
+ ******************************************************************************/
+
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * 只读映射的并查集快照.
+ * 把DisjointSets::save()写出的文件用mmap只读地映射到内存，不复制数组，
+ * 打开的代价与文件大小无关，页面在首次访问时才由操作系统读入，多个进程共享同一份页缓存.
+ * 只能查询不能合并，查找不压缩路径，保存前调用compress()可使每次查找只需一步.
+ * 根结点中负数的含义不影响查询，任何合并策略的快照都可以映射，只要求下标宽度相同.
+ * members()要求快照来自记录成员的并查集；component_size()要求快照包含sizes数组，
+ * 或者合并策略为LinkBySize，此时大小从根结点读出.
+ * 映射只检查文件头和文件长度，信任数组内容：损坏的快照会使查找越界或不终止，
+ * 来源不可信的文件应先用DisjointSets::load()检查.
+ */
+template<typename Index = int>
+class MappedDisjointSets
+{
+    static_assert(std::is_signed<Index>::value, "MappedDisjointSets: Index must be a signed integer type");
+public:
+    // 成员类型定义
+    using index_type = Index;
+
+    explicit MappedDisjointSets(const std::string& path);
+    MappedDisjointSets(const MappedDisjointSets&) = delete;
+    MappedDisjointSets& operator=(const MappedDisjointSets&) = delete;
+    ~MappedDisjointSets() { munmap(base, length); }
+
+    // 判断p与q是否属于同一个连通分量
+    bool connected(Index p, Index q) const { return find(p) == find(q); }
+    // 返回连通分量数
+    Index count() const { return components; }
+    // 返回触点数
+    Index size() const { return n; }
+    // 判断保存时是否每个触点都直接指向根
+    bool flat() const { return compressed; }
+    // 找到p所属连通分量的根触点
+    Index find(Index p) const;
+    // 返回p所属连通分量的大小
+    Index component_size(Index p) const;
+    // 返回p所属连通分量的所有触点
+    std::vector<Index> members(Index p) const;
+private:
+    void* base;           // 映射的起始地址
+    size_t length;        // 映射的长度
+    Index n;              // 触点数
+    Index components;     // 连通分量数
+    bool compressed;      // 是否每个触点都直接指向根
+    bool size_in_root;    // 根结点是否保存分量大小的相反数
+    const Index* parent;  // 映射中的parent数组
+    const Index* next;    // 映射中的next数组，快照不记录成员时为空
+    const Index* sizes;   // 映射中的sizes数组，快照不包含时为空
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < n; }
+};
+
+/**
+ * 构造函数，映射快照文件.
+ *
+ * @param path: 文件路径
+ * @throws std::runtime_error: 文件无法打开或映射，或长度与文件头不符
+ *         std::invalid_argument: 不是快照文件，或版本、下标宽度不符
+ */
+template<typename Index>
+MappedDisjointSets<Index>::MappedDisjointSets(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("MappedDisjointSets::MappedDisjointSets() cannot open " + path);
+    struct stat status;
+    if (fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(DisjointSetsHeader))
+    {
+        close(fd);
+        throw std::runtime_error("MappedDisjointSets::MappedDisjointSets() truncated " + path);
+    }
+    length = size_t(status.st_size);
+    base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // 映射建立后不再需要文件描述符
+    if (base == MAP_FAILED)
+        throw std::runtime_error("MappedDisjointSets::MappedDisjointSets() cannot map " + path);
+
+    const DisjointSetsHeader* header = static_cast<const DisjointSetsHeader*>(base);
+    try
+    {
+        header->check(sizeof(Index), 0, "MappedDisjointSets::MappedDisjointSets() incompatible snapshot.");
+        if (header->size > uint64_t(std::numeric_limits<Index>::max()))
+            throw std::invalid_argument("MappedDisjointSets::MappedDisjointSets() incompatible snapshot.");
+        uint64_t arrays = 1 + ((header->flags & DisjointSetsHeader::NEXT) != 0) +
+                          ((header->flags & DisjointSetsHeader::SIZES) != 0);
+        if (length != sizeof(DisjointSetsHeader) + arrays * header->array_bytes())
+            throw std::runtime_error("MappedDisjointSets::MappedDisjointSets() truncated " + path);
+    }
+    catch (...)
+    {
+        munmap(base, length);
+        throw;
+    }
+    n = Index(header->size);
+    components = Index(header->components);
+    compressed = (header->flags & DisjointSetsHeader::FLAT) != 0;
+    size_in_root = header->link == LinkBySize::id;
+    // 每个数组补齐到8字节，下一个数组从补齐之后开始
+    const char* array = reinterpret_cast<const char*>(header + 1);
+    parent = reinterpret_cast<const Index*>(array);
+    array += header->array_bytes();
+    next = nullptr;
+    sizes = nullptr;
+    if (header->flags & DisjointSetsHeader::NEXT)
+    {
+        next = reinterpret_cast<const Index*>(array);
+        array += header->array_bytes();
+    }
+    if (header->flags & DisjointSetsHeader::SIZES)
+        sizes = reinterpret_cast<const Index*>(array);
+}
+
+/**
+ * 找到p所属连通分量的根触点.
+ * 不压缩路径，不修改映射.
+ *
+ * @param p: 触点p
+ * @return 根触点
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+Index MappedDisjointSets<Index>::find(Index p) const
+{
+    if (!valid(p))
+        throw std::out_of_range("MappedDisjointSets::find() index out of range.");
+    while (parent[p] >= 0)
+        p = parent[p];
+    return p;
+}
+
+/**
+ * 返回p所属连通分量的大小.
+ *
+ * @param p: 触点p
+ * @return 连通分量的大小
+ * @throws std::out_of_range: 触点不合法
+ *         std::invalid_argument: 快照中没有分量大小
+ */
+template<typename Index>
+Index MappedDisjointSets<Index>::component_size(Index p) const
+{
+    Index root = find(p);
+    if (sizes != nullptr)
+        return sizes[root];
+    if (!size_in_root)
+        throw std::invalid_argument("MappedDisjointSets::component_size() snapshot has no sizes.");
+    return Index(-parent[root]);
+}
+
+/**
+ * 返回p所属连通分量的所有触点.
+ * 沿保存时的成员环走一圈，从p开始按环的顺序排列.
+ *
+ * @param p: 触点p
+ * @return 连通分量的所有触点
+ * @throws std::out_of_range: 触点不合法
+ *         std::invalid_argument: 快照不记录成员
+ */
+template<typename Index>
+std::vector<Index> MappedDisjointSets<Index>::members(Index p) const
+{
+    if (!valid(p))
+        throw std::out_of_range("MappedDisjointSets::members() index out of range.");
+    if (next == nullptr)
+        throw std::invalid_argument("MappedDisjointSets::members() snapshot has no member rings.");
+    std::vector<Index> result;
+    Index q = p;
+    do
+    {
+        result.push_back(q);
+        q = next[q];
+    } while (q != p);
+    return result;
+}
+
+} // namespace cpplib
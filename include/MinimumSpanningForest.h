@@ -0,0 +1,382 @@
+/*******************************************************************************
+ * MinimumSpanningForest.h
+ *
+ * Author: zhangyu
+ * Date: 2017.9.2
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "ConcurrentUnionFind.h"
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * 最小生成森林.
+ * 一次性计算带权无向图每个连通分量的最小生成树，提供两种算法：
+ * 1. Kruskal：把权值映射为保序的无符号整数，多线程按字节做LSD基数排序，
+ *    再按权值递增的顺序用DisjointSets合并，森林的边数达到n - 1时提前结束；
+ * 2. Boruvka：每轮多个线程并行地为每个连通分量找出最轻的邻边（用CAS取最小），
+ *    再通过ConcurrentUnionFind并发地合并这些边，已在同一连通分量中的边在下一轮删去，
+ *    每轮至少使连通分量数减半.
+ * 权值相等时按边的下标比较，边之间是全序，两种算法得到同一个森林.
+ * Kruskal返回的边按权值递增排列，Boruvka返回的边按输入顺序排列.
+ * 权值可以是整数、float或double，边数不能超过2^32 - 1.
+ */
+template<typename W = double, typename Index = int>
+class MinimumSpanningForest
+{
+    static_assert(std::is_signed<Index>::value, "MinimumSpanningForest: Index must be a signed integer type");
+    static_assert(std::is_arithmetic<W>::value && (!std::is_floating_point<W>::value || sizeof(W) <= 8),
+                  "MinimumSpanningForest: W must be an integer, float or double");
+public:
+    // 成员类型定义
+    using index_type = Index;
+    using weight_type = W;
+    using total_type = typename std::conditional<std::is_floating_point<W>::value, double, long long>::type;
+
+    // 带权的边
+    struct Edge
+    {
+        Index u, v; // 两端
+        W weight;   // 权值
+    };
+
+    // 算法
+    enum class Algorithm
+    {
+        kruskal, // 基数排序后的Kruskal
+        boruvka  // 并行Boruvka
+    };
+
+    MinimumSpanningForest(Index size, const std::vector<Edge>& edges, Algorithm algorithm = Algorithm::kruskal,
+                          unsigned threads = 0);
+
+    // 返回触点数
+    Index vertices() const { return n; }
+    // 返回树的数量，即连通分量数
+    Index count() const { return n - Index(forest.size()); }
+    // 返回森林的边
+    const std::vector<Edge>& edges() const { return forest; }
+    // 返回森林的总权值
+    total_type weight() const { return total; }
+private:
+    // 排序用的键，与权值同宽，至少32位
+    using Key = typename std::conditional<sizeof(W) <= 4, uint32_t, uint64_t>::type;
+
+    static const size_t GRAIN = 65536;       // 每个线程至少处理的任务数
+    static const uint32_t NONE = UINT32_MAX; // 没有边
+
+    Index n;                  // 触点数
+    std::vector<Edge> forest; // 森林的边
+    total_type total;         // 总权值
+    unsigned workers;         // 线程数
+
+    // 浮点数：正数置符号位，负数按位取反
+    static Key key(W w, std::true_type);
+    // 整数：有符号数翻转符号位
+    static Key key(W w, std::false_type);
+    // 把[0, count)静态地分成若干块，每块交给一个线程执行f(t, first, last)，返回块数
+    template<typename F>
+    unsigned parallel_chunks(size_t count, F f) const;
+    // 按权值和下标排序边的下标
+    std::vector<uint32_t> sort_by_weight(const std::vector<Edge>& edges) const;
+    // Kruskal算法
+    void kruskal(const std::vector<Edge>& edges);
+    // Boruvka算法
+    void boruvka(const std::vector<Edge>& edges);
+};
+
+/**
+ * 构造函数，计算最小生成森林.
+ *
+ * @param size: 触点数
+ *        edges: 边表
+ *        algorithm: 算法
+ *        threads: 线程数，0表示使用硬件线程数
+ * @throws std::out_of_range: 边的端点不合法
+ *         std::invalid_argument: 边数超过2^32 - 1
+ */
+template<typename W, typename Index>
+MinimumSpanningForest<W, Index>::MinimumSpanningForest(Index size, const std::vector<Edge>& edges,
+                                                       Algorithm algorithm, unsigned threads)
+    : n(size), total(0), workers(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+    if (edges.size() >= NONE)
+        throw std::invalid_argument("MinimumSpanningForest::MinimumSpanningForest() too many edges.");
+    std::atomic<bool> bad(false);
+    parallel_chunks(edges.size(), [&](unsigned, size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            if (edges[i].u < 0 || edges[i].u >= n || edges[i].v < 0 || edges[i].v >= n)
+                bad.store(true, std::memory_order_relaxed);
+    });
+    if (bad.load())
+        throw std::out_of_range("MinimumSpanningForest::MinimumSpanningForest() index out of range.");
+
+    if (algorithm == Algorithm::kruskal)
+        kruskal(edges);
+    else
+        boruvka(edges);
+    for (const Edge& e : forest)
+        total += e.weight;
+}
+
+/**
+ * 把浮点数映射为保序的无符号整数.
+ * -0.0与+0.0映射为同一个键，与Boruvka用<比较权值时的相等关系一致.
+ *
+ * @param w: 权值
+ * @return 键
+ */
+template<typename W, typename Index>
+typename MinimumSpanningForest<W, Index>::Key MinimumSpanningForest<W, Index>::key(W w, std::true_type)
+{
+    if (w == W(0))
+        w = W(0);
+    Key bits;
+    std::memcpy(&bits, &w, sizeof(Key));
+    Key sign = Key(1) << (8 * sizeof(Key) - 1);
+    return bits & sign ? ~bits : bits | sign;
+}
+
+/**
+ * 把整数映射为保序的无符号整数.
+ *
+ * @param w: 权值
+ * @return 键
+ */
+template<typename W, typename Index>
+typename MinimumSpanningForest<W, Index>::Key MinimumSpanningForest<W, Index>::key(W w, std::false_type)
+{
+    // 有符号数转换时符号扩展到键的宽度，翻转最高位后负数排在前面
+    return std::is_signed<W>::value ? Key(w) ^ (Key(1) << (8 * sizeof(Key) - 1)) : Key(w);
+}
+
+/**
+ * 把[0, count)静态地分成若干块，每块交给一个线程.
+ * 相同的count总是得到相同的分块，基数排序的计数和分配两趟据此对应.
+ *
+ * @param count: 任务数
+ *        f: 处理一块任务的函数f(t, first, last)，t为块号
+ * @return 块数
+ */
+template<typename W, typename Index>
+template<typename F>
+unsigned MinimumSpanningForest<W, Index>::parallel_chunks(size_t count, F f) const
+{
+    unsigned chunks = unsigned(std::max<size_t>(1, std::min<size_t>(workers, count / GRAIN)));
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < chunks; ++t)
+        threads.emplace_back(f, t, count * t / chunks, count * (t + 1) / chunks);
+    f(0u, size_t(0), count / chunks);
+    for (auto& t : threads)
+        t.join();
+    return chunks;
+}
+
+/**
+ * 按权值和下标排序边的下标.
+ * 每趟处理键的一个字节：各线程统计自己那一块的计数，
+ * 按(数字, 块号)的顺序求前缀和得到每块每个数字的起始位置，再各自稳定地分配，
+ * 所有键这一字节都相同时跳过这一趟.
+ *
+ * @param edges: 边表
+ * @return 排序后的下标
+ */
+template<typename W, typename Index>
+std::vector<uint32_t> MinimumSpanningForest<W, Index>::sort_by_weight(const std::vector<Edge>& edges) const
+{
+    size_t m = edges.size();
+    std::vector<Key> keys(m), keys2(m);
+    std::vector<uint32_t> order(m), order2(m);
+    unsigned chunks = parallel_chunks(m, [&](unsigned, size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            keys[i] = key(edges[i].weight, std::is_floating_point<W>());
+            order[i] = uint32_t(i);
+        }
+    });
+
+    std::vector<size_t> counts(size_t(chunks) * 256);
+    for (unsigned shift = 0; shift < 8 * sizeof(Key); shift += 8)
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        parallel_chunks(m, [&](unsigned t, size_t first, size_t last)
+        {
+            size_t* count = &counts[size_t(t) * 256];
+            for (size_t i = first; i < last; ++i)
+                count[(keys[i] >> shift) & 255]++;
+        });
+        bool skip = false;
+        size_t sum = 0;
+        for (unsigned d = 0; d < 256; ++d)
+        {
+            size_t digit = 0;
+            for (unsigned t = 0; t < chunks; ++t)
+            {
+                size_t c = counts[size_t(t) * 256 + d];
+                counts[size_t(t) * 256 + d] = sum;
+                sum += c;
+                digit += c;
+            }
+            skip = skip || digit == m;
+        }
+        if (skip)
+            continue;
+        parallel_chunks(m, [&](unsigned t, size_t first, size_t last)
+        {
+            size_t* count = &counts[size_t(t) * 256];
+            for (size_t i = first; i < last; ++i)
+            {
+                size_t pos = count[(keys[i] >> shift) & 255]++;
+                keys2[pos] = keys[i];
+                order2[pos] = order[i];
+            }
+        });
+        keys.swap(keys2);
+        order.swap(order2);
+    }
+    return order;
+}
+
+/**
+ * Kruskal算法.
+ * 按权值递增的顺序处理边，两端不连通时加入森林.
+ *
+ * @param edges: 边表
+ */
+template<typename W, typename Index>
+void MinimumSpanningForest<W, Index>::kruskal(const std::vector<Edge>& edges)
+{
+    std::vector<uint32_t> order = sort_by_weight(edges);
+    DisjointSets<Index> uf(n);
+    for (size_t i = 0; i < order.size() && Index(forest.size()) + 1 < n; ++i)
+    {
+        const Edge& e = edges[order[i]];
+        if (uf.join(e.u, e.v))
+            forest.push_back(e);
+    }
+}
+
+/**
+ * 并行Boruvka算法.
+ * 边的下标按块静态地分给各线程，每轮分三个阶段：
+ * 1. 各线程从根表读出自己的边两端的根，两端已连通的边就地删去，
+ *    其余的边用CAS更新两端的根的最轻邻边；
+ * 2. 各线程处理自己那一段触点，合并其最轻邻边的两端，合并成功的边加入森林；
+ * 3. 重新查找每个触点的根写入根表，下一轮扫描边时不再沿并查集的路径查找.
+ * 边之间是全序，所选的边不会形成环，合并失败只可能是两端选了同一条边.
+ *
+ * @param edges: 边表
+ */
+template<typename W, typename Index>
+void MinimumSpanningForest<W, Index>::boruvka(const std::vector<Edge>& edges)
+{
+    size_t m = edges.size();
+    ConcurrentUnionFind<Index> uf(n);
+    std::unique_ptr<std::atomic<uint32_t>[]> best(new std::atomic<uint32_t>[n]);
+    std::vector<Index> root(n); // 本轮开始时每个触点的根
+    std::vector<uint32_t> active(m);
+    unsigned chunks = parallel_chunks(size_t(n), [&](unsigned, size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            best[i].store(NONE, std::memory_order_relaxed);
+            root[i] = Index(i);
+        }
+    });
+    chunks = parallel_chunks(m, [&](unsigned, size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            active[i] = uint32_t(i);
+    });
+    std::vector<size_t> alive(chunks); // 每块剩余的边数，剩余的边存放在块的开头
+    for (unsigned t = 0; t < chunks; ++t)
+        alive[t] = m * (t + 1) / chunks - m * t / chunks;
+    std::vector<std::vector<uint32_t>> chosen(std::max(workers, 1u));
+
+    auto lighter = [&](uint32_t a, uint32_t b)
+    {
+        return edges[a].weight < edges[b].weight || (!(edges[b].weight < edges[a].weight) && a < b);
+    };
+    auto propose = [&](Index root, uint32_t e)
+    {
+        uint32_t current = best[root].load(std::memory_order_relaxed);
+        while ((current == NONE || lighter(e, current)) &&
+               !best[root].compare_exchange_weak(current, e, std::memory_order_relaxed))
+        {
+        }
+    };
+
+    while (true)
+    {
+        std::vector<std::thread> threads;
+        auto scan = [&](unsigned t)
+        {
+            uint32_t* slice = active.data() + m * t / chunks;
+            size_t kept = 0;
+            for (size_t i = 0; i < alive[t]; ++i)
+            {
+                uint32_t e = slice[i];
+                Index rootU = root[edges[e].u];
+                Index rootV = root[edges[e].v];
+                if (rootU == rootV)
+                    continue;
+                slice[kept++] = e;
+                propose(rootU, e);
+                propose(rootV, e);
+            }
+            alive[t] = kept;
+        };
+        for (unsigned t = 1; t < chunks; ++t)
+            threads.emplace_back(scan, t);
+        scan(0);
+        for (auto& t : threads)
+            t.join();
+        size_t remaining = 0;
+        for (size_t a : alive)
+            remaining += a;
+        if (remaining == 0)
+            break;
+
+        parallel_chunks(size_t(n), [&](unsigned t, size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                uint32_t e = best[i].load(std::memory_order_relaxed);
+                if (e == NONE)
+                    continue;
+                best[i].store(NONE, std::memory_order_relaxed);
+                if (uf.join(edges[e].u, edges[e].v))
+                    chosen[t].push_back(e);
+            }
+        });
+        parallel_chunks(size_t(n), [&](unsigned, size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+                root[i] = uf.find(Index(i));
+        });
+    }
+
+    std::vector<uint32_t> picked;
+    for (auto& c : chosen)
+        picked.insert(picked.end(), c.begin(), c.end());
+    std::sort(picked.begin(), picked.end());
+    forest.reserve(picked.size());
+    for (uint32_t e : picked)
+        forest.push_back(edges[e]);
+}
+
+} // namespace cpplib
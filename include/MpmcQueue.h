@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * MpmcQueue.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.18
+ ******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "Queue.h"
+
+namespace cpplib
+{
+
+/**
+ * 使用Vyukov算法实现的有界多生产者多消费者队列.
+ * 元素保存在容量为2的幂的环形数组中，每个槽位带一个序号：
+ * 序号等于入队位置时槽位可写，等于入队位置 + 1时槽位可读，
+ * 生产者和消费者分别用CAS争夺入队和出队位置，之后只访问自己的槽位.
+ * 入队和出队位置位于不同的缓存行，避免生产者和消费者互相干扰.
+ * 元素的复制和移动构造不能抛出异常.
+ * 可以作为Queue的容器，此时Queue的enqueue在队满时自旋等待.
+ */
+template<typename E>
+class MpmcQueue
+{
+    static constexpr size_t CACHE_LINE = 64; // 缓存行大小
+    static constexpr size_t DEFAULT_CAPACITY = 1024; // 默认容量
+
+    // 环形数组的槽位
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(E), alignof(E)>::type storage;
+        E* elem() { return reinterpret_cast<E*>(&storage); }
+    };
+public:
+    // 成员类型定义
+    using value_type      = E;
+    using reference       = E&;
+    using const_reference = const E&;
+    using size_type       = size_t;
+
+    explicit MpmcQueue(size_type capacity = DEFAULT_CAPACITY);
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    ~MpmcQueue();
+
+    // 判断队列是否为空，并发修改时只是近似值
+    bool empty() const { return size() == 0; }
+    // 返回队列元素的数量，并发修改时只是近似值
+    size_type size() const;
+    // 返回队列的容量
+    size_type capacity() const { return mask + 1; }
+
+    // 尝试添加元素到队尾，队满时返回false
+    bool try_insert_back(const E& elem) { return try_push(elem); }
+    // 尝试移动元素到队尾，队满时返回false且elem不被移动
+    bool try_insert_back(E&& elem) { return try_push(std::move(elem)); }
+    // 尝试移除队首元素并移动到elem，队空时返回false
+    bool try_remove_front(E& elem);
+    // 添加元素到队尾，队满时自旋等待
+    void insert_back(E elem);
+private:
+    Cell* buffer; // 环形数组
+    size_t mask; // 容量 - 1，用于计算槽位下标
+    char pad0[CACHE_LINE];
+    std::atomic<size_t> enqueue_pos; // 下一个入队位置
+    char pad1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeue_pos; // 下一个出队位置
+    char pad2[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+    // 尝试入队
+    template<typename T>
+    bool try_push(T&& elem);
+};
+
+/**
+ * 构造函数.
+ * 容量向上取整为2的幂，至少为2.
+ *
+ * @param capacity: 队列容量
+ */
+template<typename E>
+MpmcQueue<E>::MpmcQueue(size_type capacity)
+{
+    size_t count = 2;
+    while (count < capacity)
+        count <<= 1;
+    buffer = new Cell[count];
+    mask = count - 1;
+    for (size_t i = 0; i < count; ++i)
+        buffer[i].sequence.store(i, std::memory_order_relaxed);
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * 析构函数.
+ * 析构时不能有其它线程访问队列.
+ */
+template<typename E>
+MpmcQueue<E>::~MpmcQueue()
+{
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    size_t end = enqueue_pos.load(std::memory_order_relaxed);
+    for (; pos != end; ++pos)
+        buffer[pos & mask].elem()->~E();
+    delete[] buffer;
+}
+
+/**
+ * 返回队列元素的数量.
+ *
+ * @return 队列元素的数量
+ */
+template<typename E>
+typename MpmcQueue<E>::size_type MpmcQueue<E>::size() const
+{
+    size_t head = dequeue_pos.load(std::memory_order_relaxed);
+    size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+}
+
+/**
+ * 尝试入队.
+ * 槽位序号小于入队位置说明该槽位的上一轮元素还未出队，即队满.
+ *
+ * @param elem: 要添加的元素
+ * @return true: 入队成功
+ *         false: 队满
+ */
+template<typename E>
+template<typename T>
+bool MpmcQueue<E>::try_push(T&& elem)
+{
+    Cell* cell;
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        cell = &buffer[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+    new (cell->elem()) E(std::forward<T>(elem));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * 尝试移除队首元素.
+ * 槽位序号小于出队位置 + 1说明该槽位的元素还未入队，即队空.
+ *
+ * @param elem: 保存队首元素
+ * @return true: 出队成功
+ *         false: 队空
+ */
+template<typename E>
+bool MpmcQueue<E>::try_remove_front(E& elem)
+{
+    Cell* cell;
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        cell = &buffer[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+    }
+    elem = std::move(*cell->elem());
+    cell->elem()->~E();
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * 添加元素到队尾，队满时让出处理器并重试.
+ *
+ * @param elem: 要添加的元素
+ */
+template<typename E>
+void MpmcQueue<E>::insert_back(E elem)
+{
+    while (!try_push(std::move(elem)))
+        std::this_thread::yield();
+}
+
+} // namespace cpplib
+
+// 使用有界无锁队列的并发队列，只支持enqueue、try_enqueue和try_dequeue，构造参数为容量
+template<typename E>
+using ConcurrentQueue = Queue<E, cpplib::MpmcQueue<E>>;
@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * NodePool.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.2
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpplib
+{
+
+/**
+ * 使用模板实现的结点池.
+ * 以区块（chunk）为单位批量分配结点内存，释放的结点链入空闲链表以供复用，
+ * 避免每个结点都调用一次new/delete，并使相邻分配的结点在内存中连续.
+ * 区块的容量按两倍增长，直到达到MAX_CHUNK_SIZE.
+ * 区块内存由结点池统一持有，在结点池析构时释放.
+ * 结点被转移到另一个结点池管理时（如链表间拼接），通过share()共享区块的
+ * 所有权，区块在所有引用它的结点池都析构后才释放.
+ */
+template<typename T>
+class NodePool
+{
+    // 空闲槽位复用结点内存存储空闲链表的后继指针
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    // 所有区块的持有者，析构时释放所有区块
+    struct Arena
+    {
+        std::vector<Slot*> chunks;
+        ~Arena()
+        {
+            for (auto chunk : chunks)
+                delete[] chunk;
+        }
+    };
+
+    // 根据结点大小确定首个区块的槽位数，使其约为一个内存页
+    static constexpr size_t MIN_CHUNK_SIZE =
+            sizeof(Slot) < 256 ? 4096 / sizeof(Slot) : 16;
+    static constexpr size_t MAX_CHUNK_SIZE = 1 << 16; // 区块的最大槽位数
+public:
+    NodePool() : arena(nullptr), free_list(nullptr), cursor(nullptr),
+                 limit(nullptr), free_count(0), total(0) {}
+    // 结点池不共享区块，复制得到的是一个空的结点池
+    NodePool(const NodePool&) : NodePool() {}
+    NodePool(NodePool&& that) noexcept : NodePool() { swap(that); }
+    ~NodePool() = default;
+    NodePool& operator=(NodePool that) { swap(that); return *this; }
+
+    // 分配一个未构造的结点
+    T* allocate();
+    // 释放一个已析构的结点，放回空闲链表
+    void deallocate(T* p);
+    // 分配并构造一个结点
+    template<typename... Args>
+    T* construct(Args&&... args);
+    // 析构并释放一个结点
+    void destroy(T* p);
+    // 预留至少count个空闲结点，至多分配一个区块
+    void reserve(size_t count);
+    // 共享另一个结点池的区块，使其结点可以由当前结点池释放
+    void share(const NodePool& that);
+    // 返回已分配的区块数量
+    size_t chunks() const { return arena ? arena->chunks.size() : 0; }
+    // 返回结点池的总槽位数量
+    size_t capacity() const { return total; }
+    // 返回可直接分配的空闲槽位数量
+    size_t available() const { return free_count + (limit - cursor); }
+    // 内容与另一个NodePool对象交换
+    void swap(NodePool& that);
+private:
+    std::shared_ptr<Arena> arena; // 当前结点池分配的区块
+    std::set<std::shared_ptr<Arena>> borrowed; // 共享自其它结点池的区块，每个持有者只记录一次
+    Slot* free_list;   // 空闲链表头
+    Slot* cursor;      // 当前区块中下一个未使用的槽位
+    Slot* limit;       // 当前区块的尾后槽位
+    size_t free_count; // 空闲链表长度
+    size_t total;      // 所有区块的槽位总数
+
+    // 分配一个容纳count个槽位的新区块
+    void grow(size_t count);
+    // 持有另一个区块的所有权
+    void adopt(const std::shared_ptr<Arena>& that);
+};
+
+/**
+ * 分配一个未构造的结点.
+ * 优先复用空闲链表中的结点，其次使用当前区块的未用槽位，
+ * 都不可用时分配新的区块.
+ *
+ * @return 指向未构造结点的指针
+ */
+template<typename T>
+T* NodePool<T>::allocate()
+{
+    Slot* slot;
+
+    if (free_list != nullptr)
+    {
+        slot = free_list;
+        free_list = slot->next;
+        free_count--;
+    }
+    else
+    {
+        if (cursor == limit)
+            grow(total < MIN_CHUNK_SIZE ? size_t(MIN_CHUNK_SIZE)
+                                        : std::min(total, size_t(MAX_CHUNK_SIZE)));
+        slot = cursor++;
+    }
+    return reinterpret_cast<T*>(slot);
+}
+
+/**
+ * 释放一个已析构的结点，放回空闲链表.
+ *
+ * @param p: 由该结点池分配的结点指针
+ */
+template<typename T>
+void NodePool<T>::deallocate(T* p)
+{
+    Slot* slot = reinterpret_cast<Slot*>(p);
+
+    slot->next = free_list;
+    free_list = slot;
+    free_count++;
+}
+
+/**
+ * 分配并用给定参数构造一个结点.
+ * 构造失败时结点被放回空闲链表.
+ *
+ * @param args: 结点构造函数的参数
+ * @return 指向已构造结点的指针
+ */
+template<typename T>
+template<typename... Args>
+T* NodePool<T>::construct(Args&&... args)
+{
+    T* p = allocate();
+
+    try
+    {
+        return ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        deallocate(p);
+        throw;
+    }
+}
+
+/**
+ * 析构并释放一个结点.
+ *
+ * @param p: 由该结点池分配的结点指针
+ */
+template<typename T>
+void NodePool<T>::destroy(T* p)
+{
+    p->~T();
+    deallocate(p);
+}
+
+/**
+ * 预留至少count个空闲结点.
+ * 空闲槽位不足时一次性分配一个足够大的区块，用于批量插入.
+ *
+ * @param count: 需要的空闲结点数
+ */
+template<typename T>
+void NodePool<T>::reserve(size_t count)
+{
+    size_t free = available();
+
+    if (free < count)
+        grow(std::max(count - free, size_t(MIN_CHUNK_SIZE)));
+}
+
+/**
+ * 共享另一个结点池的区块.
+ * that的结点转移到当前结点池后，由当前结点池释放并复用，
+ * 因此需要同时持有that自身以及that所共享的所有区块.
+ *
+ * @param that: 转出结点的结点池
+ */
+template<typename T>
+void NodePool<T>::share(const NodePool& that)
+{
+    if (&that == this) return;
+    adopt(that.arena);
+    for (auto& i : that.borrowed)
+        adopt(i);
+}
+
+/**
+ * 交换当前NodePool对象和另一个NodePool对象.
+ *
+ * @param that: NodePool对象that
+ */
+template<typename T>
+void NodePool<T>::swap(NodePool& that)
+{
+    using std::swap;
+    swap(arena, that.arena);
+    swap(borrowed, that.borrowed);
+    swap(free_list, that.free_list);
+    swap(cursor, that.cursor);
+    swap(limit, that.limit);
+    swap(free_count, that.free_count);
+    swap(total, that.total);
+}
+
+/**
+ * 分配一个容纳count个槽位的新区块.
+ * 当前区块剩余的未用槽位先链入空闲链表，再切换到新区块.
+ *
+ * @param count: 新区块的槽位数
+ */
+template<typename T>
+void NodePool<T>::grow(size_t count)
+{
+    // 区块持有者在首次分配区块时创建，空结点池不占用内存
+    if (!arena)
+        arena.reset(new Arena);
+    arena->chunks.reserve(arena->chunks.size() + 1);
+    Slot* chunk = new Slot[count];
+    arena->chunks.push_back(chunk);
+    while (cursor != limit)
+    {
+        cursor->next = free_list;
+        free_list = cursor++;
+        free_count++;
+    }
+    cursor = chunk;
+    limit = chunk + count;
+    total += count;
+}
+
+/**
+ * 持有另一个区块的所有权，已持有的区块不重复记录.
+ * borrowed的大小不超过曾转入结点的不同结点池的数量，
+ * 反复在同一组链表间拼接不会使其增长.
+ *
+ * @param that: 区块持有者
+ */
+template<typename T>
+void NodePool<T>::adopt(const std::shared_ptr<Arena>& that)
+{
+    if (that && that != arena)
+        borrowed.insert(that);
+}
+
+/**
+ * 交换两个NodePool对象.
+ *
+ * @param lhs: NodePool对象lhs
+ *        rhs: NodePool对象rhs
+ */
+template<typename T>
+void swap(NodePool<T>& lhs, NodePool<T>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/**
+ * 不使用池化的结点分配器.
+ * 与NodePool接口相同，每个结点单独调用new/delete，用于对比测试.
+ */
+template<typename T>
+class NewPool
+{
+public:
+    // 分配一个未构造的结点
+    T* allocate() { return static_cast<T*>(::operator new(sizeof(T))); }
+    // 释放一个已析构的结点
+    void deallocate(T* p) { ::operator delete(p); }
+    // 分配并构造一个结点
+    template<typename... Args>
+    T* construct(Args&&... args) { return new T(std::forward<Args>(args)...); }
+    // 析构并释放一个结点
+    void destroy(T* p) { delete p; }
+    // 逐个分配的结点无需预留
+    void reserve(size_t) {}
+    // 结点由全局堆管理，无需共享
+    void share(const NewPool&) {}
+    // 无状态，交换无需操作
+    void swap(NewPool&) {}
+};
+
+} // namespace cpplib
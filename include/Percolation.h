@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * Percolation.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.27
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * N×N网格上的渗透模型.
+ * 格点编号为row * n + col，另加虚拟的顶端结点n * n和底端结点n * n + 1，
+ * 第一行的开放格点与顶端相连，最后一行的开放格点与底端相连，
+ * 顶端与底端连通即为渗透.
+ * 开放状态保存在64位字的位集中，一个缓存行覆盖512个格点；
+ * 连通性直接在parent数组上使用DisjointSets的按秩合并和路径减半策略，
+ * 每个格点只占一个整数.
+ */
+class Percolation
+{
+public:
+    explicit Percolation(int size);
+
+    // 返回网格边长
+    int size() const { return n; }
+    // 开放格点(row, col)，行列从0开始
+    void open(int row, int col);
+    // 判断格点(row, col)是否开放
+    bool is_open(int row, int col) const;
+    // 返回开放格点的数量
+    long long number_of_open_sites() const { return opened; }
+    // 判断是否渗透
+    bool percolates() { return find(top()) == find(bottom()); }
+private:
+    int n;                        // 网格边长
+    long long opened;             // 开放格点的数量
+    std::vector<uint64_t> bits;   // 开放状态的位集
+    std::vector<int> parent;      // 格点和两个虚拟结点的父结点，根结点为负数
+
+    // 顶端虚拟结点
+    int top() const { return n * n; }
+    // 底端虚拟结点
+    int bottom() const { return n * n + 1; }
+    // 不检查下标地判断格点是否开放
+    bool opened_at(int site) const { return (bits[site >> 6] >> (site & 63)) & 1; }
+    // 找到根结点
+    int find(int p) { return CompressHalving::find(parent.data(), p); }
+    // 合并两个结点
+    void join(int p, int q);
+
+    friend class PercolationStats;
+};
+
+/**
+ * 构造函数，所有格点都关闭.
+ *
+ * @param size: 网格边长
+ * @throws std::out_of_range: 边长不是正数或格点数超出int范围
+ */
+inline Percolation::Percolation(int size)
+    : n(size), opened(0)
+{
+    if (size <= 0 || size > 46340)
+        throw std::out_of_range("Percolation::Percolation() size out of range.");
+    bits.assign((size_t(n) * n + 63) / 64, 0);
+    parent.assign(size_t(n) * n + 2, -1);
+}
+
+/**
+ * 开放格点(row, col)，并与四周开放的格点合并.
+ *
+ * @param row: 行
+ *        col: 列
+ * @throws std::out_of_range: 格点不合法
+ */
+inline void Percolation::open(int row, int col)
+{
+    if (row < 0 || row >= n || col < 0 || col >= n)
+        throw std::out_of_range("Percolation::open() index out of range.");
+    int site = row * n + col;
+    if (opened_at(site))
+        return;
+    bits[site >> 6] |= uint64_t(1) << (site & 63);
+    opened++;
+    if (row == 0)
+        join(site, top());
+    if (row == n - 1)
+        join(site, bottom());
+    if (row > 0 && opened_at(site - n))
+        join(site, site - n);
+    if (row < n - 1 && opened_at(site + n))
+        join(site, site + n);
+    if (col > 0 && opened_at(site - 1))
+        join(site, site - 1);
+    if (col < n - 1 && opened_at(site + 1))
+        join(site, site + 1);
+}
+
+/**
+ * 判断格点(row, col)是否开放.
+ *
+ * @param row: 行
+ *        col: 列
+ * @return 是否开放
+ * @throws std::out_of_range: 格点不合法
+ */
+inline bool Percolation::is_open(int row, int col) const
+{
+    if (row < 0 || row >= n || col < 0 || col >= n)
+        throw std::out_of_range("Percolation::is_open() index out of range.");
+    return opened_at(row * n + col);
+}
+
+/**
+ * 合并两个结点所在的树.
+ *
+ * @param p: 结点p
+ *        q: 结点q
+ */
+inline void Percolation::join(int p, int q)
+{
+    int rootP = find(p);
+    int rootQ = find(q);
+    if (rootP != rootQ)
+        LinkByRank::link(parent.data(), int(parent.size()), rootP, rootQ);
+}
+
+/**
+ * 渗透阈值的蒙特卡洛估计.
+ * 每次试验随机开放格点直到渗透，开放比例即为阈值的一个样本.
+ * 试验由多个线程轮流领取，第i次试验的随机数生成器由种子和i决定，
+ * 各试验的随机序列相互独立，结果与线程数无关.
+ */
+class PercolationStats
+{
+public:
+    PercolationStats(int size, int trials, unsigned threads = 0, uint64_t seed = 2017);
+
+    // 返回样本均值
+    double mean() const { return average; }
+    // 返回样本标准差
+    double stddev() const { return deviation; }
+    // 返回95%置信区间的下界
+    double confidence_lo() const { return average - CONFIDENCE * deviation / std::sqrt(double(samples.size())); }
+    // 返回95%置信区间的上界
+    double confidence_hi() const { return average + CONFIDENCE * deviation / std::sqrt(double(samples.size())); }
+    // 返回每次试验的阈值
+    const std::vector<double>& thresholds() const { return samples; }
+
+    // 进行一次试验，返回阈值
+    static double trial(int size, uint64_t seed);
+private:
+    static constexpr double CONFIDENCE = 1.96; // 95%置信区间的分位数
+
+    std::vector<double> samples; // 每次试验的阈值
+    double average;              // 样本均值
+    double deviation;            // 样本标准差
+};
+
+/**
+ * 构造函数，进行trials次独立试验.
+ *
+ * @param size: 网格边长
+ *        trials: 试验次数
+ *        threads: 线程数，0表示使用硬件线程数
+ *        seed: 随机种子
+ * @throws std::out_of_range: 边长或试验次数不是正数
+ */
+inline PercolationStats::PercolationStats(int size, int trials, unsigned threads, uint64_t seed)
+    : samples(trials > 0 ? trials : 0), average(0.0), deviation(0.0)
+{
+    if (size <= 0 || trials <= 0)
+        throw std::out_of_range("PercolationStats::PercolationStats() size or trials out of range.");
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, unsigned(trials));
+
+    std::atomic<int> next(0);
+    auto work = [&]
+    {
+        int i;
+        while ((i = next.fetch_add(1)) < trials)
+            samples[i] = trial(size, LinkByRandomIndex::priority(seed ^ uint64_t(i)));
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+    for (auto& w : workers)
+        w.join();
+
+    for (double x : samples)
+        average += x;
+    average /= trials;
+    if (trials > 1)
+    {
+        for (double x : samples)
+            deviation += (x - average) * (x - average);
+        deviation = std::sqrt(deviation / (trials - 1));
+    }
+}
+
+/**
+ * 进行一次试验.
+ * 均匀随机地抽取格点，已开放的重新抽取，每开放一个格点检查一次是否渗透.
+ *
+ * @param size: 网格边长
+ *        seed: 本次试验的随机种子
+ * @return 渗透时开放格点的比例
+ */
+inline double PercolationStats::trial(int size, uint64_t seed)
+{
+    Percolation grid(size);
+    std::mt19937_64 gen(seed);
+    uint64_t sites = uint64_t(size) * size;
+    while (!grid.percolates())
+    {
+        int site = int(gen() % sites);
+        if (!grid.opened_at(site))
+            grid.open(site / size, site % size);
+    }
+    return double(grid.number_of_open_sites()) / double(sites);
+}
+
+} // namespace cpplib
@@ -0,0 +1,472 @@
+/*******************************************************************************
+ * Pipeline.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.5
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BlockingQueue.h"
+
+namespace cpplib
+{
+
+// 阶段的配置
+struct StageOptions
+{
+    int workers; // 工作线程数量，至少为1
+    size_t batch; // 每次从输入队列取走的最多元素数量，至少为1
+    size_t capacity; // 输出队列的容量
+    bool ordered; // 多个工作线程时是否保持输入的顺序
+
+    StageOptions(int workers = 1, size_t batch = 64, size_t capacity = 1024, bool ordered = true)
+        : workers(std::max(workers, 1)), batch(std::max(batch, size_t(1))),
+          capacity(capacity), ordered(ordered) {}
+};
+
+// 阶段的统计
+struct StageStats
+{
+    std::string name; // 阶段名字
+    int workers; // 工作线程数量
+    unsigned long long items_in; // 处理的元素数量
+    unsigned long long items_out; // 输出的元素数量
+    unsigned long long batches; // 从输入队列取元素的次数
+    size_t queue_depth; // 输入队列当前的元素数量
+    size_t max_queue_depth; // 取元素前观察到的输入队列最大元素数量
+    unsigned long long parks; // 输入队列上线程休眠的次数
+    double busy_seconds; // 所有工作线程执行阶段函数的总时间（秒）
+    double elapsed_seconds; // 阶段从启动到结束的时间（秒），未结束时到当前为止
+
+    // 返回每秒处理的元素数量
+    double throughput() const { return elapsed_seconds > 0 ? items_in / elapsed_seconds : 0; }
+};
+
+/**
+ * 阶段函数输出元素的接口.
+ * 阶段函数对一个输入可以输出任意多个元素，包括不输出.
+ */
+template<typename T>
+class Emitter
+{
+public:
+    explicit Emitter(std::vector<T>& out) : out(out) {}
+
+    // 输出元素
+    void operator()(const T& elem) { out.push_back(elem); }
+    // 移动输出元素
+    void operator()(T&& elem) { out.push_back(std::move(elem)); }
+private:
+    std::vector<T>& out; // 本批次的输出
+};
+
+/**
+ * 阶段的公共部分，与输入输出的类型无关.
+ */
+class PipelineStageBase
+{
+public:
+    virtual ~PipelineStageBase() = default;
+
+    // 等待所有工作线程结束
+    void join()
+    {
+        for (auto& t : threads)
+            if (t.joinable())
+                t.join();
+    }
+    // 返回阶段的统计
+    virtual StageStats stats() const = 0;
+protected:
+    using clock = std::chrono::steady_clock;
+
+    std::string name; // 阶段名字
+    StageOptions options; // 阶段配置
+    std::vector<std::thread> threads; // 工作线程
+    std::atomic<int> running; // 未结束的工作线程数量
+    std::atomic<unsigned long long> items_in; // 处理的元素数量
+    std::atomic<unsigned long long> items_out; // 输出的元素数量
+    std::atomic<unsigned long long> batches; // 取元素的次数
+    std::atomic<unsigned long long> busy_ns; // 执行阶段函数的总时间（纳秒）
+    std::atomic<size_t> max_depth; // 观察到的输入队列最大元素数量
+    clock::time_point started; // 启动时间
+    std::atomic<long long> finished_ns; // 结束时距启动的时间（纳秒），未结束时为0
+
+    PipelineStageBase(const std::string& name, const StageOptions& options)
+        : name(name), options(options), running(options.workers), items_in(0), items_out(0),
+          batches(0), busy_ns(0), max_depth(0), started(clock::now()), finished_ns(0) {}
+
+    // 填写与类型无关的统计
+    StageStats base_stats() const;
+};
+
+/**
+ * 填写与类型无关的统计.
+ *
+ * @return 统计，队列相关的字段由派生类填写
+ */
+inline StageStats PipelineStageBase::base_stats() const
+{
+    StageStats s = StageStats();
+    long long ns = finished_ns.load(std::memory_order_acquire);
+
+    if (ns == 0)
+        ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+    s.name = name;
+    s.workers = options.workers;
+    s.items_in = items_in.load(std::memory_order_relaxed);
+    s.items_out = items_out.load(std::memory_order_relaxed);
+    s.batches = batches.load(std::memory_order_relaxed);
+    s.max_queue_depth = max_depth.load(std::memory_order_relaxed);
+    s.busy_seconds = busy_ns.load(std::memory_order_relaxed) / 1e9;
+    s.elapsed_seconds = ns / 1e9;
+    return s;
+}
+
+/**
+ * 阶段，工作线程从输入队列批量取元素，调用阶段函数，把输出批量放入输出队列.
+ * 有序模式下工作线程取元素时领取序号，按序号依次输出，输出的顺序与输入队列的顺序相同；
+ * 无序模式下工作线程处理完一批就输出.
+ * 最后一个工作线程结束时关闭输出队列，下游阶段取完剩余元素后也随之结束.
+ */
+template<typename In, typename Out>
+class PipelineStage : public PipelineStageBase
+{
+public:
+    using function = std::function<void(In&, Emitter<Out>&)>;
+
+    PipelineStage(const std::string& name, const StageOptions& options, function f,
+                  BlockingQueue<In>* input, BlockingQueue<Out>* output);
+    ~PipelineStage() { join(); }
+
+    StageStats stats() const override;
+private:
+    static constexpr int POLL_MS = 100; // 等待输入的超时，超时后检查输入队列是否关闭
+
+    function f; // 阶段函数
+    BlockingQueue<In>* input; // 输入队列
+    BlockingQueue<Out>* output; // 输出队列，为空时是终点阶段
+    bool ordered; // 是否按序号输出
+    std::mutex take_lock; // 有序模式下使取元素和领取序号同时完成
+    unsigned long long next_ticket; // 下一批输入的序号
+    std::mutex turn_lock; // 保护下一个输出的序号
+    std::condition_variable turn_changed; // 输出的序号变化
+    unsigned long long next_turn; // 下一个可以输出的序号
+
+    // 工作线程的主循环
+    void work();
+    // 把一批输出放入输出队列，返回是否成功
+    bool emit(std::vector<Out>& out);
+};
+
+/**
+ * 构造函数，启动工作线程.
+ *
+ * @param name: 阶段名字
+ *        options: 阶段配置
+ *        f: 阶段函数
+ *        input: 输入队列
+ *        output: 输出队列，为空时阶段不输出
+ */
+template<typename In, typename Out>
+PipelineStage<In, Out>::PipelineStage(const std::string& name, const StageOptions& options,
+                                      function f, BlockingQueue<In>* input, BlockingQueue<Out>* output)
+    : PipelineStageBase(name, options), f(std::move(f)), input(input), output(output),
+      ordered(options.ordered && options.workers > 1), next_ticket(0), next_turn(0)
+{
+    for (int i = 0; i < options.workers; ++i)
+        threads.emplace_back(&PipelineStage::work, this);
+}
+
+/**
+ * 返回阶段的统计.
+ *
+ * @return 统计
+ */
+template<typename In, typename Out>
+StageStats PipelineStage<In, Out>::stats() const
+{
+    StageStats s = base_stats();
+    auto c = input->counters();
+
+    s.queue_depth = input->size();
+    s.parks = c.parks;
+    return s;
+}
+
+/**
+ * 工作线程的主循环.
+ * 输入队列关闭且取空后退出，最后退出的线程关闭输出队列.
+ */
+template<typename In, typename Out>
+void PipelineStage<In, Out>::work()
+{
+    std::vector<In> in;
+    std::vector<Out> out;
+    Emitter<Out> emitter(out);
+    std::chrono::milliseconds poll(+POLL_MS);
+
+    in.reserve(options.batch);
+    while (true)
+    {
+        size_t depth = input->size();
+        size_t seen = max_depth.load(std::memory_order_relaxed);
+        while (depth > seen && !max_depth.compare_exchange_weak(seen, depth, std::memory_order_relaxed))
+            continue;
+
+        unsigned long long ticket = 0;
+        size_t k;
+        in.clear();
+        if (ordered)
+        {
+            // 持锁时只取已有的元素，队空时在锁外等待，不阻塞其它线程领取序号
+            std::lock_guard<std::mutex> lock(take_lock);
+            k = input->try_dequeue_batch(std::back_inserter(in), options.batch);
+            if (k > 0)
+                ticket = next_ticket++;
+        }
+        else
+            k = input->dequeue_batch(std::back_inserter(in), options.batch, poll);
+        if (k == 0)
+        {
+            if (input->closed() && input->empty())
+                break;
+            if (ordered)
+                input->wait_not_empty(poll);
+            continue;
+        }
+
+        auto begin = clock::now();
+        out.clear();
+        for (auto& elem : in)
+            f(elem, emitter);
+        busy_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - begin).count(), std::memory_order_relaxed);
+        items_in.fetch_add(k, std::memory_order_relaxed);
+        batches.fetch_add(1, std::memory_order_relaxed);
+
+        bool ok;
+        if (ordered)
+        {
+            // 等待前面的批次输出完，输出后把机会交给下一个序号
+            std::unique_lock<std::mutex> lock(turn_lock);
+            turn_changed.wait(lock, [&] { return next_turn == ticket; });
+            ok = emit(out);
+            ++next_turn;
+            turn_changed.notify_all();
+        }
+        else
+            ok = emit(out);
+        if (!ok)
+            break;
+    }
+    if (running.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        finished_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - started).count(), std::memory_order_release);
+        if (output != nullptr)
+            output->close();
+    }
+}
+
+/**
+ * 把一批输出放入输出队列.
+ *
+ * @param out: 本批次的输出，元素被移动
+ * @return true: 全部放入或没有输出队列
+ *         false: 输出队列已关闭
+ */
+template<typename In, typename Out>
+bool PipelineStage<In, Out>::emit(std::vector<Out>& out)
+{
+    if (output == nullptr || out.empty())
+        return true;
+    size_t count = output->enqueue_batch(out.begin(), out.size());
+    items_out.fetch_add(count, std::memory_order_relaxed);
+    return count == out.size();
+}
+
+/**
+ * 流水线的共享状态，持有所有队列和阶段.
+ * 析构时关闭所有队列并等待工作线程结束，未处理的元素被丢弃.
+ */
+class PipelineCore
+{
+public:
+    PipelineCore() = default;
+    PipelineCore(const PipelineCore&) = delete;
+    PipelineCore& operator=(const PipelineCore&) = delete;
+    ~PipelineCore()
+    {
+        for (auto& close : closers)
+            close();
+        for (auto& stage : stages)
+            stage->join();
+    }
+
+    // 创建容量为capacity的队列
+    template<typename T>
+    BlockingQueue<T>* make_queue(size_t capacity)
+    {
+        std::shared_ptr<BlockingQueue<T>> q = std::make_shared<BlockingQueue<T>>(capacity);
+        queues.push_back(q);
+        closers.push_back([q] { q->close(); });
+        return q.get();
+    }
+    // 添加阶段
+    void add_stage(std::unique_ptr<PipelineStageBase> stage) { stages.push_back(std::move(stage)); }
+    // 等待所有阶段结束
+    void join()
+    {
+        for (auto& stage : stages)
+            stage->join();
+    }
+    // 返回所有阶段的统计
+    std::vector<StageStats> stats() const
+    {
+        std::vector<StageStats> result;
+        for (auto& stage : stages)
+            result.push_back(stage->stats());
+        return result;
+    }
+private:
+    std::vector<std::shared_ptr<void>> queues; // 所有队列，在阶段之后销毁
+    std::vector<std::function<void()>> closers; // 关闭每个队列
+    std::vector<std::unique_ptr<PipelineStageBase>> stages; // 所有阶段，按添加的顺序
+};
+
+/**
+ * 流水线.
+ * 输入元素放入源队列，依次经过各个阶段，相邻阶段之间由有界的BlockingQueue连接，
+ * 下游处理不过来时上游在队列上等待.
+ * 每个阶段有自己的工作线程数量、批量大小和输出队列容量.
+ * 阶段在添加时就启动工作线程.
+ * Pipeline<In, Out>是流水线的句柄，In为输入的类型，Out为最后一个阶段输出的类型，
+ * 添加阶段返回新的句柄，所有句柄共享同一条流水线.
+ * 用法：
+ *     Pipeline<string> source;
+ *     auto tail = source.then<Token>("parse", parse).map<int>("eval", eval);
+ *     tail.sink("print", print);
+ *     source.push(line); ...
+ *     source.close();
+ *     source.wait();
+ */
+template<typename In, typename Out = In>
+class Pipeline
+{
+    template<typename, typename> friend class Pipeline;
+public:
+    explicit Pipeline(size_t capacity = 1024);
+
+    // 添加阶段，f(Out&, Emitter<Next>&)对每个元素输出任意多个Next
+    template<typename Next, typename F>
+    Pipeline<In, Next> then(const std::string& name, F f, const StageOptions& options = StageOptions()) const;
+    // 添加阶段，f(Out&)对每个元素返回一个Next
+    template<typename Next, typename F>
+    Pipeline<In, Next> map(const std::string& name, F f, const StageOptions& options = StageOptions()) const;
+    // 添加终点阶段，f(Out&)消费每个元素
+    template<typename F>
+    void sink(const std::string& name, F f, const StageOptions& options = StageOptions()) const;
+
+    // 放入输入元素，流水线已关闭时返回false
+    bool push(const In& elem) const { return source->enqueue(elem); }
+    // 移动放入输入元素，流水线已关闭时返回false
+    bool push(In&& elem) const { return source->enqueue(std::move(elem)); }
+    // 将从first开始的count个元素移动放入，返回放入的数量
+    template<typename InputIterator>
+    size_t push_batch(InputIterator first, size_t count) const { return source->enqueue_batch(first, count); }
+    // 关闭输入，各阶段处理完剩余元素后依次结束
+    void close() const { source->close(); }
+    // 从最后一个阶段的输出取一个元素，流水线结束且取空时返回false
+    bool pop(Out& elem) const { return tail->dequeue(elem); }
+    // 等待所有阶段结束，需要先关闭输入，且输出被sink或pop取走
+    void wait() const { core->join(); }
+    // 返回所有阶段的统计
+    std::vector<StageStats> stats() const { return core->stats(); }
+private:
+    std::shared_ptr<PipelineCore> core; // 共享状态
+    BlockingQueue<In>* source; // 源队列
+    BlockingQueue<Out>* tail; // 最后一个阶段的输出队列
+
+    Pipeline(std::shared_ptr<PipelineCore> core, BlockingQueue<In>* source, BlockingQueue<Out>* tail)
+        : core(std::move(core)), source(source), tail(tail) {}
+};
+
+/**
+ * 构造函数，创建只有源队列的流水线.
+ *
+ * @param capacity: 源队列的容量
+ */
+template<typename In, typename Out>
+Pipeline<In, Out>::Pipeline(size_t capacity)
+    : core(std::make_shared<PipelineCore>())
+{
+    static_assert(std::is_same<In, Out>::value, "Pipeline: a new pipeline starts with Out = In");
+    source = core->make_queue<In>(capacity);
+    tail = source;
+}
+
+/**
+ * 添加阶段.
+ *
+ * @param name: 阶段名字
+ *        f: 阶段函数，f(Out&, Emitter<Next>&)
+ *        options: 阶段配置
+ * @return 以新阶段结尾的流水线句柄
+ */
+template<typename In, typename Out>
+template<typename Next, typename F>
+Pipeline<In, Next> Pipeline<In, Out>::then(const std::string& name, F f, const StageOptions& options) const
+{
+    BlockingQueue<Next>* output = core->make_queue<Next>(options.capacity);
+    core->add_stage(std::unique_ptr<PipelineStageBase>(
+        new PipelineStage<Out, Next>(name, options, std::move(f), tail, output)));
+    return Pipeline<In, Next>(core, source, output);
+}
+
+/**
+ * 添加一对一的阶段.
+ *
+ * @param name: 阶段名字
+ *        f: 阶段函数，f(Out&)返回Next
+ *        options: 阶段配置
+ * @return 以新阶段结尾的流水线句柄
+ */
+template<typename In, typename Out>
+template<typename Next, typename F>
+Pipeline<In, Next> Pipeline<In, Out>::map(const std::string& name, F f, const StageOptions& options) const
+{
+    return then<Next>(name, [f](Out& elem, Emitter<Next>& emit) { emit(f(elem)); }, options);
+}
+
+/**
+ * 添加终点阶段，之后不能再pop.
+ * 需要保持状态的终点阶段应使用一个工作线程.
+ *
+ * @param name: 阶段名字
+ *        f: 阶段函数，f(Out&)
+ *        options: 阶段配置，capacity不使用
+ */
+template<typename In, typename Out>
+template<typename F>
+void Pipeline<In, Out>::sink(const std::string& name, F f, const StageOptions& options) const
+{
+    core->add_stage(std::unique_ptr<PipelineStageBase>(new PipelineStage<Out, Out>(
+        name, options, [f](Out& elem, Emitter<Out>&) { f(elem); }, tail, nullptr)));
+}
+
+} // namespace cpplib
@@ -7,12 +7,15 @@
 
 #pragma once
 #include <iostream>
+#include <type_traits>
+#include <utility>
 #include "Deque.h"
 
 /**
  * 使用模板实现的先进先出队列.
+ * 容器为MpmcQueue时可以在多个线程间使用try_enqueue和try_dequeue，见MpmcQueue.h中的ConcurrentQueue.
  */
-template<typename E, typename Container = Deque<E>>
+template<typename E, typename Container = cpplib::Deque<E>>
 class Queue
 {
     template <typename T, typename C>
@@ -28,6 +31,10 @@ public:
 public:
     // 构造函数隐式声明
     Queue() = default;
+    // 把参数转发给容器的构造函数，如MpmcQueue的容量
+    template<typename Arg, typename... Args,
+             typename = typename std::enable_if<!std::is_same<typename std::decay<Arg>::type, Queue>::value>::type>
+    explicit Queue(Arg&& arg, Args&&... args) : c(std::forward<Arg>(arg), std::forward<Args>(args)...) {}
 
     // 判断是否为空队列
     bool empty() const { return c.empty(); }
@@ -47,6 +54,12 @@ public:
     void enqueue(E elem) { c.insert_back(std::move(elem)); }
     // 出队函数
     void dequeue() { c.remove_front(); }
+    // 尝试入队，容器已满时返回false
+    bool try_enqueue(const E& elem) { return c.try_insert_back(elem); }
+    // 尝试移动元素入队，容器已满时返回false且elem不被移动
+    bool try_enqueue(E&& elem) { return c.try_insert_back(std::move(elem)); }
+    // 尝试出队并移动队首元素到elem，队空时返回false
+    bool try_dequeue(E& elem) { return c.try_remove_front(elem); }
     // 内容与另一个Queue对象交换
     void swap(Queue& that) { c.swap(that.c); }
     // 清空队列，不释放空间，队列容量不变
@@ -0,0 +1,515 @@
+/*******************************************************************************
+ * Reclaimer.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.15
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cpplib
+{
+
+/**
+ * 线程记录的公共部分.
+ * 记录由回收器与使用它的线程共同持有，双方都释放后才删除，
+ * 线程退出后记录可以被其它线程复用.
+ */
+struct ThreadRecord
+{
+    std::atomic<bool> owned; // 是否被某个线程占用
+    std::atomic<int> refs; // 回收器和线程各持有一个引用
+    ThreadRecord* next_record; // 回收器中的下一个记录
+    ThreadRecord() : owned(true), refs(2), next_record(nullptr) {}
+};
+
+/**
+ * 回收器的线程记录表.
+ * 每个线程第一次访问回收器时获得一个Record，之后通过thread_local缓存找到它.
+ * 记录只添加不移除，遍历时不需要加锁.
+ * Record需要继承ThreadRecord.
+ */
+template<typename Record>
+class ThreadRecords
+{
+public:
+    ThreadRecords() : head(nullptr), id(next_id()) {}
+    ThreadRecords(const ThreadRecords&) = delete;
+    ThreadRecords& operator=(const ThreadRecords&) = delete;
+    ~ThreadRecords();
+
+    // 返回当前线程的记录
+    Record& local();
+    // 返回第一个记录，用于遍历所有记录
+    Record* first() const { return static_cast<Record*>(head.load(std::memory_order_acquire)); }
+    // 返回下一个记录
+    static Record* next(Record* r) { return static_cast<Record*>(r->next_record); }
+private:
+    // 线程的记录缓存，线程退出时交还所有记录
+    struct Cache
+    {
+        std::vector<std::pair<unsigned long, Record*>> entries;
+        ~Cache()
+        {
+            for (auto& e : entries)
+            {
+                e.second->owned.store(false, std::memory_order_release);
+                release(e.second);
+            }
+        }
+    };
+
+    std::atomic<ThreadRecord*> head; // 记录链表
+    unsigned long id; // 记录表的唯一编号，不会被复用
+
+    // 释放一个引用，最后一个引用负责删除记录
+    static void release(Record* r)
+    {
+        if (r->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete r;
+    }
+    // 当前线程的记录缓存
+    static Cache& cache()
+    {
+        thread_local Cache c;
+        return c;
+    }
+    // 产生新的记录表编号
+    static unsigned long next_id()
+    {
+        static std::atomic<unsigned long> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * 线程记录表析构函数.
+ * 释放回收器对每个记录的引用，仍被线程缓存的记录由线程退出时删除.
+ */
+template<typename Record>
+ThreadRecords<Record>::~ThreadRecords()
+{
+    Record* r = first();
+    while (r != nullptr)
+    {
+        Record* succ = next(r);
+        release(r);
+        r = succ;
+    }
+}
+
+/**
+ * 返回当前线程的记录.
+ * 先查找线程缓存，再尝试复用已退出线程的记录，最后创建新记录.
+ *
+ * @return 当前线程的记录
+ */
+template<typename Record>
+Record& ThreadRecords<Record>::local()
+{
+    Cache& c = cache();
+
+    for (auto& e : c.entries)
+        if (e.first == id) return *e.second;
+
+    // 清理已析构的记录表留下的缓存
+    auto dead = std::remove_if(c.entries.begin(), c.entries.end(),
+                               [](const std::pair<unsigned long, Record*>& e)
+    {
+        if (e.second->refs.load(std::memory_order_acquire) != 1) return false;
+        release(e.second);
+        return true;
+    });
+    c.entries.erase(dead, c.entries.end());
+
+    for (Record* r = first(); r != nullptr; r = next(r))
+    {
+        bool expected = false;
+        if (!r->owned.load(std::memory_order_relaxed) &&
+            r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            r->refs.fetch_add(1, std::memory_order_relaxed);
+            c.entries.emplace_back(id, r);
+            return *r;
+        }
+    }
+
+    Record* r = new Record;
+    ThreadRecord* old = head.load(std::memory_order_relaxed);
+    do
+        r->next_record = old;
+    while (!head.compare_exchange_weak(old, r, std::memory_order_release,
+                                       std::memory_order_relaxed));
+    c.entries.emplace_back(id, r);
+    return *r;
+}
+
+// 待回收的对象
+struct Retired
+{
+    void* ptr;
+    void (*deleter)(void*);
+    void reclaim() const { deleter(ptr); }
+};
+
+// 删除T类型的对象
+template<typename T>
+void delete_object(void* p)
+{
+    delete static_cast<T*>(p);
+}
+
+// 清除指针低位的标记位
+template<typename T>
+T* strip_mark(T* p)
+{
+    return reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(p) &
+                                ~std::uintptr_t(alignof(T) - 1));
+}
+
+/**
+ * 基于纪元（epoch）的内存回收器.
+ * 线程访问共享结点前进入临界区并记录当前的全局纪元，
+ * 对象在纪元e被移除后，全局纪元推进到e + 2时，
+ * 所有可能看到它的线程都已离开临界区，对象可以安全释放.
+ * 读操作只需要在进入和离开临界区时各写一次线程记录，开销很小，
+ * 但一个停在临界区中的线程会阻止所有对象的回收.
+ * 临界区可以嵌套.
+ */
+class EpochReclaimer
+{
+    static constexpr int BUCKETS = 3; // 按纪元模3分组的待回收链表数量
+    static constexpr int ADVANCE_PERIOD = 64; // 每回收多少个对象尝试推进一次纪元
+
+    struct Record : ThreadRecord
+    {
+        std::atomic<unsigned long long> state; // 临界区中为(纪元 << 1) | 1，否则为0
+        int nesting; // 临界区嵌套深度
+        int retire_count; // 回收计数，用于周期性推进纪元
+        unsigned long long epochs[BUCKETS]; // 每组对象被移除时的纪元
+        std::vector<Retired> limbo[BUCKETS]; // 等待回收的对象
+
+        Record() : state(0), nesting(0), retire_count(0), epochs() {}
+    };
+public:
+    EpochReclaimer() : epoch(0) {}
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+    ~EpochReclaimer();
+
+    /**
+     * 临界区守卫.
+     * 构造时进入临界区，析构时离开临界区，只能在创建它的线程中使用.
+     */
+    class Guard
+    {
+    public:
+        explicit Guard(EpochReclaimer& domain) : domain(domain), record(domain.records.local())
+        { domain.enter(record); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() { domain.leave(record); }
+
+        // 读取共享指针，临界区内读到的结点不会被释放
+        template<typename T>
+        T* protect(int, const std::atomic<T*>& src)
+        { return src.load(std::memory_order_acquire); }
+        // 纪元回收不需要发布指针
+        template<typename T>
+        void set(int, T*) {}
+        // 回收已从数据结构中移除的对象
+        template<typename T>
+        void retire(T* p) { domain.retire(record, Retired{p, &delete_object<T>}); }
+    private:
+        EpochReclaimer& domain;
+        Record& record;
+    };
+private:
+    std::atomic<unsigned long long> epoch; // 全局纪元
+    ThreadRecords<Record> records; // 所有线程的记录
+
+    // 进入临界区
+    void enter(Record& r);
+    // 离开临界区
+    void leave(Record& r);
+    // 延迟回收对象
+    void retire(Record& r, Retired obj);
+    // 所有临界区中的线程都处于当前纪元时，推进全局纪元
+    void try_advance();
+};
+
+/**
+ * 纪元回收器析构函数.
+ * 析构时不能有其它线程访问回收器，释放所有线程记录中等待回收的对象，
+ * 记录本身可能仍被线程缓存，不随回收器删除.
+ */
+inline EpochReclaimer::~EpochReclaimer()
+{
+    for (Record* r = records.first(); r != nullptr; r = records.next(r))
+    {
+        for (auto& bucket : r->limbo)
+        {
+            for (auto& x : bucket)
+                x.reclaim();
+            bucket.clear();
+        }
+    }
+}
+
+/**
+ * 进入临界区.
+ * 发布线程的纪元后需要一个完整的内存屏障，保证之后读取的指针
+ * 不会早于纪元的发布.
+ * 纪元以release发布，推进纪元的线程读到它时，
+ * 该线程之前临界区中的访问都先于之后的释放发生.
+ *
+ * @param r: 当前线程的记录
+ */
+inline void EpochReclaimer::enter(Record& r)
+{
+    if (r.nesting++ > 0) return;
+
+    unsigned long long e = epoch.load(std::memory_order_relaxed);
+    r.state.store((e << 1) | 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+/**
+ * 离开临界区.
+ *
+ * @param r: 当前线程的记录
+ */
+inline void EpochReclaimer::leave(Record& r)
+{
+    if (--r.nesting > 0) return;
+    r.state.store(0, std::memory_order_release);
+}
+
+/**
+ * 延迟回收对象.
+ * 对象按当前全局纪元分组，同时释放纪元落后当前纪元至少2的组.
+ *
+ * @param r: 当前线程的记录
+ *        obj: 已从数据结构中移除的对象
+ */
+inline void EpochReclaimer::retire(Record& r, Retired obj)
+{
+    if (++r.retire_count % ADVANCE_PERIOD == 0)
+        try_advance();
+
+    unsigned long long e = epoch.load(std::memory_order_acquire);
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        if (!r.limbo[i].empty() && e - r.epochs[i] >= 2)
+        {
+            for (auto& x : r.limbo[i])
+                x.reclaim();
+            r.limbo[i].clear();
+        }
+    }
+    int b = e % BUCKETS;
+    r.epochs[b] = e;
+    r.limbo[b].push_back(obj);
+}
+
+/**
+ * 所有临界区中的线程都处于当前纪元时，推进全局纪元.
+ */
+inline void EpochReclaimer::try_advance()
+{
+    unsigned long long e = epoch.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (Record* r = records.first(); r != nullptr; r = records.next(r))
+    {
+        unsigned long long s = r->state.load(std::memory_order_acquire);
+        if ((s & 1) && (s >> 1) != e) return;
+    }
+    epoch.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel);
+}
+
+/**
+ * 基于危险指针（hazard pointer）的内存回收器.
+ * 线程在访问结点前把结点地址发布到自己的危险指针槽位，
+ * 回收对象前扫描所有线程的槽位，只释放没有被任何槽位引用的对象.
+ * 每次读取共享指针都需要一次内存屏障，比纪元回收慢，
+ * 但停顿的线程最多只阻止它发布的危险指针所指对象的回收.
+ * Guard可以嵌套，例如在遍历的回调中再次访问同一个数据结构，
+ * 每层Guard使用自己的SLOTS个槽位，每个线程最多嵌套DEPTH层.
+ */
+class HazardReclaimer
+{
+public:
+    static constexpr int SLOTS = 4; // 每层Guard的危险指针数量
+    static constexpr int DEPTH = 4; // 每个线程最多嵌套的Guard层数
+private:
+    static constexpr size_t MIN_SCAN = 64; // 触发扫描的最少待回收对象数
+
+    struct Record : ThreadRecord
+    {
+        std::atomic<void*> hazards[DEPTH * SLOTS]; // 危险指针槽位，按Guard的嵌套层分组
+        std::vector<Retired> retired; // 等待回收的对象
+        size_t threshold; // 待回收对象达到该数量时扫描
+        int depth; // 当前线程嵌套的Guard层数
+
+        Record() : threshold(MIN_SCAN), depth(0)
+        {
+            for (auto& h : hazards)
+                h.store(nullptr, std::memory_order_relaxed);
+        }
+    };
+public:
+    HazardReclaimer() {}
+    HazardReclaimer(const HazardReclaimer&) = delete;
+    HazardReclaimer& operator=(const HazardReclaimer&) = delete;
+    ~HazardReclaimer();
+
+    /**
+     * 危险指针守卫.
+     * 持有当前线程一层危险指针槽位，析构时清空这一层的槽位.
+     * 嵌套的Guard必须按创建的相反顺序析构，只能在创建它的线程中使用.
+     */
+    class Guard
+    {
+    public:
+        explicit Guard(HazardReclaimer& domain);
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard()
+        {
+            for (int i = 0; i < SLOTS; ++i)
+                slots[i].store(nullptr, std::memory_order_release);
+            record.depth--;
+        }
+
+        // 读取共享指针并发布到槽位i，返回的指针在槽位改变前不会被释放
+        template<typename T>
+        T* protect(int i, const std::atomic<T*>& src);
+        // 发布一个已经受保护的指针到槽位i
+        template<typename T>
+        void set(int i, T* p)
+        { slots[i].store(strip_mark(p), std::memory_order_release); }
+        // 回收已从数据结构中移除的对象
+        template<typename T>
+        void retire(T* p) { domain.retire(record, Retired{p, &delete_object<T>}); }
+    private:
+        HazardReclaimer& domain;
+        Record& record;
+        std::atomic<void*>* slots; // 这一层的危险指针槽位
+    };
+private:
+    ThreadRecords<Record> records; // 所有线程的记录
+
+    // 延迟回收对象
+    void retire(Record& r, Retired obj);
+    // 释放没有被危险指针引用的对象
+    void scan(Record& r);
+};
+
+/**
+ * 危险指针回收器析构函数.
+ * 析构时不能有其它线程访问回收器，释放所有线程记录中等待回收的对象.
+ */
+inline HazardReclaimer::~HazardReclaimer()
+{
+    for (Record* r = records.first(); r != nullptr; r = records.next(r))
+    {
+        for (auto& x : r->retired)
+            x.reclaim();
+        r->retired.clear();
+    }
+}
+
+/**
+ * 危险指针守卫构造函数.
+ * 占用当前线程的下一层槽位，外层Guard发布的指针保持不变.
+ *
+ * @param domain: 危险指针回收器
+ * @throws std::length_error: 当前线程已嵌套DEPTH层Guard
+ */
+inline HazardReclaimer::Guard::Guard(HazardReclaimer& domain)
+    : domain(domain), record(domain.records.local())
+{
+    if (record.depth == DEPTH)
+        throw std::length_error("HazardReclaimer::Guard too many nested guards.");
+    slots = record.hazards + record.depth++ * SLOTS;
+}
+
+/**
+ * 读取共享指针并发布到槽位i.
+ * 发布后重新读取src，若未改变则说明发布时对象仍未被移除，
+ * 之后的扫描一定能看到这个危险指针.
+ * 指针低位的标记位在发布时被清除.
+ *
+ * @param i: 槽位编号
+ *        src: 共享指针
+ * @return 读取到的指针，保留标记位
+ */
+template<typename T>
+T* HazardReclaimer::Guard::protect(int i, const std::atomic<T*>& src)
+{
+    T* p = src.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        slots[i].store(strip_mark(p), std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        T* q = src.load(std::memory_order_acquire);
+        if (q == p) return p;
+        p = q;
+    }
+}
+
+/**
+ * 延迟回收对象，待回收对象较多时扫描所有危险指针.
+ *
+ * @param r: 当前线程的记录
+ *        obj: 已从数据结构中移除的对象
+ */
+inline void HazardReclaimer::retire(Record& r, Retired obj)
+{
+    r.retired.push_back(obj);
+    if (r.retired.size() >= r.threshold)
+        scan(r);
+}
+
+/**
+ * 释放没有被危险指针引用的对象.
+ * 下一次扫描前新增的待回收对象数取危险指针数量的两倍，
+ * 使每次扫描至少释放一半的新增对象，扫描的均摊开销为O(1).
+ *
+ * @param r: 当前线程的记录
+ */
+inline void HazardReclaimer::scan(Record& r)
+{
+    std::vector<void*> hazards;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (Record* x = records.first(); x != nullptr; x = records.next(x))
+    {
+        for (auto& h : x->hazards)
+        {
+            void* p = h.load(std::memory_order_acquire);
+            if (p != nullptr) hazards.push_back(p);
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    auto kept = std::partition(r.retired.begin(), r.retired.end(), [&](const Retired& x)
+    {
+        return std::binary_search(hazards.begin(), hazards.end(), x.ptr);
+    });
+    for (auto it = kept; it != r.retired.end(); ++it)
+        it->reclaim();
+    r.retired.erase(kept, r.retired.end());
+    r.threshold = r.retired.size() + std::max(size_t(MIN_SCAN), 2 * hazards.size());
+}
+
+} // namespace cpplib
@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * RingBuffer.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.28
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cpplib
+{
+
+/**
+ * 忙等待策略.
+ * 一直自旋直到条件满足，延迟最低，但每个等待的线程独占一个处理器.
+ */
+struct BusySpinWait
+{
+    template<typename Ready>
+    void wait(Ready ready) { while (!ready()) continue; }
+    void signal() {}
+};
+
+/**
+ * 让出处理器的等待策略.
+ * 自旋SPIN_TRIES轮后每轮让出处理器，适合线程数不超过处理器数量的场景.
+ */
+struct YieldingWait
+{
+    static constexpr int SPIN_TRIES = 100; // 让出处理器前自旋的轮数
+
+    template<typename Ready>
+    void wait(Ready ready)
+    {
+        for (int i = 0; i < SPIN_TRIES; ++i)
+            if (ready()) return;
+        while (!ready())
+            std::this_thread::yield();
+    }
+    void signal() {}
+};
+
+/**
+ * 阻塞等待策略.
+ * 条件不满足时在条件变量上休眠，不占用处理器，但唤醒延迟较高.
+ * 只有存在休眠的线程时signal才加锁通知.
+ */
+class BlockingWait
+{
+public:
+    BlockingWait() : waiters(0) {}
+
+    template<typename Ready>
+    void wait(Ready ready);
+    void signal();
+private:
+    std::mutex m; // 与条件变量配合的互斥锁
+    std::condition_variable cv; // 休眠线程等待的条件变量
+    std::atomic<int> waiters; // 休眠的线程数量
+};
+
+/**
+ * 等待条件满足.
+ * 登记为等待者后的内存屏障与signal中的屏障配对，
+ * 保证要么等待者看到新的序号，要么通知者看到等待者.
+ *
+ * @param ready: 判断条件是否满足的函数
+ */
+template<typename Ready>
+void BlockingWait::wait(Ready ready)
+{
+    if (ready()) return;
+
+    std::unique_lock<std::mutex> lock(m);
+    waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!ready())
+        cv.wait(lock);
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * 序号改变后唤醒所有休眠的线程.
+ */
+inline void BlockingWait::signal()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        cv.notify_all();
+    }
+}
+
+/**
+ * Disruptor风格的单生产者多消费者环形缓冲区.
+ * 每个事件只写入一次，所有消费者读取同一个槽位，而不是各自复制一份.
+ * 生产者发布序号cursor，每个消费者维护自己已处理的序号，
+ * 消费者可以依赖其它消费者，只处理被依赖者都已处理过的事件；
+ * 生产者等待最慢的消费者，不会覆盖还未被所有消费者处理的槽位.
+ * 消费者每次取走所有可用的事件批量处理，处理完后只更新一次序号.
+ * 序号单调递增，槽位下标为序号对容量取模，容量为2的幂.
+ * 所有消费者必须在发布第一个事件前添加.
+ */
+template<typename E, typename WaitStrategy = YieldingWait>
+class RingBuffer
+{
+    static constexpr size_t CACHE_LINE = 64; // 缓存行大小
+    static constexpr size_t DEFAULT_CAPACITY = 1024; // 默认容量
+
+    // 独占缓存行的序号
+    struct Sequence
+    {
+        char pad0[CACHE_LINE];
+        std::atomic<long long> value;
+        char pad1[CACHE_LINE - sizeof(std::atomic<long long>)];
+        Sequence() : value(-1) {}
+    };
+public:
+    // 成员类型定义
+    using value_type      = E;
+    using reference       = E&;
+    using const_reference = const E&;
+    using size_type       = size_t;
+
+    /**
+     * 消费者.
+     * 由RingBuffer::add_consumer创建，只能在一个线程中使用.
+     */
+    class Consumer
+    {
+    public:
+        Consumer(const Consumer&) = delete;
+        Consumer& operator=(const Consumer&) = delete;
+
+        // 返回已处理的最后一个序号，未处理任何事件时为-1
+        long long sequence() const { return cursor.value.load(std::memory_order_acquire); }
+        // 等待并处理至多max个可用事件，返回处理的数量，缓冲区关闭且处理完所有事件时返回0
+        template<typename F>
+        size_type consume(F f, size_type max = size_type(-1));
+    private:
+        friend class RingBuffer;
+
+        RingBuffer& ring; // 所属的环形缓冲区
+        std::vector<const Sequence*> barrier; // 生产者和被依赖的消费者的序号
+        Sequence cursor; // 已处理的最后一个序号
+
+        Consumer(RingBuffer& ring, std::initializer_list<const Consumer*> depends_on);
+        // 返回可以处理的最大序号
+        long long available() const;
+    };
+
+    explicit RingBuffer(size_type capacity = DEFAULT_CAPACITY);
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // 返回缓冲区的容量
+    size_type capacity() const { return mask + 1; }
+    // 返回已发布的最后一个序号，未发布任何事件时为-1
+    long long cursor() const { return published.value.load(std::memory_order_acquire); }
+    // 判断缓冲区是否已关闭
+    bool closed() const { return is_closed.load(std::memory_order_acquire); }
+
+    // 添加消费者，只处理depends_on中的消费者都已处理过的事件
+    Consumer& add_consumer(std::initializer_list<const Consumer*> depends_on = {});
+    // 申请count个连续的序号，返回其中最大的序号，槽位被所有消费者处理完之前等待
+    long long claim(size_type count = 1);
+    // 返回序号seq对应槽位的引用
+    reference operator[](long long seq) { return entries[seq & mask]; }
+    // 返回序号seq对应槽位的const引用
+    const_reference operator[](long long seq) const { return entries[seq & mask]; }
+    // 发布直到seq的所有已申请序号
+    void publish(long long seq);
+    // 申请一个序号，写入elem并发布
+    void push(E elem);
+    // 关闭缓冲区，消费者处理完所有事件后consume返回0
+    void close();
+private:
+    std::unique_ptr<E[]> entries; // 预先分配的槽位
+    long long mask; // 容量 - 1，用于计算槽位下标
+    long long claimed; // 生产者已申请的最后一个序号
+    long long cached_gate; // 生产者缓存的最慢消费者序号
+    Sequence published; // 已发布的最后一个序号
+    std::vector<std::unique_ptr<Consumer>> consumers; // 所有消费者
+    std::atomic<bool> is_closed; // 是否已关闭
+    WaitStrategy waiter; // 等待策略
+
+    // 返回最慢消费者的序号
+    long long gate() const;
+};
+
+/**
+ * 构造函数.
+ * 容量向上取整为2的幂，至少为2，所有槽位预先默认构造.
+ *
+ * @param capacity: 缓冲区容量
+ */
+template<typename E, typename WaitStrategy>
+RingBuffer<E, WaitStrategy>::RingBuffer(size_type capacity)
+    : claimed(-1), cached_gate(-1), is_closed(false)
+{
+    size_t count = 2;
+    while (count < capacity)
+        count <<= 1;
+    entries.reset(new E[count]);
+    mask = count - 1;
+}
+
+/**
+ * 添加消费者.
+ * 必须在发布第一个事件前调用.
+ *
+ * @param depends_on: 被依赖的消费者，为空时只依赖生产者
+ * @return 新添加的消费者
+ */
+template<typename E, typename WaitStrategy>
+typename RingBuffer<E, WaitStrategy>::Consumer&
+RingBuffer<E, WaitStrategy>::add_consumer(std::initializer_list<const Consumer*> depends_on)
+{
+    consumers.emplace_back(new Consumer(*this, depends_on));
+    return *consumers.back();
+}
+
+/**
+ * 申请count个连续的序号.
+ * 最大序号减去容量后的槽位必须已被所有消费者处理，否则按等待策略等待.
+ *
+ * @param count: 申请的序号数量
+ * @return 申请的最大序号，申请的序号为[返回值 - count + 1, 返回值]
+ * @throws std::out_of_range: count为0或大于容量
+ */
+template<typename E, typename WaitStrategy>
+long long RingBuffer<E, WaitStrategy>::claim(size_type count)
+{
+    if (count == 0 || count > capacity())
+        throw std::out_of_range("RingBuffer::claim");
+
+    long long last = claimed + count;
+    long long wrap = last - capacity();
+    if (wrap > cached_gate)
+    {
+        waiter.wait([this, wrap]
+        {
+            cached_gate = gate();
+            return cached_gate >= wrap;
+        });
+    }
+    claimed = last;
+    return last;
+}
+
+/**
+ * 发布直到seq的所有已申请序号.
+ * 以release写入序号，消费者读到序号后可以看到槽位中的数据.
+ *
+ * @param seq: 发布的最大序号
+ */
+template<typename E, typename WaitStrategy>
+void RingBuffer<E, WaitStrategy>::publish(long long seq)
+{
+    published.value.store(seq, std::memory_order_release);
+    waiter.signal();
+}
+
+/**
+ * 申请一个序号，写入elem并发布.
+ *
+ * @param elem: 要发布的事件
+ */
+template<typename E, typename WaitStrategy>
+void RingBuffer<E, WaitStrategy>::push(E elem)
+{
+    long long seq = claim();
+    entries[seq & mask] = std::move(elem);
+    publish(seq);
+}
+
+/**
+ * 关闭缓冲区.
+ * 已发布的事件仍会被所有消费者处理.
+ */
+template<typename E, typename WaitStrategy>
+void RingBuffer<E, WaitStrategy>::close()
+{
+    is_closed.store(true, std::memory_order_release);
+    waiter.signal();
+}
+
+/**
+ * 返回最慢消费者的序号.
+ * 没有消费者时不限制生产者.
+ *
+ * @return 最慢消费者已处理的序号
+ */
+template<typename E, typename WaitStrategy>
+long long RingBuffer<E, WaitStrategy>::gate() const
+{
+    long long slowest = claimed;
+    for (auto& c : consumers)
+        slowest = std::min(slowest, c->cursor.value.load(std::memory_order_acquire));
+    return slowest;
+}
+
+/**
+ * 消费者构造函数.
+ *
+ * @param ring: 所属的环形缓冲区
+ *        depends_on: 被依赖的消费者
+ */
+template<typename E, typename WaitStrategy>
+RingBuffer<E, WaitStrategy>::Consumer::Consumer(RingBuffer& ring,
+                                                std::initializer_list<const Consumer*> depends_on)
+    : ring(ring)
+{
+    barrier.push_back(&ring.published);
+    for (auto c : depends_on)
+        barrier.push_back(&c->cursor);
+}
+
+/**
+ * 返回可以处理的最大序号，即生产者和所有被依赖消费者序号的最小值.
+ *
+ * @return 可以处理的最大序号
+ */
+template<typename E, typename WaitStrategy>
+long long RingBuffer<E, WaitStrategy>::Consumer::available() const
+{
+    long long seq = barrier[0]->value.load(std::memory_order_acquire);
+    for (size_t i = 1; i < barrier.size(); ++i)
+        seq = std::min(seq, barrier[i]->value.load(std::memory_order_acquire));
+    return seq;
+}
+
+/**
+ * 等待并批量处理可用事件.
+ * 对每个事件调用f(const E&)，处理完后只更新一次序号并通知等待者.
+ * 缓冲区关闭且所有被依赖者都已处理完时，不再等待.
+ *
+ * @param f: 事件处理函数
+ *        max: 最多处理的事件数量
+ * @return 处理的事件数量，缓冲区关闭且没有剩余事件时为0
+ */
+template<typename E, typename WaitStrategy>
+template<typename F>
+typename RingBuffer<E, WaitStrategy>::size_type
+RingBuffer<E, WaitStrategy>::Consumer::consume(F f, size_type max)
+{
+    long long next = cursor.value.load(std::memory_order_relaxed) + 1;
+    long long last = next - 1;
+
+    ring.waiter.wait([this, next, &last]
+    {
+        // 先读关闭标记，之后读到的序号包含关闭前发布的所有事件
+        bool done = ring.closed();
+        last = available();
+        return last >= next || (done && last == ring.cursor());
+    });
+    if (last < next)
+        return 0;
+    last = std::min(last, next + static_cast<long long>(std::min(max, ring.capacity())) - 1);
+    for (long long seq = next; seq <= last; ++seq)
+        f(static_cast<const RingBuffer&>(ring)[seq]);
+    cursor.value.store(last, std::memory_order_release);
+    ring.waiter.signal();
+    return last - next + 1;
+}
+
+} // namespace cpplib
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * RollbackUnionFind.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.21
+ ******************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpplib
+{
+
+/**
+ * 可撤销的并查集.
+ * 按秩合并且不压缩路径，每次合并只修改两个根结点，把修改前的值记入撤销日志，
+ * checkpoint()返回日志长度，rollback()按相反顺序恢复到该长度.
+ * 树高不超过O(log n)，find为O(log n)，撤销一次合并为O(1).
+ * 根结点保存-(秩+1)，与LinkByRank的编码相同.
+ */
+template<typename Index = int>
+class RollbackUnionFind
+{
+    static_assert(std::is_signed<Index>::value, "RollbackUnionFind: Index must be a signed integer type");
+public:
+    // 成员类型定义
+    using index_type = Index;
+
+    explicit RollbackUnionFind(Index size = 0);
+
+    // 判断p与q是否属于同一个连通分量
+    bool connected(Index p, Index q) const { return find(p) == find(q); }
+    // 返回连通分量数
+    Index count() const { return components; }
+    // 返回触点数
+    Index size() const { return Index(parent.size()); }
+    // 找到p所属连通分量的根触点
+    Index find(Index p) const;
+    // 合并p与q所属的连通分量，返回是否合并了两个不同的分量
+    bool join(Index p, Index q);
+    // 返回当前的撤销点
+    size_t checkpoint() const { return history.size(); }
+    // 撤销到指定的撤销点
+    void rollback(size_t point);
+private:
+    // 一次合并的撤销记录
+    struct Record
+    {
+        Index child;      // 被合并的根
+        Index child_rank; // 合并前被合并的根的值
+        Index root_rank;  // 合并前新根的值
+    };
+
+    Index components;             // 连通分量的数量
+    std::vector<Index> parent;    // parent[i]为i的父结点，根结点为负数
+    std::vector<Record> history;  // 撤销日志
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < size(); }
+};
+
+/**
+ * 构造函数，每个触点都是一个单独的连通分量.
+ *
+ * @param size: 并查集大小
+ */
+template<typename Index>
+RollbackUnionFind<Index>::RollbackUnionFind(Index size)
+    : components(size), parent(size, -1)
+{
+}
+
+/**
+ * 找到p所属连通分量的根触点.
+ * 不压缩路径，不修改并查集.
+ *
+ * @param p: 触点p
+ * @return 根触点
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+Index RollbackUnionFind<Index>::find(Index p) const
+{
+    if (!valid(p))
+        throw std::out_of_range("RollbackUnionFind::find() index out of range.");
+    while (parent[p] >= 0)
+        p = parent[p];
+    return p;
+}
+
+/**
+ * 合并p与q所属的连通分量.
+ * 秩小的根合并到秩大的根，撤销日志记录被合并的根和两个根原来的值.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @return true: 合并了两个不同的连通分量
+ *         false: p与q已经属于同一个连通分量
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename Index>
+bool RollbackUnionFind<Index>::join(Index p, Index q)
+{
+    Index rootP = find(p);
+    Index rootQ = find(q);
+
+    if (rootP == rootQ) return false;
+    if (parent[rootP] > parent[rootQ])
+        std::swap(rootP, rootQ);
+    history.push_back({ rootQ, parent[rootQ], parent[rootP] });
+    if (parent[rootP] == parent[rootQ])
+        parent[rootP]--; // 两棵树的秩相等，合并后秩加一
+    parent[rootQ] = rootP;
+    components--;
+    return true;
+}
+
+/**
+ * 撤销到指定的撤销点.
+ * 按相反顺序撤销之后的每次合并：被合并的根恢复为根，新根恢复原来的秩.
+ *
+ * @param point: checkpoint()返回的撤销点
+ * @throws std::out_of_range: 撤销点晚于当前状态
+ */
+template<typename Index>
+void RollbackUnionFind<Index>::rollback(size_t point)
+{
+    if (point > history.size())
+        throw std::out_of_range("RollbackUnionFind::rollback() checkpoint out of range.");
+    while (history.size() > point)
+    {
+        Record r = history.back();
+        history.pop_back();
+        parent[parent[r.child]] = r.root_rank;
+        parent[r.child] = r.child_rank;
+        components++;
+    }
+}
+
+} // namespace cpplib
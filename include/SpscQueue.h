@@ -0,0 +1,308 @@
+/*******************************************************************************
+ * SpscQueue.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.20
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cpplib
+{
+
+/**
+ * 有界单生产者单消费者队列.
+ * 元素保存在容量为2的幂的环形数组中，只有一个线程入队、一个线程出队，
+ * 因此入队和出队都不需要CAS，每个操作在有限步内完成（无等待）.
+ * 生产者缓存消费者的出队位置，消费者缓存生产者的入队位置，
+ * 只有缓存的位置显示队满或队空时才读取对方的位置，减少缓存行的来回传递.
+ * 批量操作只发布一次位置.
+ * enqueue、enqueue_bulk只能由生产者线程调用，
+ * front、dequeue、dequeue_bulk只能由消费者线程调用.
+ */
+template<typename E>
+class SpscQueue
+{
+    static constexpr size_t CACHE_LINE = 64; // 缓存行大小
+    static constexpr size_t DEFAULT_CAPACITY = 1024; // 默认容量
+
+    using Slot = typename std::aligned_storage<sizeof(E), alignof(E)>::type;
+public:
+    // 成员类型定义
+    using value_type      = E;
+    using reference       = E&;
+    using const_reference = const E&;
+    using size_type       = size_t;
+
+    explicit SpscQueue(size_type capacity = DEFAULT_CAPACITY);
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    ~SpscQueue();
+
+    // 判断队列是否为空，并发修改时只是近似值
+    bool empty() const { return size() == 0; }
+    // 返回队列元素的数量，并发修改时只是近似值
+    size_type size() const;
+    // 返回队列的容量
+    size_type capacity() const { return mask + 1; }
+
+    // 入队，队满时返回false
+    bool enqueue(const E& elem) { return push(elem); }
+    // 移动元素入队，队满时返回false且elem不被移动
+    bool enqueue(E&& elem) { return push(std::move(elem)); }
+    // 将[first, first + count)中尽可能多的元素入队，返回入队的数量
+    template<typename InputIterator>
+    size_type enqueue_bulk(InputIterator first, size_type count);
+    // 返回队首引用
+    reference front();
+    // 出队，队空时返回false
+    bool dequeue();
+    // 出队并移动队首元素到elem，队空时返回false
+    bool dequeue(E& elem);
+    // 将至多max个元素出队并移动到out，返回出队的数量
+    template<typename OutputIterator>
+    size_type dequeue_bulk(OutputIterator out, size_type max);
+private:
+    Slot* buffer; // 环形数组
+    size_t mask; // 容量 - 1，用于计算槽位下标
+    char pad0[CACHE_LINE];
+    std::atomic<size_t> tail; // 下一个入队位置，由生产者修改
+    size_t cached_head; // 生产者缓存的出队位置
+    char pad1[CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    std::atomic<size_t> head; // 下一个出队位置，由消费者修改
+    size_t cached_tail; // 消费者缓存的入队位置
+    char pad2[CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    // 返回位置pos处的元素
+    E* slot(size_t pos) { return reinterpret_cast<E*>(&buffer[pos & mask]); }
+    // 返回生产者可写的槽位数量，不足need时重新读取出队位置
+    size_t writable(size_t t, size_t need);
+    // 返回消费者可读的元素数量，不足need时重新读取入队位置
+    size_t readable(size_t h, size_t need);
+    // 入队
+    template<typename T>
+    bool push(T&& elem);
+};
+
+/**
+ * 构造函数.
+ * 容量向上取整为2的幂，至少为2.
+ *
+ * @param capacity: 队列容量
+ */
+template<typename E>
+SpscQueue<E>::SpscQueue(size_type capacity)
+{
+    size_t count = 2;
+    while (count < capacity)
+        count <<= 1;
+    buffer = new Slot[count];
+    mask = count - 1;
+    tail.store(0, std::memory_order_relaxed);
+    head.store(0, std::memory_order_relaxed);
+    cached_head = cached_tail = 0;
+}
+
+/**
+ * 析构函数.
+ * 析构时不能有其它线程访问队列.
+ */
+template<typename E>
+SpscQueue<E>::~SpscQueue()
+{
+    size_t end = tail.load(std::memory_order_relaxed);
+    for (size_t pos = head.load(std::memory_order_relaxed); pos != end; ++pos)
+        slot(pos)->~E();
+    delete[] buffer;
+}
+
+/**
+ * 返回队列元素的数量.
+ *
+ * @return 队列元素的数量
+ */
+template<typename E>
+typename SpscQueue<E>::size_type SpscQueue<E>::size() const
+{
+    size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_acquire);
+    return t > h ? t - h : 0;
+}
+
+/**
+ * 将[first, first + count)中尽可能多的元素入队.
+ * 所有元素构造完成后只发布一次入队位置.
+ * 构造某个元素时抛出异常，则销毁本批已构造的元素，队列不变.
+ *
+ * @param first: 指向第一个元素的迭代器
+ *        count: 元素数量
+ * @return 入队的元素数量
+ */
+template<typename E>
+template<typename InputIterator>
+typename SpscQueue<E>::size_type
+SpscQueue<E>::enqueue_bulk(InputIterator first, size_type count)
+{
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t n = std::min(count, writable(t, count));
+    size_t i = 0;
+
+    try
+    {
+        for (; i < n; ++i, ++first)
+            new (slot(t + i)) E(*first);
+    }
+    catch (...)
+    {
+        // 尚未发布的元素消费者不可见，直接销毁
+        while (i > 0)
+            slot(t + --i)->~E();
+        throw;
+    }
+    tail.store(t + n, std::memory_order_release);
+    return n;
+}
+
+/**
+ * 返回队首引用.
+ *
+ * @return 队首引用
+ * @throws std::out_of_range: 队空
+ */
+template<typename E>
+typename SpscQueue<E>::reference SpscQueue<E>::front()
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    if (readable(h, 1) == 0)
+        throw std::out_of_range("SpscQueue::front");
+    return *slot(h);
+}
+
+/**
+ * 出队，销毁队首元素.
+ *
+ * @return true: 出队成功
+ *         false: 队空
+ */
+template<typename E>
+bool SpscQueue<E>::dequeue()
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    if (readable(h, 1) == 0)
+        return false;
+    slot(h)->~E();
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * 出队并移动队首元素到elem.
+ *
+ * @param elem: 保存队首元素
+ * @return true: 出队成功
+ *         false: 队空
+ */
+template<typename E>
+bool SpscQueue<E>::dequeue(E& elem)
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    if (readable(h, 1) == 0)
+        return false;
+    elem = std::move(*slot(h));
+    slot(h)->~E();
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * 将至多max个元素出队并移动到out.
+ * 所有元素移出后只发布一次出队位置.
+ *
+ * @param out: 输出迭代器
+ *        max: 最多出队的元素数量
+ * @return 出队的元素数量
+ */
+template<typename E>
+template<typename OutputIterator>
+typename SpscQueue<E>::size_type
+SpscQueue<E>::dequeue_bulk(OutputIterator out, size_type max)
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t n = std::min(max, readable(h, max));
+
+    for (size_t i = 0; i < n; ++i, ++out)
+    {
+        *out = std::move(*slot(h + i));
+        slot(h + i)->~E();
+    }
+    head.store(h + n, std::memory_order_release);
+    return n;
+}
+
+/**
+ * 返回生产者可写的槽位数量.
+ * 先使用缓存的出队位置，不足need时才读取消费者的出队位置.
+ *
+ * @param t: 当前入队位置
+ *        need: 需要的槽位数量
+ * @return 可写的槽位数量
+ */
+template<typename E>
+size_t SpscQueue<E>::writable(size_t t, size_t need)
+{
+    size_t free = capacity() - (t - cached_head);
+    if (free < need)
+    {
+        cached_head = head.load(std::memory_order_acquire);
+        free = capacity() - (t - cached_head);
+    }
+    return free;
+}
+
+/**
+ * 返回消费者可读的元素数量.
+ * 先使用缓存的入队位置，不足need时才读取生产者的入队位置.
+ *
+ * @param h: 当前出队位置
+ *        need: 需要的元素数量
+ * @return 可读的元素数量
+ */
+template<typename E>
+size_t SpscQueue<E>::readable(size_t h, size_t need)
+{
+    size_t available = cached_tail - h;
+    if (available < need)
+    {
+        cached_tail = tail.load(std::memory_order_acquire);
+        available = cached_tail - h;
+    }
+    return available;
+}
+
+/**
+ * 入队.
+ *
+ * @param elem: 要添加的元素
+ * @return true: 入队成功
+ *         false: 队满
+ */
+template<typename E>
+template<typename T>
+bool SpscQueue<E>::push(T&& elem)
+{
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (writable(t, 1) == 0)
+        return false;
+    new (slot(t)) E(std::forward<T>(elem));
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace cpplib
@@ -11,8 +11,9 @@
 
 /**
  * 使用模板实现的后进先出栈.
+ * 容器为LockFreeStack时可以在多个线程间使用push和try_pop，见LockFreeStack.h中的ConcurrentStack.
  */
-template<typename E, typename Container = Deque<E>>
+template<typename E, typename Container = cpplib::Deque<E>>
 class Stack
 {
     template <typename T, typename C>
@@ -43,6 +44,8 @@ public:
     void push(E elem) { c.insert_back(std::move(elem)); }
     // 出栈函数
     void pop() { c.remove_back(); }
+    // 尝试出栈并移动栈顶元素到elem，栈空时返回false
+    bool try_pop(E& elem) { return c.try_remove_back(elem); }
     // 内容与另一个Stack对象交换
     void swap(Stack& that) { c.swap(that.c); }
     // 清空栈元素
@@ -21,6 +21,8 @@ public:
     
     // 产生毫秒精度的时间戳
     static size_t time_millis();
+    // 产生单调递增的毫秒精度时间戳，不受系统时间调整影响
+    static size_t monotonic_millis();
     // 开始计时
     void start() { time = time_millis(); } 
     // 重新计时
@@ -41,4 +43,17 @@ size_t Timer::time_millis()
     return std::chrono::duration_cast<millis>(system_clock::now().time_since_epoch()).count();
 }
 
+/**
+ * 产生单调递增的毫秒精度时间戳.
+ * 时间起点不确定，只能用于计算时间间隔或驱动定时器.
+ *
+ * @return 单调递增的毫秒精度时间戳
+ */
+inline size_t Timer::monotonic_millis()
+{
+    using millis = std::chrono::milliseconds;
+    using steady_clock = std::chrono::steady_clock;
+    return std::chrono::duration_cast<millis>(steady_clock::now().time_since_epoch()).count();
+}
+
 
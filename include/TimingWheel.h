@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * TimingWheel.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.2
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Timer.h"
+
+namespace cpplib
+{
+
+/**
+ * 分层时间轮定时器.
+ * 时间被划分为长度为tick毫秒的刻度，共LEVELS层，每层SLOTS个槽位，
+ * 第l层的一个槽位覆盖SLOTS^l个刻度.
+ * 定时器按到期刻度与当前刻度最高的不同位放入对应层，
+ * 时间前进到高层槽位的边界时，把该槽位的定时器重新放入低层（级联），
+ * 到达第0层的槽位时定时器到期.
+ * 添加和取消都是O(1)，推进时间的代价与经过的刻度数和到期的定时器数成正比.
+ * 定时器结点保存在数组中，取消或到期的结点进入空闲链表被复用，
+ * 槽位是结点下标组成的双向链表，添加定时器不单独分配内存.
+ * 定时器编号带有版本号，结点被复用后旧编号失效.
+ */
+template<typename T>
+class TimingWheel
+{
+    static constexpr int BITS = 6; // 每层槽位数的位数
+    static constexpr int SLOTS = 1 << BITS; // 每层的槽位数
+    static constexpr int LEVELS = 6; // 层数，可以覆盖2^36个刻度
+    static constexpr int NIL = -1; // 空链接
+
+    // 定时器结点
+    struct Node
+    {
+        T value; // 到期时交给回调的值
+        uint64_t expiry; // 到期刻度
+        int prev; // 槽位链表的前驱
+        int next; // 槽位链表的后继，空闲结点用于空闲链表
+        int bucket; // 所在槽位，空闲时为NIL
+        uint32_t version; // 结点被复用的次数
+    };
+public:
+    // 定时器编号，高32位为版本号，低32位为结点下标
+    using timer_id = uint64_t;
+
+    explicit TimingWheel(size_t tick = 1, size_t start = Timer::monotonic_millis());
+
+    // 返回未到期的定时器数量
+    size_t size() const { return n; }
+    // 判断是否没有未到期的定时器
+    bool empty() const { return n == 0; }
+    // 返回时间轮当前的时间（毫秒）
+    size_t now() const { return start + current * tick; }
+
+    // 添加delay毫秒后到期的定时器，返回定时器编号
+    timer_id schedule(size_t delay, T value);
+    // 取消定时器，定时器已到期或已取消时返回false
+    bool cancel(timer_id id);
+    // 推进时间到time毫秒，对每个到期的定时器调用on_expire(T&)，返回到期的数量
+    template<typename F>
+    size_t advance(size_t time, F on_expire);
+    // 推进时间到单调时钟的当前时间
+    template<typename F>
+    size_t advance(F on_expire) { return advance(Timer::monotonic_millis(), on_expire); }
+private:
+    size_t tick; // 刻度长度（毫秒）
+    size_t start; // 刻度0对应的时间（毫秒）
+    uint64_t current; // 当前刻度
+    size_t n; // 未到期的定时器数量
+    std::vector<Node> nodes; // 所有结点
+    int free_list; // 空闲结点链表
+    int heads[LEVELS * SLOTS]; // 每个槽位链表的头结点
+    uint64_t occupied[LEVELS]; // 每层非空槽位的位图
+
+    // 把结点放入到期刻度对应的槽位
+    void link(int i);
+    // 把结点从所在槽位移除
+    void unlink(int i);
+    // 把第level层当前槽位的定时器重新放入低层
+    void cascade(int level);
+    // 返回结点的定时器编号
+    timer_id id_of(int i) const { return uint64_t(nodes[i].version) << 32 | uint32_t(i); }
+};
+
+/**
+ * 构造函数.
+ *
+ * @param tick: 刻度长度（毫秒），至少为1
+ *        start: 起始时间（毫秒），默认为单调时钟的当前时间
+ */
+template<typename T>
+TimingWheel<T>::TimingWheel(size_t tick, size_t start)
+    : tick(tick > 0 ? tick : 1), start(start), current(0), n(0), free_list(NIL)
+{
+    for (auto& h : heads)
+        h = NIL;
+    for (auto& o : occupied)
+        o = 0;
+}
+
+/**
+ * 添加定时器.
+ * 延迟向上取整为刻度，至少一个刻度，即最早在下一个刻度到期.
+ *
+ * @param delay: 延迟（毫秒）
+ *        value: 到期时交给回调的值
+ * @return 定时器编号
+ */
+template<typename T>
+typename TimingWheel<T>::timer_id TimingWheel<T>::schedule(size_t delay, T value)
+{
+    int i;
+    if (free_list != NIL)
+    {
+        i = free_list;
+        free_list = nodes[i].next;
+        nodes[i].value = std::move(value);
+    }
+    else
+    {
+        i = int(nodes.size());
+        nodes.push_back(Node{ std::move(value), 0, NIL, NIL, NIL, 0 });
+    }
+    uint64_t ticks = delay / tick + (delay % tick != 0); // 先加tick - 1再除在delay接近上限时会溢出
+    nodes[i].expiry = current + (ticks > 0 ? ticks : 1);
+    link(i);
+    ++n;
+    return id_of(i);
+}
+
+/**
+ * 取消定时器.
+ *
+ * @param id: 定时器编号
+ * @return true: 取消成功
+ *         false: 定时器已到期、已取消或编号无效
+ */
+template<typename T>
+bool TimingWheel<T>::cancel(timer_id id)
+{
+    uint32_t i = uint32_t(id);
+    if (i >= nodes.size() || nodes[i].version != uint32_t(id >> 32) || nodes[i].bucket == NIL)
+        return false;
+    unlink(i);
+    nodes[i].version++;
+    nodes[i].next = free_list;
+    free_list = i;
+    --n;
+    return true;
+}
+
+/**
+ * 推进时间.
+ * 逐个刻度前进，经过高层槽位的边界时级联，再处理第0层当前槽位中到期的定时器.
+ * 低层没有定时器时直接跳到下一个需要级联的边界.
+ * 回调中可以添加和取消定时器，新添加的定时器最早在下一个刻度到期.
+ *
+ * @param time: 目标时间（毫秒），早于当前时间时不推进
+ *        on_expire: 到期回调，参数为定时器的值
+ * @return 到期的定时器数量
+ */
+template<typename T>
+template<typename F>
+size_t TimingWheel<T>::advance(size_t time, F on_expire)
+{
+    uint64_t target = time > start ? (time - start) / tick : 0;
+    size_t fired = 0;
+
+    while (current < target)
+    {
+        // 低层都为空时直接跳到最低的非空层的下一个槽位边界
+        if (occupied[0] == 0)
+        {
+            int level = 1;
+            while (level < LEVELS && occupied[level] == 0)
+                ++level;
+            uint64_t mask = level < LEVELS ? (uint64_t(1) << (BITS * level)) - 1 : ~uint64_t(0);
+            current = std::min(target - 1, current | mask);
+        }
+        ++current;
+        // 第0层回到槽位0时逐层级联，直到某层不在边界上
+        for (int level = 1; level < LEVELS; ++level)
+        {
+            if ((current >> (BITS * (level - 1))) & (SLOTS - 1))
+                break;
+            cascade(level);
+        }
+        int bucket = int(current & (SLOTS - 1));
+        while (heads[bucket] != NIL)
+        {
+            int i = heads[bucket];
+            unlink(i);
+            T value = std::move(nodes[i].value);
+            nodes[i].version++;
+            nodes[i].next = free_list;
+            free_list = i;
+            --n;
+            ++fired;
+            on_expire(value);
+        }
+    }
+    return fired;
+}
+
+/**
+ * 把结点放入到期刻度对应的槽位.
+ * 层号由到期刻度与当前刻度最高的不同位决定，超出范围的放入最高层，
+ * 之后每次级联重新计算.
+ *
+ * @param i: 结点下标
+ */
+template<typename T>
+void TimingWheel<T>::link(int i)
+{
+    Node& node = nodes[i];
+    uint64_t diff = node.expiry ^ current;
+    int level = 0;
+
+    while (level < LEVELS - 1 && (diff >> (BITS * (level + 1))) != 0)
+        ++level;
+    int slot = int((node.expiry >> (BITS * level)) & (SLOTS - 1));
+    int bucket = level * SLOTS + slot;
+
+    node.bucket = bucket;
+    node.prev = NIL;
+    node.next = heads[bucket];
+    if (heads[bucket] != NIL)
+        nodes[heads[bucket]].prev = i;
+    heads[bucket] = i;
+    occupied[level] |= uint64_t(1) << slot;
+}
+
+/**
+ * 把结点从所在槽位移除，槽位变空时清除位图.
+ *
+ * @param i: 结点下标
+ */
+template<typename T>
+void TimingWheel<T>::unlink(int i)
+{
+    Node& node = nodes[i];
+    int bucket = node.bucket;
+
+    if (node.prev != NIL)
+        nodes[node.prev].next = node.next;
+    else
+        heads[bucket] = node.next;
+    if (node.next != NIL)
+        nodes[node.next].prev = node.prev;
+    if (heads[bucket] == NIL)
+        occupied[bucket / SLOTS] &= ~(uint64_t(1) << (bucket % SLOTS));
+    node.bucket = NIL;
+}
+
+/**
+ * 把第level层当前槽位的定时器重新放入低层.
+ * 先摘下整个槽位链表再逐个放入，超出范围的定时器可能回到同一槽位.
+ *
+ * @param level: 层号
+ */
+template<typename T>
+void TimingWheel<T>::cascade(int level)
+{
+    int slot = int((current >> (BITS * level)) & (SLOTS - 1));
+    int bucket = level * SLOTS + slot;
+    int i = heads[bucket];
+
+    heads[bucket] = NIL;
+    occupied[level] &= ~(uint64_t(1) << slot);
+    while (i != NIL)
+    {
+        int next = nodes[i].next;
+        link(i);
+        i = next;
+    }
+}
+
+} // namespace cpplib
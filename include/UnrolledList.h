@@ -0,0 +1,628 @@
+/*******************************************************************************
+ * UnrolledList.h
+ *
+ * Author: zhangyu
+ * Date: 2017.7.5
+ ******************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cpplib
+{
+
+// 根据元素大小确定结点可存储元素个数，使结点约为256字节（4个缓存行）
+static constexpr size_t unrolled_size(size_t size)
+{ return size < 32 ? 256 / size : 8; }
+
+/**
+ * 使用模板实现的展开链表.
+ * 每个结点存储一个小数组，遍历时每个结点只需追踪一次指针，
+ * 前驱和后继指针的开销由结点内所有元素分摊.
+ * 结点满时对半分裂，结点元素少于N/4时与相邻结点合并.
+ * 实现了展开链表的双向迭代器.
+ * 添加和移除元素会使指向同一结点以及被合并结点的迭代器失效.
+ */
+template<typename E, size_t N = unrolled_size(sizeof(E))>
+class UnrolledList
+{
+    static_assert(N >= 4, "UnrolledList node capacity must be at least 4");
+
+    static constexpr size_t SPLIT_SIZE = N / 2; // 分裂后前一个结点保留的元素数
+    static constexpr size_t MERGE_SIZE = N / 4; // 低于该元素数时尝试合并结点
+
+    struct Node
+    {
+        typename std::aligned_storage<sizeof(E), alignof(E)>::type data[N];
+        size_t count;
+        Node* prev;
+        Node* next;
+        Node() : count(0), prev(this), next(this) {}
+
+        E* elems() { return reinterpret_cast<E*>(data); }
+    };
+public:
+    UnrolledList() : n(0), sentinel(new Node) {}
+    UnrolledList(const UnrolledList& that);
+    UnrolledList(UnrolledList&& that) noexcept;
+    ~UnrolledList();
+
+    class iterator;
+
+    // 返回链表元素的数量
+    int size() const { return n; }
+    // 判断是否为空链表
+    bool empty() const { return n == 0; }
+    // 添加元素到指定位置，返回指向新元素的迭代器
+    iterator insert(iterator pos, E elem);
+    // 添加元素到链表头部
+    void insert_front(E elem);
+    // 添加元素到链表尾部
+    void insert_back(E elem);
+    // 移除指定位置的元素，返回指向后继元素的迭代器
+    iterator remove(iterator pos);
+    // 移除链表头部元素
+    void remove_front();
+    // 移除链表尾部元素
+    void remove_back();
+    // 将另一个链表的所有元素移动到指定位置之前
+    void splice(iterator pos, UnrolledList& that);
+    // 返回链表头部元素的引用
+    E& front() { return const_cast<E&>(static_cast<const UnrolledList&>(*this).front()); }
+    // 返回链表头部元素的const引用
+    const E& front() const;
+    // 返回链表尾部元素的引用
+    E& back() { return const_cast<E&>(static_cast<const UnrolledList&>(*this).back()); }
+    // 返回链表尾部元素的const引用
+    const E& back() const;
+    // 内容与另一个UnrolledList对象交换
+    void swap(UnrolledList& that);
+    // 清空链表
+    void clear();
+
+    UnrolledList& operator=(UnrolledList that);
+    UnrolledList& operator+=(const UnrolledList& that);
+
+    // 展开链表不支持随机访问
+    class iterator : public std::iterator<std::bidirectional_iterator_tag, E>
+    {
+        friend class UnrolledList;
+    private:
+        Node* pn;     // 当前结点
+        size_t index; // 当前元素在结点中的位置
+    public:
+        iterator() : pn(nullptr), index(0) {}
+        iterator(Node* x, size_t i) : pn(x), index(i) {}
+
+        E& operator*() const
+        { return pn->elems()[index]; }
+        E* operator->() const
+        { return pn->elems() + index; }
+        iterator& operator++()
+        {
+            // 到达结点尾部则跳到下一个结点头部
+            if (++index == pn->count)
+            {
+                pn = pn->next;
+                index = 0;
+            }
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        iterator& operator--()
+        {
+            // 位于结点头部则跳到上一个结点尾部
+            if (index == 0)
+            {
+                pn = pn->prev;
+                index = pn->count;
+            }
+            --index;
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator tmp(*this);
+            --*this;
+            return tmp;
+        }
+        bool operator==(const iterator& that) const
+        { return pn == that.pn && index == that.index; }
+        bool operator!=(const iterator& that) const
+        { return !(*this == that); }
+    };
+    iterator begin() const { return iterator(sentinel->next, 0); }
+    iterator end() const { return iterator(sentinel, 0); }
+private:
+    int n; // 链表大小
+    Node* sentinel; // 哨兵结点，不存储元素
+
+    // 在结点x之后链接一个新的空结点
+    Node* link_after(Node* x);
+    // 断开并释放空结点x
+    void unlink(Node* x);
+    // 将结点x从位置i起的元素分裂到新的后继结点
+    Node* split(Node* x, size_t i);
+    // 将结点y的元素合并到其前驱结点x
+    void merge(Node* x, Node* y);
+};
+
+/**
+ * 展开链表复制构造函数.
+ * 复制另一个展开链表作为这个链表的初始化.
+ *
+ * @param that: 被复制的展开链表
+ */
+template<typename E, size_t N>
+UnrolledList<E, N>::UnrolledList(const UnrolledList& that)
+{
+    n = 0;
+    sentinel = new Node();
+    for (auto& i : that)
+        insert_back(i);
+}
+
+/**
+ * 展开链表移动构造函数.
+ * 移动另一个展开链表，其资源所有权转移到新创建的对象.
+ *
+ * @param that: 被移动的展开链表
+ */
+template<typename E, size_t N>
+UnrolledList<E, N>::UnrolledList(UnrolledList&& that) noexcept
+{
+    n = that.n;
+    sentinel = that.sentinel;
+    that.n = 0;
+    that.sentinel = nullptr; // 指向空指针，退出被析构
+}
+
+/**
+ * 展开链表析构函数.
+ */
+template<typename E, size_t N>
+UnrolledList<E, N>::~UnrolledList()
+{
+    if (sentinel == nullptr) return;
+    clear();
+    delete sentinel;
+    sentinel = nullptr;
+}
+
+/**
+ * 添加元素到链表指定位置.
+ * 所在结点满时先对半分裂结点.
+ *
+ * @param pos: 指向添加位置的迭代器，元素添加到pos之前
+ *        elem: 要添加的元素
+ * @return 指向新添加元素的迭代器
+ */
+template<typename E, size_t N>
+typename UnrolledList<E, N>::iterator UnrolledList<E, N>::insert(iterator pos, E elem)
+{
+    Node* x = pos.pn;
+    size_t i = pos.index;
+
+    // 添加到结点头部时优先追加到前驱结点尾部，避免移动元素
+    if (i == 0 && x->prev != sentinel && x->prev->count < N)
+    {
+        x = x->prev;
+        i = x->count;
+    }
+    // 添加到尾部且最后一个结点已满，或链表为空
+    else if (x == sentinel)
+        x = link_after(sentinel->prev);
+    else if (x->count == N)
+    {
+        Node* y = split(x, SPLIT_SIZE);
+        if (i > SPLIT_SIZE)
+        {
+            x = y;
+            i -= SPLIT_SIZE;
+        }
+    }
+    E* elems = x->elems();
+    // 结点内位置i之后的元素后移一个位置
+    if (i == x->count)
+        ::new (static_cast<void*>(elems + i)) E(std::move(elem));
+    else
+    {
+        ::new (static_cast<void*>(elems + x->count)) E(std::move(elems[x->count - 1]));
+        std::move_backward(elems + i, elems + x->count - 1, elems + x->count);
+        elems[i] = std::move(elem);
+    }
+    x->count++;
+    n++;
+    return iterator(x, i);
+}
+
+/**
+ * 添加元素到链表头部.
+ *
+ * @param elem: 要添加的元素
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::insert_front(E elem)
+{
+    // 头部结点满时在头部链接新结点，而不是分裂
+    if (sentinel->next->count == N)
+        link_after(sentinel);
+    insert(begin(), std::move(elem));
+}
+
+/**
+ * 添加元素到链表尾部.
+ *
+ * @param elem: 要添加的元素
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::insert_back(E elem)
+{
+    Node* x = sentinel->prev;
+
+    if (x == sentinel || x->count == N)
+        x = link_after(x);
+    ::new (static_cast<void*>(x->elems() + x->count)) E(std::move(elem));
+    x->count++;
+    n++;
+}
+
+/**
+ * 移除链表中指定位置的元素.
+ * 结点为空时释放结点，元素少于N/4时尝试与相邻结点合并.
+ *
+ * @param pos: 指向要移除元素的迭代器
+ * @return 指向被移除元素后继的迭代器
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E, size_t N>
+typename UnrolledList<E, N>::iterator UnrolledList<E, N>::remove(iterator pos)
+{
+    if (empty() || pos.pn == sentinel)
+        throw std::out_of_range("UnrolledList::remove");
+
+    Node* x = pos.pn;
+    size_t i = pos.index;
+    E* elems = x->elems();
+
+    // 结点内位置i之后的元素前移一个位置
+    std::move(elems + i + 1, elems + x->count, elems + i);
+    elems[--x->count].~E();
+    n--;
+    if (x->count == 0)
+    {
+        Node* next = x->next;
+        unlink(x);
+        return iterator(next, 0);
+    }
+    if (x->count < MERGE_SIZE)
+    {
+        Node* next = x->next;
+        Node* prev = x->prev;
+        if (next != sentinel && x->count + next->count <= N)
+            merge(x, next);
+        else if (prev != sentinel && prev->count + x->count <= N)
+        {
+            i += prev->count;
+            merge(prev, x);
+            x = prev;
+        }
+    }
+    return i == x->count ? iterator(x->next, 0) : iterator(x, i);
+}
+
+/**
+ * 移除链表头部元素.
+ *
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::remove_front()
+{
+    if (empty())
+        throw std::out_of_range("UnrolledList::remove_front");
+    remove(begin());
+}
+
+/**
+ * 移除链表尾部元素.
+ * 只需析构尾部结点的最后一个元素，不需要移动元素.
+ *
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::remove_back()
+{
+    if (empty())
+        throw std::out_of_range("UnrolledList::remove_back");
+
+    Node* x = sentinel->prev;
+
+    x->elems()[--x->count].~E();
+    n--;
+    if (x->count == 0)
+        unlink(x);
+}
+
+/**
+ * 将另一个链表的所有元素移动到指定位置之前.
+ * 只重新链接结点，不复制元素；pos位于结点中间时先分裂该结点.
+ *
+ * @param pos: 指向插入位置的迭代器
+ *        that: 被移动的链表，移动后为空
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::splice(iterator pos, UnrolledList& that)
+{
+    if (&that == this || that.empty()) return;
+
+    Node* succ = pos.index == 0 ? pos.pn : split(pos.pn, pos.index);
+    Node* prec = succ->prev;
+    Node* first = that.sentinel->next;
+    Node* last = that.sentinel->prev;
+
+    prec->next = first;
+    first->prev = prec;
+    last->next = succ;
+    succ->prev = last;
+    n += that.n;
+    that.sentinel->next = that.sentinel;
+    that.sentinel->prev = that.sentinel;
+    that.n = 0;
+}
+
+/**
+ * 返回链表头部元素的const引用.
+ *
+ * @return 链表头部元素的const引用
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E, size_t N>
+const E& UnrolledList<E, N>::front() const
+{
+    if (empty())
+        throw std::out_of_range("UnrolledList::front");
+    return *begin();
+}
+
+/**
+ * 返回链表尾部元素的const引用.
+ *
+ * @return 链表尾部元素的const引用
+ * @throws std::out_of_range: 链表为空
+ */
+template<typename E, size_t N>
+const E& UnrolledList<E, N>::back() const
+{
+    if (empty())
+        throw std::out_of_range("UnrolledList::back");
+    return *std::prev(end());
+}
+
+/**
+ * 交换当前UnrolledList对象和另一个UnrolledList对象.
+ *
+ * @param that: UnrolledList对象that
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::swap(UnrolledList& that)
+{
+    using std::swap;
+    swap(n, that.n);
+    swap(sentinel, that.sentinel);
+}
+
+/**
+ * 清空该链表元素.
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::clear()
+{
+    Node* current = sentinel->next;
+    // 析构每个结点的元素并释放结点内存
+    while (current != sentinel)
+    {
+        Node* next = current->next;
+        for (size_t i = 0; i < current->count; ++i)
+            current->elems()[i].~E();
+        delete current;
+        current = next;
+    }
+    sentinel->next = sentinel;
+    sentinel->prev = sentinel;
+    n = 0;
+}
+
+/**
+ * =操作符重载.
+ * 让当前UnrolledList对象等于给定UnrolledList对象that.
+ *
+ * @param that: UnrolledList对象that
+ * @return 当前UnrolledList对象
+ */
+template<typename E, size_t N>
+UnrolledList<E, N>& UnrolledList<E, N>::operator=(UnrolledList that)
+{
+    swap(that);
+    return *this;
+}
+
+/**
+ * +=操作符重载.
+ * 复制另一个对象所有元素,添加到当前对象.
+ *
+ * @param that: UnrolledList对象that
+ * @return 当前UnrolledList对象
+ */
+template<typename E, size_t N>
+UnrolledList<E, N>& UnrolledList<E, N>::operator+=(const UnrolledList& that)
+{
+    int count = that.n; // that可能就是*this，只复制原有的元素
+    auto it = that.begin();
+
+    while (count-- > 0)
+        insert_back(*it++);
+    return *this;
+}
+
+/**
+ * 在结点x之后链接一个新的空结点.
+ *
+ * @param x: 前驱结点
+ * @return 新结点
+ */
+template<typename E, size_t N>
+typename UnrolledList<E, N>::Node* UnrolledList<E, N>::link_after(Node* x)
+{
+    Node* y = new Node();
+
+    y->prev = x;
+    y->next = x->next;
+    x->next->prev = y;
+    x->next = y;
+    return y;
+}
+
+/**
+ * 断开并释放空结点x.
+ *
+ * @param x: 已不含元素的结点
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::unlink(Node* x)
+{
+    x->prev->next = x->next;
+    x->next->prev = x->prev;
+    delete x;
+}
+
+/**
+ * 将结点x从位置i起的元素移动到新的后继结点.
+ *
+ * @param x: 被分裂的结点
+ *        i: 分裂位置
+ * @return 新的后继结点
+ */
+template<typename E, size_t N>
+typename UnrolledList<E, N>::Node* UnrolledList<E, N>::split(Node* x, size_t i)
+{
+    Node* y = link_after(x);
+    E* from = x->elems();
+    E* to = y->elems();
+
+    for (size_t j = i; j < x->count; ++j)
+    {
+        ::new (static_cast<void*>(to + j - i)) E(std::move(from[j]));
+        from[j].~E();
+    }
+    y->count = x->count - i;
+    x->count = i;
+    return y;
+}
+
+/**
+ * 将结点y的元素合并到其前驱结点x，并释放结点y.
+ *
+ * @param x: 前驱结点
+ *        y: 被合并的结点
+ */
+template<typename E, size_t N>
+void UnrolledList<E, N>::merge(Node* x, Node* y)
+{
+    E* from = y->elems();
+    E* to = x->elems() + x->count;
+
+    for (size_t j = 0; j < y->count; ++j)
+    {
+        ::new (static_cast<void*>(to + j)) E(std::move(from[j]));
+        from[j].~E();
+    }
+    x->count += y->count;
+    y->count = 0;
+    unlink(y);
+}
+
+/**
+ * +操作符重载.
+ * 返回一个包含lhs和rhs所有元素的对象.
+ *
+ * @param lhs: UnrolledList对象lhs
+ *        rhs: UnrolledList对象rhs
+ * @return 包含lhs和rhs所有元素的UnrolledList对象
+ */
+template<typename E, size_t N>
+UnrolledList<E, N> operator+(UnrolledList<E, N> lhs, const UnrolledList<E, N>& rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+/**
+ * ==操作符重载函数，比较两个UnrolledList对象是否相等.
+ *
+ * @param lhs: UnrolledList对象lhs
+ *        rhs: UnrolledList对象rhs
+ * @return true: 相等
+ *         false: 不等
+ */
+template<typename E, size_t N>
+bool operator==(const UnrolledList<E, N>& lhs, const UnrolledList<E, N>& rhs)
+{
+    if (&lhs == &rhs)             return true;
+    if (lhs.size() != rhs.size()) return false;
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+/**
+ * !=操作符重载函数，比较两个UnrolledList对象是否不等.
+ *
+ * @param lhs: UnrolledList对象lhs
+ *        rhs: UnrolledList对象rhs
+ * @return true: 不等
+ *         false: 相等
+ */
+template<typename E, size_t N>
+bool operator!=(const UnrolledList<E, N>& lhs, const UnrolledList<E, N>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+/**
+ * <<操作符重载函数，打印所有链表元素.
+ *
+ * @param os: 输出流对象
+ *        list: 要输出的链表
+ * @return 输出流对象
+ */
+template<typename E, size_t N>
+std::ostream& operator<<(std::ostream& os, const UnrolledList<E, N>& list)
+{
+    for (auto& i : list)
+        os << i << " ";
+    return os;
+}
+
+/**
+ * 交换两个UnrolledList对象.
+ *
+ * @param lhs: UnrolledList对象lhs
+ *        rhs: UnrolledList对象rhs
+ */
+template<typename E, size_t N>
+void swap(UnrolledList<E, N>& lhs, UnrolledList<E, N>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace cpplib
@@ -156,13 +156,15 @@ void Vector<E>::reserve(int count)
  * 添加元素到Vector指定位置.
  * 当Vector达到最大容量，扩容Vector到两倍容量后，再添加元素.
  *
- * @param i: 要添加元素的索引
+ * @param pos: 指向添加位置的迭代器，元素添加到pos之前
  *        elem: 要添加的元素
  * @throws std::out_of_range: 索引不合法
  */
 template<typename E>
 void Vector<E>::insert(iterator pos, E elem)
 {
+    int i = pos - begin();
+
     if (i == n)
         insert_back(elem);
     else if (!valid(i))
@@ -196,12 +198,14 @@ void Vector<E>::insert_back(E elem)
  * 移除Vector中指定位置的元素.
  * 当Vector达到1/4容量，缩小Vector容量.
  *
- * @param i: 要移除元素的索引
+ * @param pos: 指向要移除元素的迭代器
  * @throws std::out_of_range: 索引不合法
  */
 template<typename E>
 void Vector<E>::remove(iterator pos)
 {
+    int i = pos - begin();
+
     if (i == n - 1)
         return remove_back();
     if (!valid(i))
@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * WeightedDisjointSets.h
+ *
+ * Author: zhangyu
+ * Date: 2017.8.24
+ ******************************************************************************/
+
+#pragma once
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "DisjointSets.h"
+
+namespace cpplib
+{
+
+/**
+ * 允许误差的偏移比较.
+ * 两个偏移之差不超过eps时视为相等，用于double等会累积舍入误差的偏移.
+ */
+template<typename G>
+struct Tolerance
+{
+    G eps; // 允许的误差
+
+    explicit Tolerance(G eps = G(1e-9)) : eps(eps) {}
+    bool operator()(const G& a, const G& b) const { return a - b <= eps && b - a <= eps; }
+};
+
+/**
+ * 带权并查集，维护形如value(p) - value(q) = d的相对偏移约束.
+ * 每个结点保存相对父结点的偏移offset[i] = value(i) - value(parent[i])，
+ * 查找时压缩策略一并更新偏移，合并时由两端相对各自根的偏移算出两根之间的偏移.
+ * 偏移属于交换群G，需要支持+、-，G()为单位元，如long long或double.
+ * 约束是否与已知偏移一致由Equal判断，默认为==，只适合long long等精确的偏移；
+ * double的偏移经过多次加减会产生舍入误差，应使用Tolerance<double>.
+ * 同一连通分量中与已知偏移矛盾的约束不改变并查集，只计入违反次数.
+ * 合并策略可以是按秩、按大小或按随机下标，LinkRelabel会改写非根结点，不能使用.
+ */
+template<typename G, typename Index = int, typename LinkPolicy = LinkByRank,
+         typename CompressPolicy = CompressHalving, typename Equal = std::equal_to<G>>
+class WeightedDisjointSets
+{
+    static_assert(std::is_signed<Index>::value, "WeightedDisjointSets: Index must be a signed integer type");
+    static_assert(!std::is_same<LinkPolicy, LinkRelabel>::value, "WeightedDisjointSets: LinkRelabel is not supported");
+public:
+    // 成员类型定义
+    using value_type = G;
+    using index_type = Index;
+
+    // 约束的处理结果
+    enum class Result
+    {
+        merged,     // 合并了两个连通分量
+        consistent, // 已在同一连通分量中且与已知偏移一致
+        violated    // 已在同一连通分量中且与已知偏移矛盾
+    };
+
+    explicit WeightedDisjointSets(Index size = 0, Equal equal = Equal());
+
+    // 判断p与q是否属于同一个连通分量
+    bool connected(Index p, Index q) { return find(p) == find(q); }
+    // 返回连通分量数
+    Index count() const { return components; }
+    // 返回触点数
+    Index size() const { return Index(parent.size()); }
+    // 返回矛盾约束的数量
+    size_t violations() const { return violated; }
+    // 找到p所属连通分量的根触点
+    Index find(Index p);
+    // 加入约束value(p) - value(q) = d
+    Result join(Index p, Index q, const G& d);
+    // 返回value(p) - value(q)
+    G diff(Index p, Index q);
+private:
+    Index components;          // 连通分量的数量
+    std::vector<Index> parent; // parent[i]为i的父结点，根结点为负数
+    std::vector<G> offset;     // offset[i]为i相对父结点的偏移，根结点为单位元
+    size_t violated;           // 矛盾约束的数量
+    Equal equal;               // 判断两个偏移是否一致
+
+    // 检查触点p是否合法
+    bool valid(Index p) const { return p >= 0 && p < size(); }
+    // 找到p的根并求出p相对根的偏移
+    Index find(Index p, G& potential);
+};
+
+/**
+ * 构造函数，每个触点都是一个单独的连通分量.
+ *
+ * @param size: 并查集大小
+ *        equal: 判断两个偏移是否一致
+ */
+template<typename G, typename Index, typename LinkPolicy, typename CompressPolicy, typename Equal>
+WeightedDisjointSets<G, Index, LinkPolicy, CompressPolicy, Equal>::WeightedDisjointSets(Index size, Equal equal)
+    : components(size), parent(size, -1), offset(size, G()), violated(0), equal(equal)
+{
+}
+
+/**
+ * 找到p所属连通分量的根触点.
+ *
+ * @param p: 触点p
+ * @return 根触点
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename G, typename Index, typename LinkPolicy, typename CompressPolicy, typename Equal>
+Index WeightedDisjointSets<G, Index, LinkPolicy, CompressPolicy, Equal>::find(Index p)
+{
+    if (!valid(p))
+        throw std::out_of_range("WeightedDisjointSets::find() index out of range.");
+    G potential;
+    return find(p, potential);
+}
+
+/**
+ * 找到p的根并求出p相对根的偏移.
+ *
+ * @param p: 触点p
+ *        potential: 返回value(p) - value(根)
+ * @return 根触点
+ */
+template<typename G, typename Index, typename LinkPolicy, typename CompressPolicy, typename Equal>
+Index WeightedDisjointSets<G, Index, LinkPolicy, CompressPolicy, Equal>::find(Index p, G& potential)
+{
+    return CompressPolicy::find(parent.data(), offset.data(), p, potential);
+}
+
+/**
+ * 加入约束value(p) - value(q) = d.
+ * 两端在不同连通分量中时合并，被合并的根相对新根的偏移由约束推出；
+ * 在同一连通分量中时检查约束是否与已知偏移一致.
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ *        d: 偏移
+ * @return 约束的处理结果
+ * @throws std::out_of_range: 触点不合法
+ */
+template<typename G, typename Index, typename LinkPolicy, typename CompressPolicy, typename Equal>
+typename WeightedDisjointSets<G, Index, LinkPolicy, CompressPolicy, Equal>::Result
+WeightedDisjointSets<G, Index, LinkPolicy, CompressPolicy, Equal>::join(Index p, Index q, const G& d)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("WeightedDisjointSets::join() index out of range.");
+    G potentialP, potentialQ;
+    Index rootP = find(p, potentialP);
+    Index rootQ = find(q, potentialQ);
+
+    if (rootP == rootQ)
+    {
+        if (equal(potentialP - potentialQ, d))
+            return Result::consistent;
+        violated++;
+        return Result::violated;
+    }
+    // value(rootQ) - value(rootP) = potentialP - potentialQ - d
+    if (LinkPolicy::link(parent.data(), size(), rootP, rootQ) == rootP)
+        offset[rootQ] = potentialP - potentialQ - d;
+    else
+        offset[rootP] = d - potentialP + potentialQ;
+    components--;
+    return Result::merged;
+}
+
+/**
+ * 返回value(p) - value(q).
+ *
+ * @param p: 触点p
+ *        q: 触点q
+ * @return p与q之间的偏移
+ * @throws std::out_of_range: 触点不合法
+ *         std::invalid_argument: p与q不属于同一个连通分量
+ */
+template<typename G, typename Index, typename LinkPolicy, typename CompressPolicy, typename Equal>
+G WeightedDisjointSets<G, Index, LinkPolicy, CompressPolicy, Equal>::diff(Index p, Index q)
+{
+    if (!valid(p) || !valid(q))
+        throw std::out_of_range("WeightedDisjointSets::diff() index out of range.");
+    G potentialP, potentialQ;
+    if (find(p, potentialP) != find(q, potentialQ))
+        throw std::invalid_argument("WeightedDisjointSets::diff() sites are not connected.");
+    return potentialP - potentialQ;
+}
+
+} // namespace cpplib
@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * Compilation:  g++ -IBlockingQueue -IDeque -ITimer BlockingQueue.cpp -o demo -pthread
+ * Execution:    ./demo
+ * Dependencies: BlockingQueue.h Deque.h
+ *               Timer.h
+ *
+ * A producer/consumer benchmark of the blocking queue.
+ * Producers enqueue 2000000 integers in total into a queue of capacity 1024
+ * and consumers take them one by one or in batches of 64.
+ * The baseline is a textbook queue that notifies a condition variable on
+ * every operation and parks at once; BlockingQueue spins briefly first and
+ * notifies only when a thread is actually parked.
+ * The counters show how often threads parked and the average wait per
+ * park. The sample output below was measured on a single core machine,
+ * where spinning rarely helps and every park costs a context switch, so
+ * Single is only on par with Naive there. Batch dequeue pays off whenever
+ * the consumers are outnumbered: it frees many slots per lock and parks
+ * far less often with 4 producers.
+ *
+ * % ./demo
+ * Throughput (million elements per second) and parks (wait in microseconds):
+ * P/C   Naive     Single    Batch     parks   wait      parks   wait
+ * 1/1   10.87     11.17     9.756     4198    43.62     30231   6.748
+ * 1/4   4.193     4.032     5.195     59465   32.33     54036   28.12
+ * 4/1   3.527     3.759     18.02     62419   33.16     4145    105.6
+ * 4/4   10.58     8.13      11.17     4349    358.7     5394    216.7
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BlockingQueue.h"
+#include "Deque.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+const int ITEMS = 2000000; // 传递的元素总数
+const size_t CAPACITY = 1024; // 队列容量
+const size_t BATCH = 64; // 批量出队的元素数量
+
+static atomic<long long> sink; // 防止出队结果被优化掉
+
+/**
+ * 每次操作都通知条件变量的阻塞队列，作为比较的基准.
+ */
+class NaiveQueue
+{
+public:
+    void enqueue(int elem)
+    {
+        unique_lock<mutex> lock(m);
+        not_full.wait(lock, [this] { return q.size() < CAPACITY; });
+        q.insert_back(elem);
+        not_empty.notify_one();
+    }
+    bool dequeue(int& elem)
+    {
+        unique_lock<mutex> lock(m);
+        not_empty.wait(lock, [this] { return !q.empty() || done; });
+        if (q.empty()) return false;
+        elem = q.front();
+        q.remove_front();
+        not_full.notify_one();
+        return true;
+    }
+    void close()
+    {
+        lock_guard<mutex> lock(m);
+        done = true;
+        not_empty.notify_all();
+    }
+private:
+    Deque<int> q;
+    bool done = false;
+    mutex m;
+    condition_variable not_empty;
+    condition_variable not_full;
+};
+
+/**
+ * 使用p个生产者和c个消费者传递ITEMS个元素，返回每秒传递的元素数（百万个）.
+ *
+ * @param queue: 队列
+ *        p: 生产者数量
+ *        c: 消费者数量
+ *        consume: 消费者的出队循环
+ * @return 吞吐量
+ */
+template<typename Q, typename Consume>
+double transfer(Q& queue, int p, int c, Consume consume)
+{
+    vector<thread> producers;
+    vector<thread> consumers;
+    Timer timer;
+
+    timer.start();
+    for (int i = 0; i < c; ++i)
+        consumers.emplace_back([&queue, &consume] { sink += consume(queue); });
+    for (int i = 0; i < p; ++i)
+    {
+        producers.emplace_back([&queue, p]
+        {
+            for (int k = ITEMS / p; k > 0; --k)
+                queue.enqueue(k);
+        });
+    }
+    for (auto& t : producers)
+        t.join();
+    queue.close();
+    for (auto& t : consumers)
+        t.join();
+    return ITEMS / std::max(timer.elapsed(), 0.001) / 1e6;
+}
+
+// 逐个出队直到队列关闭
+template<typename Q>
+long long consume_single(Q& queue)
+{
+    long long sum = 0;
+    int elem;
+    while (queue.dequeue(elem))
+        sum += elem;
+    return sum;
+}
+
+// 批量出队直到队列关闭且为空
+long long consume_batch(BlockingQueue<int>& queue)
+{
+    long long sum = 0;
+    vector<int> batch(BATCH);
+    while (!queue.closed() || !queue.empty())
+    {
+        size_t n = queue.dequeue_batch(batch.begin(), BATCH, chrono::milliseconds(10));
+        for (size_t i = 0; i < n; ++i)
+            sum += batch[i];
+    }
+    return sum;
+}
+
+/**
+ * 打印一组生产者和消费者数量下的吞吐量和等待统计.
+ *
+ * @param p: 生产者数量
+ *        c: 消费者数量
+ */
+void test(int p, int c)
+{
+    NaiveQueue naive;
+    BlockingQueue<int> single(CAPACITY);
+    BlockingQueue<int> batch(CAPACITY);
+    string name = to_string(p) + "/" + to_string(c);
+
+    cout << std::left << setw(6) << name << setprecision(4)
+         << setw(10) << transfer(naive, p, c, consume_single<NaiveQueue>)
+         << setw(10) << transfer(single, p, c, consume_single<BlockingQueue<int>>)
+         << setw(10) << transfer(batch, p, c, consume_batch);
+    for (auto q : { &single, &batch })
+    {
+        auto stats = q->counters();
+        double avg = stats.parks == 0 ? 0 : stats.wait_ns / 1e3 / stats.parks;
+        cout << setw(8) << stats.parks << setw(10) << avg;
+    }
+    cout << endl;
+}
+
+int main()
+{
+    cout << "Throughput (million elements per second) and parks (wait in microseconds):" << endl;
+    cout << std::left << setw(6) << "P/C" << setw(10) << "Naive" << setw(10) << "Single"
+         << setw(10) << "Batch" << setw(8) << "parks" << setw(10) << "wait"
+         << setw(8) << "parks" << setw(10) << "wait" << endl;
+    test(1, 1);
+    test(1, 4);
+    test(4, 1);
+    test(4, 4);
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * Compilation:  g++ -IDynamicConnectivity -IUnionFind -ITimer demo.cpp -o demo
+ * Execution:    ./demo
+ * Dependencies: DynamicConnectivity.h  RollbackUnionFind.h  UnionFind.h
+ *               Timer.h
+ *
+ * Offline dynamic connectivity on random operation streams. Each stream has
+ * n = ops / 10 sites; 40% of the operations add a random edge, 30% remove a
+ * random live edge and 30% ask whether two random sites are connected. The
+ * baseline keeps a UnionFind while edges are only added and rebuilds it
+ * from the live edges at the first query after a removal, so it pays O(m)
+ * per query; it stops at 100000 operations. DynamicConnectivity hangs each
+ * edge on the segment tree over query times and walks it with
+ * RollbackUnionFind, O(log q log n) per edge. Both answers are compared.
+ * Measured on a single core machine.
+ *
+ * % ./demo
+ * Random dynamic connectivity streams (seconds):
+ * Ops         Queries     Rebuild     Offline     us/op       Answers
+ * 100000      30023       1.054       0.033       0.33        match
+ * 1000000     300602      -           0.412       0.412       -
+ * 10000000    2999258     -           6.082       0.6082      -
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <utility>
+#include <vector>
+#include "DynamicConnectivity.h"
+#include "Timer.h"
+#include "UnionFind.h"
+
+using namespace std;
+using namespace cpplib;
+
+const int REBUILD_LIMIT = 100000; // 重建对照的最大操作数
+
+// 一次操作
+struct Operation
+{
+    int type; // 0加边，1删边，2查询
+    int p, q; // 两端
+};
+
+/**
+ * 生成随机操作序列.
+ *
+ * @param ops: 操作数
+ *        n: 触点数
+ * @return 操作序列
+ */
+vector<Operation> generate(int ops, int n)
+{
+    vector<Operation> stream;
+    vector<pair<int, int>> live;
+    mt19937 gen(2017);
+
+    stream.reserve(ops);
+    for (int i = 0; i < ops; ++i)
+    {
+        int r = gen() % 10;
+        if (r < 3 && !live.empty())
+        {
+            size_t k = gen() % live.size();
+            std::swap(live[k], live.back());
+            stream.push_back({ 1, live.back().first, live.back().second });
+            live.pop_back();
+        }
+        else if (r < 7)
+        {
+            int p = gen() % n, q = gen() % n;
+            live.emplace_back(p, q);
+            stream.push_back({ 0, p, q });
+        }
+        else
+            stream.push_back({ 2, int(gen() % n), int(gen() % n) });
+    }
+    return stream;
+}
+
+/**
+ * 删边后在下一次查询时重建UnionFind.
+ *
+ * @param stream: 操作序列
+ *        n: 触点数
+ *        answers: 查询的答案
+ * @return 运行时间
+ */
+double rebuild(const vector<Operation>& stream, int n, vector<int>& answers)
+{
+    Timer timer;
+    vector<pair<int, int>> live;
+    UnionFind uf(n);
+    bool dirty = false;
+
+    for (const Operation& op : stream)
+    {
+        if (op.type == 0)
+        {
+            live.emplace_back(op.p, op.q);
+            uf.join(op.p, op.q);
+        }
+        else if (op.type == 1)
+        {
+            auto it = std::find(live.begin(), live.end(), make_pair(op.p, op.q));
+            *it = live.back();
+            live.pop_back();
+            dirty = true;
+        }
+        else
+        {
+            if (dirty)
+            {
+                uf = UnionFind(n);
+                for (auto& e : live)
+                    uf.join(e.first, e.second);
+                dirty = false;
+            }
+            answers.push_back(uf.connected(op.p, op.q));
+        }
+    }
+    return std::max(timer.elapsed(), 0.001);
+}
+
+/**
+ * 用DynamicConnectivity离线回答.
+ *
+ * @param stream: 操作序列
+ *        n: 触点数
+ *        answers: 查询的答案
+ * @return 运行时间
+ */
+double offline(const vector<Operation>& stream, int n, vector<int>& answers)
+{
+    Timer timer;
+    DynamicConnectivity<int> dc(n);
+
+    for (const Operation& op : stream)
+    {
+        if (op.type == 0)
+            dc.add_edge(op.p, op.q);
+        else if (op.type == 1)
+            dc.remove_edge(op.p, op.q);
+        else
+            dc.query_connected(op.p, op.q);
+    }
+    answers = dc.solve();
+    return std::max(timer.elapsed(), 0.001);
+}
+
+int main()
+{
+    cout << "Random dynamic connectivity streams (seconds): " << endl;
+    cout << std::left << setprecision(4);
+    cout << setw(12) << "Ops" << setw(12) << "Queries" << setw(12) << "Rebuild" << setw(12) << "Offline"
+         << setw(12) << "us/op" << "Answers" << endl;
+    for (int ops = 100000; ops <= 10000000; ops *= 10)
+    {
+        int n = ops / 10;
+        vector<Operation> stream = generate(ops, n);
+        vector<int> expected, answers;
+        double time = offline(stream, n, answers);
+        cout << setw(12) << ops << setw(12) << answers.size();
+        if (ops <= REBUILD_LIMIT)
+            cout << setw(12) << rebuild(stream, n, expected);
+        else
+            cout << setw(12) << "-";
+        cout << setw(12) << time << setw(12) << time * 1e6 / ops;
+        if (ops <= REBUILD_LIMIT)
+            cout << (expected == answers ? "match" : "MISMATCH") << endl;
+        else
+            cout << "-" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Compilation:  g++ -IIndexedList -IList -IRandom -ITimer IndexedList.cpp -o demo
+ * Execution:    ./demo
+ * Dependencies: IndexedList.h List.h
+ *               Random.h      Timer.h
+ *
+ * A benchmark of positional access on IndexedList against List.
+ * List walks from the nearer end to the position like List::locate().
+ * Each test runs 1000 random at(), insert_at() and erase_at() operations.
+ *
+ * % ./demo
+ * Running time of 1000 positional operations in doubling test:
+ * LIST\SCALE    62500    125000   250000   500000   1000000  ratio\lg ratio
+ * List          0.103    0.196    0.392    0.842    1.665    1.895\0.922
+ * IndexedList   0.0014   0.00146  0.00246  0.00308  0.00382  1.209\0.274
+ ******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "IndexedList.h"
+#include "List.h"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+static const int OPERATIONS = 1000; // 每次测试的操作次数
+static volatile long long sink;     // 防止访问结果被优化掉
+
+/**
+ * 定位链表指定位置的元素，从较近的一端开始遍历，与List::locate()相同.
+ *
+ * @param list: 链表
+ *        i: 元素的位置，可以等于size()
+ * @return 指向该位置的迭代器
+ */
+List<int>::iterator locate(const List<int>& list, int i)
+{
+    if (i < (list.size() >> 1)) return std::next(list.begin(), i);
+    else                        return std::prev(list.end(), list.size() - i);
+}
+
+/**
+ * 对含n个元素的List进行随机位置的访问、添加和移除.
+ *
+ * @param n: 元素数量
+ * @return 运行时间
+ */
+double time_list(int n)
+{
+    Timer timer;
+    List<int> list;
+    long long sum = 0;
+
+    for (int i = 0; i < n; ++i)
+        list.insert_back(i);
+    timer.start();
+    for (int i = 0; i < OPERATIONS; ++i)
+    {
+        sum += *locate(list, Random::random(list.size()));
+        list.insert(locate(list, Random::random(list.size() + 1)), i);
+        list.remove(locate(list, Random::random(list.size())));
+    }
+    sink = sum;
+    return timer.elapsed();
+}
+
+/**
+ * 对含n个元素的IndexedList进行随机位置的访问、添加和移除.
+ *
+ * @param n: 元素数量
+ * @return 运行时间
+ */
+double time_indexed(int n)
+{
+    Timer timer;
+    IndexedList<int> list;
+    long long sum = 0;
+
+    for (int i = 0; i < n; ++i)
+        list.insert_back(i);
+    timer.start();
+    // 操作次数较少时计时器精度不足，这里重复100倍再折算
+    for (int i = 0; i < OPERATIONS * 100; ++i)
+    {
+        sum += list.at(Random::random(list.size()));
+        list.insert_at(Random::random(list.size() + 1), i);
+        list.erase_at(Random::random(list.size()));
+    }
+    sink = sum;
+    return timer.elapsed() / 100;
+}
+
+/**
+ * 对指定测试函数进行倍率测试，打印运行时间和增长倍率.
+ *
+ * @param name: 测试的名称
+ *        test: 测试函数
+ */
+void doubling_test(const string& name, double (*test)(int))
+{
+    double ratio = 0.0;
+    double lastTime = 0.0;
+    double currTime;
+
+    cout << std::left << setw(14) << name;
+    for (int i = 62500; i <= 1000000; i *= 2)
+    {
+        currTime = test(i);
+        cout << setw(9) << setprecision(4) << currTime;
+        if (lastTime != 0.0)
+            ratio = (currTime / lastTime + ratio) / 2;
+        lastTime = currTime;
+    }
+    cout << setw(5) << setprecision(4) << ratio << "\\"
+         << setw(5) << setprecision(3) << log2(ratio) << endl;
+}
+
+int main()
+{
+    cout << "Running time of 1000 positional operations in doubling test: " << endl;
+    cout << std::left << setw(14) << "LIST\\SCALE";
+    for (int i = 62500; i <= 1000000; i *= 2)
+        cout << std::left << setw(9) << i;
+    cout << "ratio\\lg ratio" << endl;
+    doubling_test("List", time_list);
+    doubling_test("IndexedList", time_indexed);
+    return 0;
+}
@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * Compilation:  g++ -IList -INodePool -IRandom -ITimer ListSplice.cpp -o demo
+ * Execution:    ./demo
+ * Dependencies: List.h   NodePool.h
+ *               Random.h Timer.h
+ *
+ * A benchmark of the relinking operations of List.
+ * Appending, merging and sorting by copying elements into new nodes are
+ * compared with operator+=(List&&), merge() and sort(), which only relink
+ * the existing nodes.
+ * The relinking operations allocate no nodes; the single allocation of
+ * splice and merge records the shared chunks of the other node pool.
+ * For small elements such as int, sorting a copy in an array is still
+ * faster than relinking, since it follows no pointers; sort() pays off
+ * when elements are expensive to copy or when node identity matters.
+ *
+ * % ./demo
+ * Running time of append in doubling test:
+ * LIST\SCALE    50000  100000 200000 400000 800000 1600000ratio\lg ratio
+ * copy          0.001  0.001  0.002  0.005  0.01   0.021  2.019\1.01
+ * splice        0      0      0      0      0      0      0    \-inf
+ * Running time of merge in doubling test:
+ * LIST\SCALE    50000  100000 200000 400000 800000 1600000ratio\lg ratio
+ * copy          0.002  0.003  0.006  0.012  0.031  0.054  1.939\0.955
+ * merge         0      0      0.001  0.001  0.004  0.008  2.125\1.09
+ * Running time of sort in doubling test:
+ * LIST\SCALE    50000  100000 200000 400000 800000 1600000ratio\lg ratio
+ * copy          0.004  0.009  0.018  0.041  0.091  0.187  2.062\1.04
+ * sort          0.005  0.013  0.034  0.107  0.321  0.752  2.559\1.36
+ * Allocations of operations on lists of 1600000 elements:
+ * append copy   2
+ * append splice 1
+ * merge copy    119
+ * merge         1
+ * sort copy     2
+ * sort          0
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <string>
+#include <vector>
+#include "List.h"
+#include "NodePool.h"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+using IntList = List<int>;
+using Operation = void (*)(IntList&, IntList&);
+
+static size_t allocations = 0; // operator new的调用次数
+
+void* operator new(size_t size)
+{
+    allocations++;
+    if (void* p = malloc(size))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+// 复制b的元素添加到a的尾部
+void append_copy(IntList& a, IntList& b) { a += b; }
+// 将b的结点拼接到a的尾部
+void append_move(IntList& a, IntList& b) { a += std::move(b); }
+
+// 将有序链表a和b合并到新链表，再替换a
+void merge_copy(IntList& a, IntList& b)
+{
+    IntList result;
+    auto p = a.begin();
+    auto q = b.begin();
+
+    while (p != a.end() && q != b.end())
+        result.insert_back(*q < *p ? *q++ : *p++);
+    while (p != a.end())
+        result.insert_back(*p++);
+    while (q != b.end())
+        result.insert_back(*q++);
+    a = std::move(result);
+    b.clear();
+}
+
+// 将有序链表b的结点合并到a
+void merge_relink(IntList& a, IntList& b) { a.merge(b); }
+
+// 将a的元素复制到数组中排序，再重建链表
+void sort_copy(IntList& a, IntList&)
+{
+    vector<int> v(a.begin(), a.end());
+
+    stable_sort(v.begin(), v.end());
+    a.clear();
+    for (auto i : v)
+        a.insert_back(i);
+}
+
+// 重新链接a的结点完成排序
+void sort_relink(IntList& a, IntList&) { a.sort(); }
+
+/**
+ * 构建两个各含n个元素的链表.
+ *
+ * @param a: 链表a
+ *        b: 链表b
+ *        n: 元素数量
+ *        sorted: 是否构建有序链表，否则元素随机
+ */
+void prepare(IntList& a, IntList& b, int n, bool sorted)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        a.insert_back(sorted ? 2 * i : Random::random(n));
+        b.insert_back(sorted ? 2 * i + 1 : Random::random(n));
+    }
+}
+
+/**
+ * 对两个各含n个元素的链表执行操作Op.
+ *
+ * @param n: 元素数量
+ * @return 运行时间
+ */
+template<Operation Op, bool Sorted>
+double time_operation(int n)
+{
+    Timer timer;
+    IntList a;
+    IntList b;
+
+    prepare(a, b, n, Sorted);
+    timer.start();
+    Op(a, b);
+    return timer.elapsed();
+}
+
+/**
+ * 统计对两个各含n个元素的链表执行操作Op时operator new的调用次数.
+ *
+ * @param n: 元素数量
+ * @return operator new的调用次数
+ */
+template<Operation Op, bool Sorted>
+size_t count_operation(int n)
+{
+    IntList a;
+    IntList b;
+
+    prepare(a, b, n, Sorted);
+    size_t before = allocations;
+    Op(a, b);
+    return allocations - before;
+}
+
+/**
+ * 对指定测试函数进行倍率测试，打印运行时间和增长倍率.
+ *
+ * @param name: 测试的名称
+ *        test: 测试函数
+ */
+void doubling_test(const string& name, double (*test)(int))
+{
+    double ratio = 0.0;
+    double lastTime = 0.0;
+    double currTime;
+
+    cout << std::left << setw(14) << name;
+    for (int i = 50000; i < 2000000; i *= 2)
+    {
+        currTime = test(i);
+        cout << setw(7) << setprecision(5) << currTime;
+        if (lastTime != 0.0)
+            ratio = (currTime / lastTime + ratio) / 2;
+        lastTime = currTime;
+    }
+    cout << setw(5) << setprecision(4) << ratio << "\\"
+         << setw(5) << setprecision(3) << log2(ratio) << endl;
+}
+
+/**
+ * 打印倍率测试的表头.
+ *
+ * @param title: 测试的标题
+ */
+void print_header(const string& title)
+{
+    cout << "Running time of " << title << " in doubling test: " << endl;
+    cout << std::left << setw(14) << "LIST\\SCALE";
+    for (int i = 50000; i < 2000000; i *= 2)
+        cout << std::left << setw(7) << i;
+    cout << "ratio\\lg ratio" << endl;
+}
+
+int main()
+{
+    const int n = 1600000;
+
+    print_header("append");
+    doubling_test("copy", time_operation<append_copy, false>);
+    doubling_test("splice", time_operation<append_move, false>);
+
+    print_header("merge");
+    doubling_test("copy", time_operation<merge_copy, true>);
+    doubling_test("merge", time_operation<merge_relink, true>);
+
+    print_header("sort");
+    doubling_test("copy", time_operation<sort_copy, false>);
+    doubling_test("sort", time_operation<sort_relink, false>);
+
+    cout << "Allocations of operations on lists of " << n << " elements: " << endl;
+    cout << std::left << setw(14) << "append copy" << count_operation<append_copy, false>(n) << endl;
+    cout << std::left << setw(14) << "append splice" << count_operation<append_move, false>(n) << endl;
+    cout << std::left << setw(14) << "merge copy" << count_operation<merge_copy, true>(n) << endl;
+    cout << std::left << setw(14) << "merge" << count_operation<merge_relink, true>(n) << endl;
+    cout << std::left << setw(14) << "sort copy" << count_operation<sort_copy, false>(n) << endl;
+    cout << std::left << setw(14) << "sort" << count_operation<sort_relink, false>(n) << endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * Compilation:  g++ -IList -IMpmcQueue -IQueue -ITimer MpmcQueue.cpp -o demo -pthread
+ * Execution:    ./demo
+ * Dependencies: List.h  MpmcQueue.h
+ *               Queue.h Timer.h
+ *
+ * A throughput benchmark of the bounded MPMC queue.
+ * P producers enqueue 1000000 integers in total while C consumers dequeue
+ * them. ConcurrentQueue is compared with a Queue protected by a mutex.
+ * The sample output below was measured on a single core machine.
+ *
+ * % ./demo
+ * Throughput (million elements per second) with producers/consumers:
+ * QUEUE\P/C         1/1     2/2     4/4     7/1     1/7
+ * Mutex+Queue       14.49   16.39   16.39   14.49   16.95
+ * ConcurrentQueue   24.39   25      21.74   22.73   21.74
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "List.h"
+#include "MpmcQueue.h"
+#include "Queue.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+const int ITEMS = 1000000; // 所有生产者入队的元素总数
+
+static atomic<long long> sink; // 防止出队结果被优化掉
+
+/**
+ * 使用互斥锁保护的Queue，作为比较的基准.
+ * Deque尚未完成，这里使用List作为Queue的容器.
+ */
+class MutexQueue
+{
+public:
+    bool try_enqueue(int elem)
+    {
+        lock_guard<mutex> lock(m);
+        queue.enqueue(elem);
+        return true;
+    }
+    bool try_dequeue(int& elem)
+    {
+        lock_guard<mutex> lock(m);
+        if (queue.empty()) return false;
+        elem = queue.front();
+        queue.dequeue();
+        return true;
+    }
+private:
+    Queue<int, List<int>> queue;
+    mutex m;
+};
+
+/**
+ * 使用p个生产者和c个消费者传递ITEMS个元素，返回每秒传递的元素数（百万个）.
+ *
+ * @param p: 生产者数量
+ *        c: 消费者数量
+ * @return 吞吐量
+ */
+template<typename Q>
+double throughput(int p, int c)
+{
+    Q queue;
+    vector<thread> workers;
+    atomic<int> consumed(0);
+    Timer timer;
+
+    timer.start();
+    for (int i = 0; i < p; ++i)
+    {
+        workers.emplace_back([&queue, i, p]
+        {
+            for (int k = i; k < ITEMS; k += p)
+                while (!queue.try_enqueue(k))
+                    this_thread::yield();
+        });
+    }
+    for (int i = 0; i < c; ++i)
+    {
+        workers.emplace_back([&queue, &consumed]
+        {
+            long long sum = 0;
+            int elem;
+            while (consumed.load(memory_order_relaxed) < ITEMS)
+            {
+                if (queue.try_dequeue(elem))
+                {
+                    sum += elem;
+                    consumed.fetch_add(1, memory_order_relaxed);
+                }
+                else
+                    this_thread::yield();
+            }
+            sink += sum;
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    double elapsed = std::max(timer.elapsed(), 0.001);
+    return ITEMS / elapsed / 1e6;
+}
+
+int main()
+{
+    vector<pair<int, int>> configs;
+    int max_threads = std::max(8u, thread::hardware_concurrency());
+
+    for (int t = 1; t <= max_threads / 2; t *= 2)
+        configs.emplace_back(t, t);
+    configs.emplace_back(max_threads - 1, 1);
+    configs.emplace_back(1, max_threads - 1);
+
+    cout << "Throughput (million elements per second) with producers/consumers: " << endl;
+    cout << std::left << setw(18) << "QUEUE\\P/C";
+    for (auto& pc : configs)
+        cout << setw(8) << to_string(pc.first) + "/" + to_string(pc.second);
+    cout << endl;
+    cout << std::left << setw(18) << "Mutex+Queue";
+    for (auto& pc : configs)
+        cout << setw(8) << setprecision(4) << throughput<MutexQueue>(pc.first, pc.second);
+    cout << endl;
+    cout << std::left << setw(18) << "ConcurrentQueue";
+    for (auto& pc : configs)
+        cout << setw(8) << setprecision(4) << throughput<ConcurrentQueue<int>>(pc.first, pc.second);
+    cout << endl;
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*******************************************************************************
+ * Compilation:  g++ -IList -INodePool -IRandom -ITimer NodePool.cpp -o demo
+ * Execution:    ./demo
+ * Dependencies: List.h   NodePool.h
+ *               Random.h Timer.h
+ *
+ * A benchmark of the list node pool.
+ * NewPool allocates each node with new/delete, NodePool allocates nodes
+ * in chunks and recycles them through a free list.
+ *
+ * % ./demo
+ * Running time of list churn in doubling test:
+ * LIST\SCALE    50000  100000 200000 400000 800000 1600000ratio\lg ratio
+ * NewPool       0.005  0.007  0.013  0.031  0.062  0.115  1.885\0.915
+ * NodePool      0.002  0.003  0.006  0.014  0.029  0.06   1.975\0.982
+ * Running time of list traversal in doubling test:
+ * LIST\SCALE    50000  100000 200000 400000 800000 1600000ratio\lg ratio
+ * NewPool       0.002  0.008  0.025  0.067  0.293  0.602  2.776\1.47
+ * NodePool      0.001  0.002  0.005  0.009  0.018  0.065  2.749\1.46
+ * Allocations of copying a list of 1600000 elements:
+ * NewPool       1600000
+ * NodePool      4
+ ******************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <string>
+#include "List.h"
+#include "NodePool.h"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+using NewList  = List<int, NewPool<ListNode<int>>>;
+using PoolList = List<int, NodePool<ListNode<int>>>;
+
+static size_t allocations = 0; // operator new的调用次数
+static volatile long long sink;  // 防止遍历结果被优化掉
+
+void* operator new(size_t size)
+{
+    allocations++;
+    if (void* p = malloc(size))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+/**
+ * 插入n个元素后随机在两端插入和移除元素n次.
+ *
+ * @param n: 元素数量
+ * @return 运行时间
+ */
+template<typename L>
+double time_churn(int n)
+{
+    Timer timer;
+    L list;
+
+    timer.start();
+    for (int i = 0; i < n; ++i)
+        list.insert_back(i);
+    for (int i = 0; i < n; ++i)
+    {
+        switch (Random::random(4))
+        {
+        case 0: list.insert_front(i); break;
+        case 1: list.insert_back(i); break;
+        case 2: list.remove_front(); break;
+        default: list.remove_back(); break;
+        }
+    }
+    list.clear();
+    return timer.elapsed();
+}
+
+/**
+ * 交替构建两个各含n个元素的链表，然后遍历其中一个链表10次.
+ * 交替分配模拟了堆上其它分配打乱结点地址的情况.
+ *
+ * @param n: 元素数量
+ * @return 遍历时间
+ */
+template<typename L>
+double time_traverse(int n)
+{
+    Timer timer;
+    L list;
+    L other;
+    long long sum = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        list.insert_back(i);
+        other.insert_back(i);
+    }
+    timer.start();
+    for (int round = 0; round < 10; ++round)
+        for (auto i : list)
+            sum += i;
+    double elapsed = timer.elapsed();
+    sink = sum;
+    return elapsed;
+}
+
+/**
+ * 对指定测试函数进行倍率测试，打印运行时间和增长倍率.
+ *
+ * @param name: 测试的名称
+ *        test: 测试函数
+ */
+void doubling_test(const string& name, double (*test)(int))
+{
+    double ratio = 0.0;
+    double lastTime = 0.0;
+    double currTime;
+
+    cout << std::left << setw(14) << name;
+    for (int i = 50000; i < 2000000; i *= 2)
+    {
+        currTime = test(i);
+        cout << setw(7) << setprecision(5) << currTime;
+        if (lastTime != 0.0)
+            ratio = (currTime / lastTime + ratio) / 2;
+        lastTime = currTime;
+    }
+    cout << setw(5) << setprecision(4) << ratio << "\\"
+         << setw(5) << setprecision(3) << log2(ratio) << endl;
+}
+
+/**
+ * 打印倍率测试的表头.
+ *
+ * @param title: 测试的标题
+ */
+void print_header(const string& title)
+{
+    cout << "Running time of " << title << " in doubling test: " << endl;
+    cout << std::left << setw(14) << "LIST\\SCALE";
+    for (int i = 50000; i < 2000000; i *= 2)
+        cout << std::left << setw(7) << i;
+    cout << "ratio\\lg ratio" << endl;
+}
+
+/**
+ * 统计复制含n个元素链表时operator new的调用次数.
+ *
+ * @param n: 元素数量
+ * @return operator new的调用次数
+ */
+template<typename L>
+size_t count_copy(int n)
+{
+    L list;
+
+    for (int i = 0; i < n; ++i)
+        list.insert_back(i);
+    size_t before = allocations;
+    L copy(list);
+    return allocations - before - 1; // 不计哨兵结点
+}
+
+int main()
+{
+    print_header("list churn");
+    doubling_test("NewPool", time_churn<NewList>);
+    doubling_test("NodePool", time_churn<PoolList>);
+
+    print_header("list traversal");
+    doubling_test("NewPool", time_traverse<NewList>);
+    doubling_test("NodePool", time_traverse<PoolList>);
+
+    cout << "Allocations of copying a list of 1600000 elements: " << endl;
+    cout << std::left << setw(14) << "NewPool" << count_copy<NewList>(1600000) << endl;
+    cout << std::left << setw(14) << "NodePool" << count_copy<PoolList>(1600000) << endl;
+    return 0;
+}
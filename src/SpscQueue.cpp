@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Compilation:  g++ -IMpmcQueue -ISpscQueue -ITimer SpscQueue.cpp -o demo -pthread
+ * Execution:    ./demo
+ * Dependencies: MpmcQueue.h SpscQueue.h
+ *               Timer.h
+ *
+ * A cross-thread benchmark of the SPSC queue against the MPMC queue.
+ * Throughput: one producer passes 10000000 integers to one consumer,
+ * element by element or in batches of 64.
+ * Latency: two threads bounce a token through a pair of queues, and the
+ * average round trip time is reported.
+ * Threads are not pinned; on a single core machine, as in the sample
+ * output below, every empty or full queue costs a context switch, so the
+ * latency mostly measures the scheduler and varies from run to run.
+ *
+ * % ./demo
+ * Throughput of 10000000 elements (million per second):
+ * MpmcQueue         30.67
+ * SpscQueue         263.2
+ * SpscQueue bulk    344.8
+ * Average round trip latency (microseconds):
+ * MpmcQueue         1.13
+ * SpscQueue         1.51
+ ******************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MpmcQueue.h"
+#include "SpscQueue.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+const int ITEMS = 10000000; // 吞吐量测试传递的元素数量
+const int ROUND_TRIPS = 100000; // 延迟测试的往返次数
+const size_t BATCH = 64; // 批量操作的元素数量
+
+static volatile long long sink; // 防止出队结果被优化掉
+
+// 统一单个元素入队和出队的接口
+bool put(SpscQueue<int>& q, int elem) { return q.enqueue(elem); }
+bool get(SpscQueue<int>& q, int& elem) { return q.dequeue(elem); }
+bool put(MpmcQueue<int>& q, int elem) { return q.try_insert_back(elem); }
+bool get(MpmcQueue<int>& q, int& elem) { return q.try_remove_front(elem); }
+
+/**
+ * 逐个传递ITEMS个元素，返回每秒传递的元素数（百万个）.
+ *
+ * @return 吞吐量
+ */
+template<typename Q>
+double single_throughput()
+{
+    Q queue(1024);
+    Timer timer;
+    long long sum = 0;
+
+    timer.start();
+    thread producer([&queue]
+    {
+        for (int i = 0; i < ITEMS; ++i)
+            while (!put(queue, i))
+                this_thread::yield();
+    });
+    int elem;
+    for (int i = 0; i < ITEMS; ++i)
+    {
+        while (!get(queue, elem))
+            this_thread::yield();
+        sum += elem;
+    }
+    producer.join();
+    sink = sum;
+    return ITEMS / std::max(timer.elapsed(), 0.001) / 1e6;
+}
+
+/**
+ * 批量传递ITEMS个元素，返回每秒传递的元素数（百万个）.
+ *
+ * @return 吞吐量
+ */
+double bulk_throughput()
+{
+    SpscQueue<int> queue(1024);
+    Timer timer;
+    long long sum = 0;
+
+    timer.start();
+    thread producer([&queue]
+    {
+        vector<int> batch(BATCH);
+        for (int i = 0; i < ITEMS; )
+        {
+            size_t n = std::min(BATCH, size_t(ITEMS - i));
+            for (size_t k = 0; k < n; ++k)
+                batch[k] = i + k;
+            size_t done = queue.enqueue_bulk(batch.begin(), n);
+            while (done < n)
+            {
+                this_thread::yield();
+                done += queue.enqueue_bulk(batch.begin() + done, n - done);
+            }
+            i += n;
+        }
+    });
+    vector<int> batch(BATCH);
+    for (int i = 0; i < ITEMS; )
+    {
+        size_t n = queue.dequeue_bulk(batch.begin(), BATCH);
+        if (n == 0)
+            this_thread::yield();
+        for (size_t k = 0; k < n; ++k)
+            sum += batch[k];
+        i += n;
+    }
+    producer.join();
+    sink = sum;
+    return ITEMS / std::max(timer.elapsed(), 0.001) / 1e6;
+}
+
+/**
+ * 两个线程通过一对队列来回传递ROUND_TRIPS次，返回平均往返时间（微秒）.
+ *
+ * @return 平均往返时间
+ */
+template<typename Q>
+double round_trip()
+{
+    Q ping(16);
+    Q pong(16);
+    Timer timer;
+
+    timer.start();
+    thread echo([&ping, &pong]
+    {
+        int elem;
+        for (int i = 0; i < ROUND_TRIPS; ++i)
+        {
+            while (!get(ping, elem))
+                this_thread::yield();
+            put(pong, elem);
+        }
+    });
+    int elem;
+    for (int i = 0; i < ROUND_TRIPS; ++i)
+    {
+        put(ping, i);
+        while (!get(pong, elem))
+            this_thread::yield();
+    }
+    echo.join();
+    return timer.elapsed() * 1e6 / ROUND_TRIPS;
+}
+
+int main()
+{
+    cout << "Throughput of " << ITEMS << " elements (million per second): " << endl;
+    cout << std::left << setw(18) << "MpmcQueue" << setprecision(4) << single_throughput<MpmcQueue<int>>() << endl;
+    cout << std::left << setw(18) << "SpscQueue" << setprecision(4) << single_throughput<SpscQueue<int>>() << endl;
+    cout << std::left << setw(18) << "SpscQueue bulk" << setprecision(4) << bulk_throughput() << endl;
+
+    cout << "Average round trip latency (microseconds): " << endl;
+    cout << std::left << setw(18) << "MpmcQueue" << setprecision(4) << round_trip<MpmcQueue<int>>() << endl;
+    cout << std::left << setw(18) << "SpscQueue" << setprecision(4) << round_trip<SpscQueue<int>>() << endl;
+    return 0;
+}
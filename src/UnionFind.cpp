@@ -1,21 +1,55 @@
 /*******************************************************************************
  * Compilation:  g++ -IRandom -ITimer -IUnionFind demo.cpp -o demo
  * Execution:    ./demo
- * Dependencies: QuickFind.h  QuickUnion.h 
- *               UnionFind.h  WeightedUnion.h 
+ * Dependencies: DisjointSets.h  QuickFind.h  QuickUnion.h
+ *               UnionFind.h  WeightedUnion.h
+ *
+ * Doubling test of every link and compression policy of DisjointSets,
+ * joining random pairs until one component is left. The four classic
+ * classes are aliases of DisjointSets; QuickUnion and QuickFind stop
+ * doubling once a run takes longer than 2 seconds.
+ *
+ * The export test joins 0.45n random pairs of a million sites and lists the
+ * members of the 100 largest components, once by scanning every site per
+ * component and once by walking the member ring, then labels all sites
+ * with find per site and with flatten(), which also makes the labels dense.
  *
  * % ./demo
  * Running time of union-find in doubling test:
- * UF\SCALE      1000   2000   4000   8000   16000  32000  64000  ratio\lg ratio
- * UnionFind     0.001  0.001  0.003  0.01   0.018  0.04   0.057  1.811\0.857
- * WeightedUnion 0.001  0.001  0.004  0.009  0.017  0.044  0.089  2.176\1.12
- * QuickUnion    0.004  0.013  0.076  0.468  1.516  10.8   47.933 5.023\2.33
- * QuickFind     0.004  0.013  0.063  0.22   0.866  3.494  14.106 3.94 \1.98
+ * UF\SCALE                  1000   2000   4000   8000   16000  32000  64000  128000 256000 512000 ratio\lg ratio
+ * Rank/Full                 0      0.001  0      0.001  0.003  0.005  0.01   0.02   0.046  0.105  2.19 \1.13
+ * Rank/Halving              0      0      0      0.002  0.002  0.005  0.01   0.02   0.05   0.121  2.304\1.2
+ * Rank/Splitting            0      0      0.001  0.001  0.002  0.005  0.011  0.02   0.044  0.104  2.214\1.15
+ * Rank/None                 0      0      0.001  0.002  0.004  0.01   0.017  0.038  0.091  0.211  2.269\1.18
+ * Size/Full                 0      0      0.001  0.001  0.002  0.005  0.01   0.023  0.047  0.131  2.434\1.28
+ * Size/Halving              0      0      0.001  0.001  0.002  0.006  0.009  0.021  0.051  0.119  2.292\1.2
+ * Size/Splitting            0      0      0      0.001  0.003  0.004  0.009  0.024  0.053  0.108  2.133\1.09
+ * Size/None                 0      0      0      0.002  0.005  0.007  0.017  0.043  0.095  0.217  2.245\1.17
+ * RandomIndex/Full          0      0      0.001  0.001  0.002  0.005  0.012  0.021  0.053  0.109  2.145\1.1
+ * RandomIndex/Halving       0      0      0.001  0.001  0.002  0.006  0.012  0.022  0.048  0.144  2.532\1.34
+ * RandomIndex/Splitting     0      0      0.001  0.001  0.003  0.006  0.013  0.033  0.08   0.115  1.895\0.922
+ * RandomIndex/None          0      0      0.001  0.001  0.005  0.009  0.02   0.06   0.1    0.268  2.413\1.27
+ * UnionFind                 0      0.001  0      0.001  0.002  0.005  0.011  0.023  0.046  0.109  2.193\1.13
+ * WeightedUnion             0      0      0.001  0.002  0.004  0.008  0.017  0.04   0.087  0.204  2.252\1.17
+ * QuickUnion                0.002  0.006  0.027  0.129  0.644  4.732  -      -      -      -      5.894\2.56
+ * QuickFind                 0.001  0.003  0.012  0.049  0.229  0.993  4.11   -      -      -      4.165\2.06
+ *
+ * Exporting clusters of 1000000 sites (seconds):
+ * Method                          Time
+ * Scan per cluster, 100 largest   0.793
+ * Member ring, 100 largest        0.002
+ * find per site, roots only       0.007
+ * flatten, all sites              0.011
  ******************************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
+#include "DisjointSets.h"
 #include "QuickFind.h"
 #include "QuickUnion.h"
 #include "UnionFind.h"
@@ -24,59 +58,45 @@
 #include "Timer.h"
 
 using namespace std;
+using namespace cpplib;
 
-int main()
+const int MIN_SCALE = 1000; // 最小规模
+const int MAX_SCALE = 512000; // 最大规模
+const double TIME_LIMIT = 2.0; // 超过这个时间（秒）后不再加倍
+const int EXPORT_SCALE = 1000000; // 导出实验的触点数
+const int EXPORT_CLUSTERS = 100; // 导出实验的分量数
+
+static long long sink; // 防止结果被优化掉
+
+/**
+ * 对一种并查集做倍率实验，随机合并直到只剩一个连通分量.
+ *
+ * @param name: 并查集的名字
+ */
+template<typename UF>
+void doubling(const string& name)
 {
     Timer timer;
-    double ratio;
-    double lastTime;
-    double currTime;
-    int p;
-    int q;
+    double ratio = 0.0;
+    double lastTime = 0.0;
+    double currTime = 0.0;
 
-    cout << "Running time of union-find in doubling test: " << endl;
-    cout << std::left << setw(14) << "UF\\SCALE";
-    for (int i = 1000; i < 100000; i *= 2)
-        cout << std::left << setw(7) << i;
-    cout << "ratio\\lg ratio";
-    cout << endl;
-
-    ratio = 0.0;
-    lastTime = 0.0;
-    cout << setw(14) << "UnionFind ";
-    for (int i = 1000; i < 100000; i *= 2)
+    cout << setw(26) << name;
+    for (int i = MIN_SCALE; i <= MAX_SCALE; i *= 2)
     {
-        UnionFind uf = UnionFind(i);
-
-        timer.start();
-        while (uf.count() > 1) 
+        if (currTime > TIME_LIMIT)
         {
-            p = Random::random(i);
-            q = Random::random(i);
-            uf.join(p, q);
+            cout << setw(7) << "-";
+            continue;
         }
-        currTime = timer.elapsed();
-        cout << setw(7) << setprecision(5) << currTime;
-        if (lastTime != 0.0)
-            ratio = (currTime / lastTime + ratio) / 2;
-        lastTime = currTime;
-    }
-    cout << setw(5) << setprecision(4) << ratio << "\\" 
-         << setw(5) << setprecision(3) << log2(ratio) << endl;
-
-    ratio = 0.0;
-    lastTime = 0.0;
-    cout << setw(14) << "WeightedUnion ";
-    for (int i = 1000; i < 100000; i *= 2)
-    {
-        WeightedUnion wu = WeightedUnion(i);
+        UF uf = UF(i);
 
         timer.start();
-        while (wu.count() > 1) 
+        while (uf.count() > 1)
         {
-            p = Random::random(i);
-            q = Random::random(i);
-            wu.join(p, q);
+            int p = Random::random(i);
+            int q = Random::random(i);
+            uf.join(p, q);
         }
         currTime = timer.elapsed();
         cout << setw(7) << setprecision(5) << currTime;
@@ -84,54 +104,83 @@ int main()
             ratio = (currTime / lastTime + ratio) / 2;
         lastTime = currTime;
     }
-    cout << setw(5) << setprecision(4) << ratio << "\\" 
+    cout << setw(5) << setprecision(4) << ratio << "\\"
          << setw(5) << setprecision(3) << log2(ratio) << endl;
+}
 
-    ratio = 0.0;
-    lastTime = 0.0;
-    cout << setw(14) << "QuickUnion ";
-    for (int i = 1000; i < 100000; i *= 2)
-    {
-        QuickUnion qu = QuickUnion(i);
+/**
+ * 对一种合并策略和所有路径压缩策略做倍率实验.
+ *
+ * @param name: 合并策略的名字
+ */
+template<typename LinkPolicy>
+void doubling_all(const string& name)
+{
+    doubling<DisjointSets<int, LinkPolicy, CompressFull>>(name + "/Full");
+    doubling<DisjointSets<int, LinkPolicy, CompressHalving>>(name + "/Halving");
+    doubling<DisjointSets<int, LinkPolicy, CompressSplitting>>(name + "/Splitting");
+    doubling<DisjointSets<int, LinkPolicy, CompressNone>>(name + "/None");
+}
 
-        timer.start();
-        while (qu.count() > 1) 
-        {
-            p = Random::random(i);
-            q = Random::random(i);
-            qu.join(p, q);
-        }
-        currTime = timer.elapsed();
-        cout << setw(7) << setprecision(5) << currTime;
-        if (lastTime != 0.0)
-            ratio = (currTime / lastTime + ratio) / 2;
-        lastTime = currTime;
-    }
-    cout << setw(5) << setprecision(4) << ratio << "\\" 
-         << setw(5) << setprecision(3) << log2(ratio) << endl;
+/**
+ * 导出连通分量的实验.
+ * 随机合并0.45n次得到大量分量，导出最大的若干个分量的成员，
+ * 比较逐个分量扫描全部触点与沿成员环遍历；再比较逐个触点查找与flatten()给所有触点编号.
+ */
+void export_clusters()
+{
+    int n = EXPORT_SCALE;
+    DisjointSets<int, LinkByRank, CompressHalving, true> uf(n); // 记录成员环
+    Timer timer;
 
-    ratio = 0.0;
-    lastTime = 0.0;
-    cout << setw(14) << "QuickFind ";
-    for (int i = 1000; i < 100000; i *= 2)
-    {
-        QuickFind qf = QuickFind(i);
+    for (int i = 0; i < n * 45 / 100; ++i)
+        uf.join(Random::random(n), Random::random(n));
+    vector<pair<int, int>> roots;
+    for (int i = 0; i < n; ++i)
+        if (uf.find(i) == i)
+            roots.emplace_back(-uf.component_size(i), i);
+    std::sort(roots.begin(), roots.end());
+    roots.resize(EXPORT_CLUSTERS);
 
-        timer.start();
-        while (qf.count() > 1) 
-        {        
-            p = Random::random(i);
-            q = Random::random(i);
-            qf.join(p, q);
-        }
-        currTime = timer.elapsed();
-        cout << setw(7) << setprecision(5) << currTime;
-        if (lastTime != 0.0)
-            ratio = (currTime / lastTime + ratio) / 2;
-        lastTime = currTime;
-    }
-    cout << setw(5) << setprecision(4) << ratio << "\\" 
-         << setw(5) << setprecision(3) << log2(ratio) << endl;
+    cout << "Exporting clusters of " << n << " sites (seconds): " << endl;
+    cout << setw(32) << "Method" << "Time" << endl;
+    timer.start();
+    for (auto& r : roots)
+        for (int i = 0; i < n; ++i)
+            if (uf.find(i) == r.second)
+                sink += i;
+    cout << setw(32) << "Scan per cluster, 100 largest" << timer.elapsed() << endl;
+    timer.start();
+    for (auto& r : roots)
+        for (int p : uf.members(r.second))
+            sink += p;
+    cout << setw(32) << "Member ring, 100 largest" << std::max(timer.elapsed(), 0.001) << endl;
+    timer.start();
+    for (int i = 0; i < n; ++i)
+        sink += uf.find(i);
+    cout << setw(32) << "find per site, roots only" << std::max(timer.elapsed(), 0.001) << endl;
+    timer.start();
+    for (int label : uf.flatten())
+        sink += label;
+    cout << setw(32) << "flatten, all sites" << std::max(timer.elapsed(), 0.001) << endl;
+}
+
+int main()
+{
+    cout << "Running time of union-find in doubling test: " << endl;
+    cout << std::left << setw(26) << "UF\\SCALE";
+    for (int i = MIN_SCALE; i <= MAX_SCALE; i *= 2)
+        cout << setw(7) << i;
+    cout << "ratio\\lg ratio" << endl;
 
-    return 0;
-}
\ No newline at end of file
+    doubling_all<LinkByRank>("Rank");
+    doubling_all<LinkBySize>("Size");
+    doubling_all<LinkByRandomIndex>("RandomIndex");
+    doubling<UnionFind>("UnionFind");
+    doubling<WeightedUnion>("WeightedUnion");
+    doubling<QuickUnion>("QuickUnion");
+    doubling<QuickFind>("QuickFind");
+    cout << endl;
+    export_clusters();
+    return sink == 0;
+}
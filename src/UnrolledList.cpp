@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Compilation:  g++ -IList -IUnrolledList -IVector -ITimer UnrolledList.cpp -o demo
+ * Execution:    ./demo
+ * Dependencies: List.h   UnrolledList.h
+ *               Vector.h Timer.h
+ *
+ * A benchmark of the unrolled linked list against List and Vector.
+ *
+ * % ./demo
+ * Running time of insert_back in doubling test:
+ * LIST\SCALE    100000  200000  400000  800000  1600000 3200000 ratio\lg ratio
+ * Vector        0.001   0.001   0.004   0.007   0.015   0.032   2.102\1.07
+ * List          0.002   0.001   0.003   0.007   0.012   0.035   2.382\1.25
+ * UnrolledList  0       0.001   0.001   0.002   0.003   0.008   2.021\1.01
+ * Running time of traversal in doubling test:
+ * LIST\SCALE    100000  200000  400000  800000  1600000 3200000 ratio\lg ratio
+ * Vector        0.001   0.001   0.001   0.006   0.01    0.019   2.21 \1.14
+ * List          0.002   0.004   0.011   0.019   0.056   0.139   2.428\1.28
+ * UnrolledList  0.002   0.003   0.006   0.015   0.028   0.053   1.897\0.924
+ * Running time of insert in the middle in doubling test:
+ * LIST\SCALE    100000  200000  400000  800000  1600000 3200000 ratio\lg ratio
+ * List          0       0       0.001   0.003   0.007   0.012   1.815\0.86
+ * UnrolledList  0.001   0.001   0.002   0.005   0.009   0.018   1.919\0.94
+ ******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "List.h"
+#include "UnrolledList.h"
+#include "Vector.h"
+#include "Timer.h"
+
+using namespace std;
+using namespace cpplib;
+
+static volatile long long sink; // 防止遍历结果被优化掉
+
+/**
+ * 在尾部添加n个元素.
+ *
+ * @param n: 元素数量
+ * @return 运行时间
+ */
+template<typename C>
+double time_insert_back(int n)
+{
+    Timer timer;
+    C c;
+
+    timer.start();
+    for (int i = 0; i < n; ++i)
+        c.insert_back(i);
+    return timer.elapsed();
+}
+
+/**
+ * 构建含n个元素的容器，然后遍历10次.
+ *
+ * @param n: 元素数量
+ * @return 遍历时间
+ */
+template<typename C>
+double time_traverse(int n)
+{
+    Timer timer;
+    C c;
+    long long sum = 0;
+
+    for (int i = 0; i < n; ++i)
+        c.insert_back(i);
+    timer.start();
+    for (int round = 0; round < 10; ++round)
+        for (auto i : c)
+            sum += i;
+    double elapsed = timer.elapsed();
+    sink = sum;
+    return elapsed;
+}
+
+// 在it之后添加元素，返回指向新元素的迭代器
+List<int>::iterator insert_after(List<int>& list, List<int>::iterator it, int elem)
+{
+    list.insert(std::next(it), elem);
+    return std::next(it);
+}
+
+UnrolledList<int>::iterator insert_after(UnrolledList<int>& list,
+                                         UnrolledList<int>::iterator it, int elem)
+{
+    return list.insert(std::next(it), elem);
+}
+
+/**
+ * 构建含n/2个元素的链表，遍历一次并在每个元素之后添加一个元素.
+ *
+ * @param n: 最终元素数量
+ * @return 运行时间
+ */
+template<typename L>
+double time_insert_middle(int n)
+{
+    Timer timer;
+    L list;
+
+    for (int i = 0; i < n / 2; ++i)
+        list.insert_back(i);
+    timer.start();
+    for (auto it = list.begin(); it != list.end(); ++it)
+        it = insert_after(list, it, *it);
+    return timer.elapsed();
+}
+
+/**
+ * 对指定测试函数进行倍率测试，打印运行时间和增长倍率.
+ *
+ * @param name: 测试的名称
+ *        test: 测试函数
+ */
+void doubling_test(const string& name, double (*test)(int))
+{
+    double ratio = 0.0;
+    double lastTime = 0.0;
+    double currTime;
+
+    cout << std::left << setw(14) << name;
+    for (int i = 100000; i < 4000000; i *= 2)
+    {
+        currTime = test(i);
+        cout << setw(8) << setprecision(5) << currTime;
+        if (lastTime != 0.0)
+            ratio = (currTime / lastTime + ratio) / 2;
+        lastTime = currTime;
+    }
+    cout << setw(5) << setprecision(4) << ratio << "\\"
+         << setw(5) << setprecision(3) << log2(ratio) << endl;
+}
+
+/**
+ * 打印倍率测试的表头.
+ *
+ * @param title: 测试的标题
+ */
+void print_header(const string& title)
+{
+    cout << "Running time of " << title << " in doubling test: " << endl;
+    cout << std::left << setw(14) << "LIST\\SCALE";
+    for (int i = 100000; i < 4000000; i *= 2)
+        cout << std::left << setw(8) << i;
+    cout << "ratio\\lg ratio" << endl;
+}
+
+int main()
+{
+    print_header("insert_back");
+    doubling_test("Vector", time_insert_back<Vector<int>>);
+    doubling_test("List", time_insert_back<List<int>>);
+    doubling_test("UnrolledList", time_insert_back<UnrolledList<int>>);
+
+    print_header("traversal");
+    doubling_test("Vector", time_traverse<Vector<int>>);
+    doubling_test("List", time_traverse<List<int>>);
+    doubling_test("UnrolledList", time_traverse<UnrolledList<int>>);
+
+    // Vector在中间添加元素需要移动后续所有元素，这里不参与比较
+    print_header("insert in the middle");
+    doubling_test("List", time_insert_middle<List<int>>);
+    doubling_test("UnrolledList", time_insert_middle<UnrolledList<int>>);
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BlockingQueue.h"
+#include "List.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::chrono::milliseconds;
+using cpplib::BlockingQueue;
+
+class TestBlockingQueue : public testing::Test
+{
+protected:
+    BlockingQueue<string> queue{8};
+    string str;
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestBlockingQueue, Basic)
+{
+    EXPECT_EQ(8u, queue.capacity());
+    EXPECT_EQ(1u, BlockingQueue<int>(0).capacity());
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(queue.enqueue(std::to_string(i)));
+    EXPECT_EQ(8u, queue.size());
+    str = "full";
+    EXPECT_FALSE(queue.try_enqueue(std::move(str), milliseconds(1)));
+    EXPECT_EQ("full", str);
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.dequeue(str));
+        EXPECT_EQ(std::to_string(i), str);
+    }
+    EXPECT_FALSE(queue.try_dequeue(str, milliseconds(1)));
+    EXPECT_EQ(2u, queue.counters().timeouts);
+    EXPECT_EQ(2u, queue.counters().parks);
+
+    // 容器可以替换为List
+    BlockingQueue<string, cpplib::List<string>> list_queue(4);
+    EXPECT_TRUE(list_queue.enqueue("0"));
+    EXPECT_TRUE(list_queue.try_dequeue(str, milliseconds(0)));
+    EXPECT_EQ("0", str);
+}
+
+TEST_F(TestBlockingQueue, Batch)
+{
+    std::vector<string> out(scale);
+
+    for (int i = 0; i < 6; ++i)
+        queue.enqueue(std::to_string(i));
+    EXPECT_EQ(4u, queue.dequeue_batch(out.begin(), 4, milliseconds(0)));
+    EXPECT_EQ(2u, queue.dequeue_batch(out.begin() + 4, scale, milliseconds(0)));
+    EXPECT_EQ(0u, queue.dequeue_batch(out.begin(), scale, milliseconds(1)));
+    for (int i = 0; i < 6; ++i)
+        EXPECT_EQ(std::to_string(i), out[i]);
+    // 批量入队超过容量时等待消费者取走元素
+    std::vector<string> in;
+    for (int i = 0; i < 20; ++i)
+        in.push_back(std::to_string(i));
+    std::thread consumer([&]
+    {
+        for (int i = 0; i < 20; ++i)
+            EXPECT_TRUE(queue.dequeue(out[i]));
+    });
+    EXPECT_EQ(20u, queue.enqueue_batch(in.begin(), in.size()));
+    consumer.join();
+    for (int i = 0; i < 20; ++i)
+        EXPECT_EQ(std::to_string(i), out[i]);
+    queue.close();
+    EXPECT_EQ(0u, queue.enqueue_batch(in.begin(), in.size()));
+}
+
+TEST_F(TestBlockingQueue, NoWait)
+{
+    std::vector<string> out;
+
+    // 不等待的批量出队在队空时立即返回，不计入休眠
+    EXPECT_EQ(0u, queue.try_dequeue_batch(std::back_inserter(out), 4));
+    EXPECT_EQ(0u, queue.counters().parks);
+    for (int i = 0; i < 6; ++i)
+        queue.enqueue(std::to_string(i));
+    EXPECT_EQ(4u, queue.try_dequeue_batch(std::back_inserter(out), 4));
+    EXPECT_EQ("3", out.back());
+
+    // 等待非空不取走元素，超时返回false，队列关闭后返回true
+    EXPECT_TRUE(queue.wait_not_empty(milliseconds(0)));
+    EXPECT_EQ(2u, queue.size());
+    queue.drain(std::back_inserter(out));
+    EXPECT_FALSE(queue.wait_not_empty(milliseconds(1)));
+    std::thread producer([this]
+    {
+        std::this_thread::sleep_for(milliseconds(20));
+        queue.enqueue("x");
+    });
+    EXPECT_TRUE(queue.wait_not_empty(milliseconds(5000)));
+    producer.join();
+    EXPECT_EQ(1u, queue.size());
+    queue.drain(std::back_inserter(out));
+    queue.close();
+    EXPECT_TRUE(queue.wait_not_empty(milliseconds(5000)));
+}
+
+TEST_F(TestBlockingQueue, Close)
+{
+    std::vector<string> out;
+
+    for (int i = 0; i < 5; ++i)
+        queue.enqueue(std::to_string(i));
+    queue.close();
+    EXPECT_TRUE(queue.closed());
+    EXPECT_FALSE(queue.enqueue("x"));
+    EXPECT_FALSE(queue.try_enqueue("x", milliseconds(1)));
+    // 关闭后仍可取走剩余元素
+    EXPECT_TRUE(queue.dequeue(str));
+    EXPECT_EQ("0", str);
+    EXPECT_EQ(4u, queue.drain(std::back_inserter(out)));
+    EXPECT_EQ("4", out.back());
+    EXPECT_FALSE(queue.dequeue(str));
+    EXPECT_EQ(0u, queue.dequeue_batch(out.begin(), 4, milliseconds(1)));
+}
+
+TEST_F(TestBlockingQueue, Wakeup)
+{
+    // 队满时生产者休眠，消费者出队后被唤醒
+    for (int i = 0; i < 8; ++i)
+        queue.enqueue(std::to_string(i));
+    std::thread producer([this] { EXPECT_TRUE(queue.enqueue("8")); });
+    std::this_thread::sleep_for(milliseconds(50));
+    EXPECT_TRUE(queue.dequeue(str));
+    producer.join();
+    EXPECT_EQ(8u, queue.size());
+
+    // 队空时消费者休眠，关闭队列后被唤醒并返回false
+    BlockingQueue<int> q;
+    std::thread consumer([&q]
+    {
+        int elem;
+        EXPECT_FALSE(q.dequeue(elem));
+    });
+    std::this_thread::sleep_for(milliseconds(50));
+    q.close();
+    consumer.join();
+
+    auto stats = queue.counters();
+    EXPECT_EQ(1u, stats.parks);
+    EXPECT_LE(1u, stats.wakeups);
+    EXPECT_LE(stats.max_wait_ns, stats.wait_ns);
+    EXPECT_EQ(1u, q.counters().parks);
+}
+
+TEST_F(TestBlockingQueue, Concurrent)
+{
+    const int producers = 4;
+    const int consumers = 4;
+    const int count = 20000;
+    BlockingQueue<int> q(16);
+    std::vector<std::atomic<int>> seen(producers * count);
+    std::vector<std::thread> workers;
+
+    for (auto& i : seen)
+        i.store(0);
+    for (int p = 0; p < producers; ++p)
+    {
+        workers.emplace_back([&, p]
+        {
+            for (int i = 0; i < count; ++i)
+                EXPECT_TRUE(q.enqueue(p * count + i));
+        });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        workers.emplace_back([&, c]
+        {
+            // 一半消费者逐个出队，一半批量出队，直到队列关闭且为空
+            int elem;
+            std::vector<int> batch(8);
+            if (c % 2 == 0)
+            {
+                while (q.dequeue(elem))
+                    seen[elem]++;
+                return;
+            }
+            while (!q.closed() || !q.empty())
+            {
+                size_t n = q.dequeue_batch(batch.begin(), batch.size(), milliseconds(10));
+                for (size_t i = 0; i < n; ++i)
+                    seen[batch[i]]++;
+            }
+        });
+    }
+    for (int p = 0; p < producers; ++p)
+        workers[p].join();
+    q.close();
+    for (size_t i = producers; i < workers.size(); ++i)
+        workers[i].join();
+    for (auto& i : seen)
+        EXPECT_EQ(1, i.load());
+    EXPECT_TRUE(q.empty());
+}
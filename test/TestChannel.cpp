@@ -0,0 +1,168 @@
+#include <atomic>
+#include <string>
+#include <vector>
+#include "Channel.h"
+#include "Executor.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::vector;
+using cpplib::Channel;
+using cpplib::SingleThreadExecutor;
+using cpplib::Task;
+using cpplib::ThreadPoolExecutor;
+
+// 发送from到to-1，结束后关闭通道
+Task produce(Channel<int>& ch, int from, int to, bool close)
+{
+    for (int i = from; i < to; ++i)
+        co_await ch.send(i);
+    if (close)
+        ch.close();
+}
+
+// 接收直到通道关闭
+Task consume(Channel<int>& ch, vector<int>& out)
+{
+    while (auto x = co_await ch.receive())
+        out.push_back(*x);
+}
+
+// 接收直到通道关闭，累加到sum
+Task accumulate(Channel<int>& ch, std::atomic<long long>& sum, std::atomic<int>& count)
+{
+    while (auto x = co_await ch.receive())
+    {
+        sum += *x;
+        ++count;
+    }
+}
+
+// 把收到的元素加一后发回
+Task echo(Channel<int>& in, Channel<int>& out)
+{
+    while (auto x = co_await in.receive())
+        co_await out.send(*x + 1);
+    out.close();
+}
+
+class TestChannel : public testing::Test
+{
+protected:
+    SingleThreadExecutor executor;
+    vector<int> out;
+    int scale;
+public:
+    virtual void SetUp() { scale = 1000; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestChannel, Bounded)
+{
+    Channel<int> ch(4);
+
+    EXPECT_EQ(4u, ch.capacity());
+    EXPECT_EQ(1u, Channel<int>(0).capacity());
+    // 先启动发送方，通道满时挂起，接收方取走后继续
+    executor.spawn(produce(ch, 0, scale, true));
+    executor.run();
+    EXPECT_EQ(4u, ch.size());
+    executor.spawn(consume(ch, out));
+    executor.run();
+    EXPECT_TRUE(ch.closed());
+    ASSERT_EQ(size_t(scale), out.size());
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(i, out[i]);
+}
+
+TEST_F(TestChannel, Unbounded)
+{
+    Channel<int> ch;
+
+    // 先启动接收方，发送直接交给挂起的接收方
+    executor.spawn(consume(ch, out));
+    executor.run();
+    executor.spawn(produce(ch, 0, scale, false));
+    executor.run();
+    EXPECT_EQ(size_t(scale), out.size());
+    executor.spawn(produce(ch, scale, 2 * scale, true));
+    executor.run();
+    EXPECT_EQ(size_t(2 * scale), out.size());
+    EXPECT_EQ(2 * scale - 1, out.back());
+}
+
+TEST_F(TestChannel, Close)
+{
+    Channel<string> ch(1);
+    bool sent = true;
+    std::optional<string> got = "x";
+
+    auto sender = [](Channel<string>& ch, bool& sent) -> Task
+    {
+        co_await ch.send("a");
+        sent = co_await ch.send("b");
+    };
+    auto receiver = [](Channel<string>& ch, std::optional<string>& got) -> Task
+    {
+        got = co_await ch.receive();
+    };
+    // 发送方挂起在第二个元素上，关闭后得到false
+    executor.spawn(sender(ch, sent));
+    executor.run();
+    ch.close();
+    executor.run();
+    EXPECT_FALSE(sent);
+    // 关闭后仍可取走剩余元素，之后得到空值
+    executor.spawn(receiver(ch, got));
+    executor.run();
+    EXPECT_EQ("a", *got);
+    executor.spawn(receiver(ch, got));
+    executor.run();
+    EXPECT_FALSE(got.has_value());
+}
+
+TEST_F(TestChannel, PingPong)
+{
+    Channel<int> ping(1);
+    Channel<int> pong(1);
+
+    auto player = [](Channel<int>& ping, Channel<int>& pong, int rounds, int& last) -> Task
+    {
+        int x = 0;
+        for (int i = 0; i < rounds; ++i)
+        {
+            co_await ping.send(x);
+            x = *co_await pong.receive();
+        }
+        ping.close();
+        last = x;
+    };
+    int last = 0;
+    executor.spawn(echo(ping, pong));
+    executor.spawn(player(ping, pong, scale, last));
+    executor.run();
+    EXPECT_EQ(scale, last);
+}
+
+TEST_F(TestChannel, ThreadPool)
+{
+    const int producers = 4;
+    const int consumers = 3;
+    Channel<int> ch(16);
+    std::atomic<long long> sum(0);
+    std::atomic<int> count(0);
+    {
+        ThreadPoolExecutor pool(4);
+        for (int i = 0; i < consumers; ++i)
+            pool.spawn(accumulate(ch, sum, count));
+        for (int i = 0; i < producers; ++i)
+            pool.spawn(produce(ch, i * scale * 10, (i + 1) * scale * 10, false));
+        // 等待发送完成后关闭，接收方取完后结束
+        while (count.load() < producers * scale * 10)
+            std::this_thread::yield();
+        ch.close();
+        pool.wait();
+    }
+    long long n = producers * scale * 10;
+    EXPECT_EQ(n * (n - 1) / 2, sum.load());
+}
@@ -0,0 +1,188 @@
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <vector>
+#include "ComponentLabeling.h"
+#include "gtest/gtest.h"
+
+using cpplib::ComponentLabeling;
+
+class TestComponentLabeling : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 60; }
+    virtual void TearDown() {}
+};
+
+// 按扫描顺序广度优先填充，标号顺序与ComponentLabeling相同
+static std::vector<int> flood(const std::vector<uint8_t>& v, int w, int h, int d, bool full)
+{
+    std::vector<int> labels(v.size(), 0);
+    int next = 0;
+    std::queue<int> q;
+    for (int s = 0; s < int(v.size()); ++s)
+    {
+        if (!v[s] || labels[s])
+            continue;
+        labels[s] = ++next;
+        q.push(s);
+        while (!q.empty())
+        {
+            int c = q.front();
+            q.pop();
+            int x = c % w, y = c / w % h, z = c / w / h;
+            for (int dz = -1; dz <= 1; ++dz)
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                    {
+                        int steps = (dx != 0) + (dy != 0) + (dz != 0);
+                        if (steps == 0 || (!full && steps > 1))
+                            continue;
+                        int nx = x + dx, ny = y + dy, nz = z + dz;
+                        if (nx < 0 || nx >= w || ny < 0 || ny >= h || nz < 0 || nz >= d)
+                            continue;
+                        int n = (nz * h + ny) * w + nx;
+                        if (v[n] && !labels[n])
+                        {
+                            labels[n] = next;
+                            q.push(n);
+                        }
+                    }
+        }
+    }
+    return labels;
+}
+
+static std::vector<uint8_t> random_voxels(size_t size, double density, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution open(density);
+    std::vector<uint8_t> v(size);
+    for (auto& x : v)
+        x = open(gen);
+    return v;
+}
+
+TEST_F(TestComponentLabeling, Image)
+{
+    std::vector<uint8_t> image =
+    {
+        1, 1, 0, 0, 1,
+        0, 1, 0, 1, 0,
+        0, 0, 0, 0, 0,
+        1, 0, 1, 1, 1
+    };
+    ComponentLabeling four(image, 5, 4, 1, 4);
+    ComponentLabeling eight(image, 5, 4, 1, 8);
+
+    EXPECT_EQ(5, four.count());
+    EXPECT_EQ(4, eight.count());
+    EXPECT_EQ(1, four.label(1, 1));
+    EXPECT_EQ(2, four.label(4, 0));
+    EXPECT_EQ(3, four.label(3, 1));
+    EXPECT_EQ(2, eight.label(3, 1));
+    EXPECT_EQ(0, eight.label(2, 2));
+    EXPECT_EQ(4, eight.label(4, 3));
+    EXPECT_EQ(3, four.region(1).area);
+    EXPECT_EQ(0, four.region(1).min_x);
+    EXPECT_EQ(1, four.region(1).max_x);
+    EXPECT_EQ(1, four.region(1).max_y);
+    EXPECT_EQ(2, eight.region(2).area);
+    EXPECT_EQ(3, eight.region(2).min_x);
+    EXPECT_EQ(1, eight.region(2).max_y);
+    EXPECT_EQ(3, eight.region(4).area);
+    EXPECT_EQ(3, eight.region(4).min_y);
+    EXPECT_THROW(four.label(5, 0), std::out_of_range);
+    EXPECT_THROW(four.region(6), std::out_of_range);
+    EXPECT_THROW(eight.region(0), std::out_of_range);
+    EXPECT_THROW(ComponentLabeling(image, 5, 3, 1, 4), std::invalid_argument);
+    EXPECT_THROW(ComponentLabeling(image, 5, 4, 1, 5), std::invalid_argument);
+    EXPECT_THROW(ComponentLabeling(image, 5, 2, 2, 8), std::invalid_argument);
+    EXPECT_EQ(0, ComponentLabeling(std::vector<uint8_t>(), 0, 0, 1, 4, 4).count());
+}
+
+TEST_F(TestComponentLabeling, Volume)
+{
+    // 两层2×2，对角的两个体素只在26邻接下相连
+    std::vector<uint8_t> volume =
+    {
+        1, 0,
+        0, 0,
+
+        0, 0,
+        0, 1
+    };
+    EXPECT_EQ(2, ComponentLabeling(volume, 2, 2, 2, 6).count());
+    ComponentLabeling full(volume, 2, 2, 2, 26);
+    EXPECT_EQ(1, full.count());
+    EXPECT_EQ(2, full.region(1).area);
+    EXPECT_EQ(0, full.region(1).min_z);
+    EXPECT_EQ(1, full.region(1).max_z);
+    EXPECT_EQ(1, full.label(1, 1, 1));
+    EXPECT_THROW(full.label(0, 0, 2), std::out_of_range);
+}
+
+TEST_F(TestComponentLabeling, Random)
+{
+    for (double density : { 0.3, 0.5, 0.6 })
+    {
+        std::vector<uint8_t> image = random_voxels(size_t(scale) * scale, density, 1);
+        for (int connectivity : { 4, 8 })
+        {
+            std::vector<int> expected = flood(image, scale, scale, 1, connectivity == 8);
+            for (unsigned threads : { 1, 3, 8, 100 })
+            {
+                ComponentLabeling cl(image, scale, scale, 1, connectivity, threads);
+                EXPECT_EQ(expected, cl.labels());
+            }
+        }
+
+        int side = scale / 4;
+        std::vector<uint8_t> volume = random_voxels(size_t(side) * side * side, density, 2);
+        for (int connectivity : { 6, 26 })
+        {
+            std::vector<int> expected = flood(volume, side, side, side, connectivity == 26);
+            for (unsigned threads : { 1, 4, 100 })
+            {
+                ComponentLabeling cl(volume, side, side, side, connectivity, threads);
+                EXPECT_EQ(expected, cl.labels());
+            }
+        }
+    }
+}
+
+TEST_F(TestComponentLabeling, Regions)
+{
+    int w = scale, h = scale / 2;
+    std::vector<uint8_t> image = random_voxels(size_t(w) * h, 0.55, 3);
+    ComponentLabeling cl(image, w, h, 1, 8, 4);
+
+    std::vector<long long> area(cl.count() + 1, 0);
+    std::vector<int> min_x(cl.count() + 1, w), max_x(cl.count() + 1, -1);
+    std::vector<int> min_y(cl.count() + 1, h), max_y(cl.count() + 1, -1);
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            int l = cl.label(x, y);
+            EXPECT_EQ(image[y * w + x] != 0, l != 0);
+            area[l]++;
+            min_x[l] = std::min(min_x[l], x);
+            max_x[l] = std::max(max_x[l], x);
+            min_y[l] = std::min(min_y[l], y);
+            max_y[l] = std::max(max_y[l], y);
+        }
+    }
+    for (int l = 1; l <= cl.count(); ++l)
+    {
+        EXPECT_EQ(area[l], cl.region(l).area);
+        EXPECT_EQ(min_x[l], cl.region(l).min_x);
+        EXPECT_EQ(max_x[l], cl.region(l).max_x);
+        EXPECT_EQ(min_y[l], cl.region(l).min_y);
+        EXPECT_EQ(max_y[l], cl.region(l).max_y);
+        EXPECT_EQ(0, cl.region(l).min_z);
+        EXPECT_EQ(0, cl.region(l).max_z);
+    }
+}
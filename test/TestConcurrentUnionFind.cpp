@@ -0,0 +1,84 @@
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ConcurrentUnionFind.h"
+#include "UnionFind.h"
+#include "gtest/gtest.h"
+
+using cpplib::ConcurrentUnionFind;
+
+class TestConcurrentUnionFind : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 20000; }
+    virtual void TearDown() {}
+
+    // 生成count条随机边
+    std::vector<std::pair<int, int>> edges(int n, int count)
+    {
+        std::vector<std::pair<int, int>> e;
+        unsigned x = 11;
+        for (int i = 0; i < count; ++i)
+        {
+            x = x * 1103515245 + 12345;
+            int p = (x >> 8) % n;
+            x = x * 1103515245 + 12345;
+            e.emplace_back(p, (x >> 8) % n);
+        }
+        return e;
+    }
+};
+
+TEST_F(TestConcurrentUnionFind, Basic)
+{
+    for (bool random : { true, false })
+    {
+        ConcurrentUnionFind<int> uf(10, random);
+        EXPECT_EQ(10, uf.count());
+        EXPECT_TRUE(uf.join(1, 2));
+        EXPECT_TRUE(uf.join(2, 3));
+        EXPECT_FALSE(uf.join(1, 3));
+        EXPECT_TRUE(uf.connected(3, 1));
+        EXPECT_FALSE(uf.connected(0, 1));
+        EXPECT_EQ(uf.find(1), uf.find(3));
+        EXPECT_EQ(8, uf.count());
+        EXPECT_THROW(uf.find(10), std::out_of_range);
+        EXPECT_THROW(uf.join(0, -1), std::out_of_range);
+    }
+}
+
+TEST_F(TestConcurrentUnionFind, Concurrent)
+{
+    const int threads = 4;
+    auto e = edges(scale, scale);
+    ConcurrentUnionFind<int> cuf(scale);
+    UnionFind uf(scale);
+    std::vector<std::thread> workers;
+    std::vector<int> merged(threads);
+
+    for (auto& edge : e)
+        uf.join(edge.first, edge.second);
+    // 每个线程处理交错的一部分边，同时查询
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]
+        {
+            for (size_t i = t; i < e.size(); i += threads)
+            {
+                merged[t] += cuf.join(e[i].first, e[i].second);
+                EXPECT_TRUE(cuf.connected(e[i].first, e[i].second));
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    int total = 0;
+    for (int m : merged)
+        total += m;
+    EXPECT_EQ(scale - uf.count(), total);
+    EXPECT_EQ(uf.count(), cuf.count());
+    for (int i = 0; i < scale; i += 3)
+        EXPECT_EQ(uf.connected(i, i / 2), cuf.connected(i, i / 2));
+}
@@ -0,0 +1,122 @@
+#include <utility>
+#include <vector>
+#include "ConnectedComponents.h"
+#include "UnionFind.h"
+#include "gtest/gtest.h"
+
+using cpplib::ConnectedComponents;
+
+class TestConnectedComponents : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 50000; }
+    virtual void TearDown() {}
+
+    // 生成count条随机边
+    std::vector<std::pair<int, int>> edges(int n, int count)
+    {
+        std::vector<std::pair<int, int>> e;
+        unsigned x = 5;
+        for (int i = 0; i < count; ++i)
+        {
+            x = x * 1103515245 + 12345;
+            int p = (x >> 8) % n;
+            x = x * 1103515245 + 12345;
+            e.emplace_back(p, (x >> 8) % n);
+        }
+        return e;
+    }
+
+    // 由边表构造无向图的压缩邻接表
+    void csr(int n, const std::vector<std::pair<int, int>>& e,
+             std::vector<size_t>& offsets, std::vector<int>& neighbors)
+    {
+        offsets.assign(n + 1, 0);
+        for (auto& edge : e)
+        {
+            offsets[edge.first + 1]++;
+            offsets[edge.second + 1]++;
+        }
+        for (int i = 0; i < n; ++i)
+            offsets[i + 1] += offsets[i];
+        std::vector<size_t> pos(offsets.begin(), offsets.end() - 1);
+        neighbors.resize(offsets.back());
+        for (auto& edge : e)
+        {
+            neighbors[pos[edge.first]++] = edge.second;
+            neighbors[pos[edge.second]++] = edge.first;
+        }
+    }
+
+    // 检查与UnionFind的结果一致，编号连续且按最小触点排序
+    void check(int n, const std::vector<std::pair<int, int>>& e, const ConnectedComponents<int>& cc)
+    {
+        UnionFind uf(n);
+        for (auto& edge : e)
+            uf.join(edge.first, edge.second);
+        ASSERT_EQ(n, cc.vertices());
+        EXPECT_EQ(uf.count(), cc.count());
+        std::vector<int> seen(cc.count(), 0);
+        int next = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            int label = cc.id(i);
+            ASSERT_LE(0, label);
+            ASSERT_GT(cc.count(), label);
+            if (label == next)
+                next++;
+            EXPECT_GT(next, label);
+            seen[label]++;
+            EXPECT_EQ(uf.connected(i, i / 3), cc.connected(i, i / 3));
+        }
+        EXPECT_EQ(seen, cc.component_sizes());
+    }
+};
+
+TEST_F(TestConnectedComponents, Small)
+{
+    std::vector<std::pair<int, int>> e = { { 4, 1 }, { 1, 6 }, { 3, 5 }, { 6, 6 } };
+    ConnectedComponents<int> cc(8, e, 2);
+
+    EXPECT_EQ(5, cc.count());
+    EXPECT_EQ(0, cc.id(0));
+    EXPECT_EQ(1, cc.id(4));
+    EXPECT_EQ(1, cc.id(6));
+    EXPECT_EQ(3, cc.id(3));
+    EXPECT_EQ(3, cc.size(6));
+    EXPECT_EQ(1, cc.size(7));
+    EXPECT_TRUE(cc.connected(5, 3));
+    EXPECT_FALSE(cc.connected(5, 6));
+    EXPECT_THROW(cc.id(8), std::out_of_range);
+    EXPECT_THROW(ConnectedComponents<int>(4, e), std::out_of_range);
+    EXPECT_THROW(ConnectedComponents<int>(std::vector<size_t>{ 0, 2 }, std::vector<int>{ 0 }),
+                 std::out_of_range);
+    EXPECT_EQ(0, ConnectedComponents<int>(0, {}).count());
+}
+
+TEST_F(TestConnectedComponents, EdgeList)
+{
+    // 稀疏图有大量小分量，稠密图有一个巨大分量
+    for (int m : { scale / 2, scale * 4 })
+    {
+        auto e = edges(scale, m);
+        for (unsigned threads : { 1u, 4u })
+            check(scale, e, ConnectedComponents<int>(scale, e, threads));
+    }
+}
+
+TEST_F(TestConnectedComponents, Csr)
+{
+    std::vector<size_t> offsets;
+    std::vector<int> neighbors;
+
+    for (int m : { scale / 2, scale * 4 })
+    {
+        auto e = edges(scale, m);
+        csr(scale, e, offsets, neighbors);
+        for (unsigned threads : { 1u, 4u })
+            check(scale, e, ConnectedComponents<int>(offsets, neighbors, threads));
+    }
+}
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 
 using std::string;
+using cpplib::Deque;
 
 class TestDeque : public testing::Test
 {
@@ -52,7 +53,7 @@ TEST_F(TestDeque, Basic)
         Deque<string> s2(scale);
         Deque<string> s3(scale, "Hello World!");
         Deque<string> s4(s1);
-        Deque<string> s5(Deque<string>());
+        Deque<string> s5{Deque<string>()};
 
         s1 = s2;
         s2 = Deque<string>(scale);
@@ -205,6 +206,58 @@ TEST_F(TestDeque, Modifiers)
     }
 }
 
+TEST_F(TestDeque, BlockBoundaries)
+{
+    // 元素跨越多个区块时，back()和--迭代器要落在上一个区块的尾部
+    size_t n = 8 * scale;
+    for (size_t i = 0; i < n; ++i)
+    {
+        deque.insert_back(std::to_string(i));
+        EXPECT_EQ(std::to_string(i), deque.back());
+    }
+    auto it = deque.end();
+    for (size_t i = n; i > 0; --i)
+        EXPECT_EQ(std::to_string(i - 1), *--it);
+    EXPECT_TRUE(it == deque.begin());
+    Deque<string>::const_iterator cit = deque.begin();
+    EXPECT_EQ("0", *cit);
+    EXPECT_TRUE(cit + std::ptrdiff_t(n) == deque.cend());
+
+    // 反复先进先出，区块映射重新居中后元素仍然正确
+    for (size_t i = n; i < 64 * n; ++i)
+    {
+        deque.insert_back(std::to_string(i));
+        EXPECT_EQ(std::to_string(i - n), deque.front());
+        deque.remove_front();
+    }
+    EXPECT_EQ(n, deque.size());
+    EXPECT_EQ(std::to_string(63 * n), deque.front());
+    EXPECT_EQ(std::to_string(64 * n - 1), deque.back());
+}
+
+TEST_F(TestDeque, ClearAndReuse)
+{
+    size_t n = 8 * scale;
+    for (int round = 0; round < 3; ++round)
+    {
+        insert_n(deque, n, true);
+        insert_n(deque, n, false);
+        EXPECT_EQ(2 * n, deque.size());
+        EXPECT_EQ(std::to_string(n - 1), deque.front());
+        EXPECT_EQ(std::to_string(n - 1), deque.back());
+        deque.clear();
+        EXPECT_TRUE(deque.empty());
+        EXPECT_EQ(size_t(0), deque.size());
+        EXPECT_TRUE(deque.begin() == deque.end());
+        EXPECT_THROW(deque.back(), std::out_of_range);
+    }
+
+    Deque<string> list{ "0", "1", "2" };
+    EXPECT_EQ(size_t(3), list.size());
+    EXPECT_EQ("0", list.front());
+    EXPECT_EQ("2", list.back());
+}
+
 TEST_F(TestDeque, Other)
 {
     using std::swap;
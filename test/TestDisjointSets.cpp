@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "DisjointSets.h"
+#include "QuickFind.h"
+#include "QuickUnion.h"
+#include "UnionFind.h"
+#include "WeightedUnion.h"
+#include "gtest/gtest.h"
+
+using namespace cpplib;
+
+template<typename UF>
+class TestDisjointSets : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 2000; }
+    virtual void TearDown() {}
+};
+
+// 记录成员环的并查集
+template<typename UF>
+class TestDisjointSetsMembers : public TestDisjointSets<UF> {};
+
+using DisjointSetsTypes = testing::Types<
+    DisjointSets<int, LinkByRank, CompressFull, true>,
+    DisjointSets<int, LinkByRank, CompressSplitting>,
+    DisjointSets<long long, LinkBySize, CompressHalving, true>,
+    DisjointSets<int, LinkBySize, CompressFull>,
+    DisjointSets<int, LinkByRandomIndex, CompressSplitting>,
+    DisjointSets<short, LinkByRandomIndex, CompressNone, true>,
+    UnionFind, WeightedUnion, QuickUnion, QuickFind>;
+TYPED_TEST_SUITE(TestDisjointSets, DisjointSetsTypes);
+
+using MembersTypes = testing::Types<
+    DisjointSets<int, LinkByRank, CompressFull, true>,
+    DisjointSets<long long, LinkBySize, CompressHalving, true>,
+    DisjointSets<short, LinkByRandomIndex, CompressNone, true>,
+    DisjointSets<int, LinkRelabel, CompressNone, true>>;
+TYPED_TEST_SUITE(TestDisjointSetsMembers, MembersTypes);
+
+TYPED_TEST(TestDisjointSets, Join)
+{
+    using Index = typename TypeParam::index_type;
+    TypeParam uf(10);
+
+    EXPECT_EQ(10, uf.count());
+    EXPECT_EQ(10, uf.size());
+    EXPECT_TRUE(uf.join(Index(1), Index(2)));
+    EXPECT_TRUE(uf.join(Index(3), Index(4)));
+    EXPECT_TRUE(uf.join(Index(2), Index(4)));
+    EXPECT_FALSE(uf.join(Index(1), Index(3)));
+    EXPECT_EQ(7, uf.count());
+    EXPECT_TRUE(uf.connected(Index(1), Index(4)));
+    EXPECT_FALSE(uf.connected(Index(0), Index(4)));
+    EXPECT_EQ(uf.find(Index(1)), uf.find(Index(3)));
+    EXPECT_THROW(uf.find(Index(10)), std::out_of_range);
+    EXPECT_THROW(uf.join(Index(-1), Index(0)), std::out_of_range);
+}
+
+TYPED_TEST(TestDisjointSets, Random)
+{
+    using Index = typename TypeParam::index_type;
+    int n = this->scale;
+    TypeParam uf(n);
+    std::vector<int> label(n);
+    int components = n;
+    unsigned x = 7;
+
+    // 与直接维护标号的朴素实现比较
+    for (int i = 0; i < n; ++i)
+        label[i] = i;
+    for (int k = 0; k < n; ++k)
+    {
+        x = x * 1103515245 + 12345;
+        int p = (x >> 8) % n;
+        x = x * 1103515245 + 12345;
+        int q = (x >> 8) % n;
+        bool merged = label[p] != label[q];
+        if (merged)
+        {
+            int old = label[p];
+            for (auto& l : label)
+                if (l == old)
+                    l = label[q];
+            components--;
+        }
+        EXPECT_EQ(merged, uf.join(Index(p), Index(q)));
+    }
+    EXPECT_EQ(components, uf.count());
+    for (int i = 0; i < n; i += 7)
+        for (int j = 0; j < n; j += 13)
+            EXPECT_EQ(label[i] == label[j], uf.connected(Index(i), Index(j)));
+}
+
+TYPED_TEST(TestDisjointSets, CopyAndMove)
+{
+    using Index = typename TypeParam::index_type;
+    TypeParam a(6);
+
+    a.join(Index(0), Index(1));
+    TypeParam b(a);
+    b.join(Index(2), Index(3));
+    EXPECT_EQ(5, a.count());
+    EXPECT_EQ(4, b.count());
+    EXPECT_FALSE(a.connected(Index(2), Index(3)));
+    TypeParam c(std::move(b));
+    EXPECT_TRUE(c.connected(Index(2), Index(3)));
+    // 被移动的并查集为空，可以继续追加触点
+    EXPECT_EQ(0, b.size());
+    EXPECT_EQ(0, b.count());
+    EXPECT_THROW(b.find(Index(0)), std::out_of_range);
+    EXPECT_EQ(Index(0), b.make_set());
+    EXPECT_EQ(1, b.count());
+    a = c;
+    EXPECT_EQ(4, a.count());
+    swap(a, c);
+    EXPECT_TRUE(c.connected(Index(0), Index(1)));
+}
+
+TYPED_TEST(TestDisjointSets, MakeSet)
+{
+    using Index = typename TypeParam::index_type;
+    TypeParam uf;
+
+    // 逐个追加触点，每个新触点与前一个的一半合并
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(Index(i), uf.make_set());
+        if (i % 2 == 1)
+        {
+            EXPECT_TRUE(uf.join(Index(i), Index(i / 2)));
+        }
+    }
+    EXPECT_EQ(100, uf.size());
+    EXPECT_EQ(50, uf.count());
+    EXPECT_TRUE(uf.connected(Index(3), Index(1)));
+    EXPECT_THROW(uf.find(Index(100)), std::out_of_range);
+    uf.reserve(Index(1000));
+    TypeParam copy(uf);
+    EXPECT_EQ(Index(100), copy.make_set());
+    EXPECT_TRUE(copy.connected(Index(99), Index(49)));
+    EXPECT_EQ(51, copy.count());
+}
+
+TYPED_TEST(TestDisjointSetsMembers, Members)
+{
+    using Index = typename TypeParam::index_type;
+    int n = this->scale;
+    TypeParam uf(n);
+
+    // 触点i与i % 7合并，得到7个大小相近的分量
+    for (int i = 7; i < n; ++i)
+        uf.join(Index(i), Index(i % 7));
+    for (int r = 0; r < 7; ++r)
+    {
+        auto members = uf.members(Index(r + 7));
+        int expected = (n - r + 6) / 7;
+        ASSERT_EQ(size_t(expected), members.size());
+        EXPECT_EQ(expected, uf.component_size(Index(r)));
+        EXPECT_EQ(Index(r + 7), members.front());
+        std::sort(members.begin(), members.end());
+        for (int k = 0; k < expected; ++k)
+            EXPECT_EQ(Index(r + 7 * k), members[k]);
+    }
+    Index p = uf.make_set();
+    EXPECT_EQ(p, uf.next_member(p));
+    EXPECT_EQ(1, uf.component_size(p));
+    EXPECT_THROW(uf.members(Index(-1)), std::out_of_range);
+}
+
+TYPED_TEST(TestDisjointSets, Flatten)
+{
+    using Index = typename TypeParam::index_type;
+    TypeParam uf(8);
+
+    uf.join(Index(5), Index(1));
+    uf.join(Index(6), Index(1));
+    uf.join(Index(3), Index(7));
+    uf.join(Index(7), Index(0));
+    auto labels = uf.flatten();
+    EXPECT_EQ(std::vector<Index>({ 0, 1, 2, 0, 3, 1, 1, 0 }), labels);
+    EXPECT_EQ(4, uf.count());
+    EXPECT_TRUE(uf.connected(Index(6), Index(5)));
+}
+
+TYPED_TEST(TestDisjointSets, Snapshot)
+{
+    using Index = typename TypeParam::index_type;
+    using Link = typename TypeParam::link_policy;
+    using OtherLink = typename std::conditional<std::is_same<Link, LinkByRank>::value, LinkBySize, LinkByRank>::type;
+    using OtherIndex = typename std::conditional<sizeof(Index) == 8, int, long long>::type;
+    using OtherLinkSets = DisjointSets<Index, OtherLink>;
+    using OtherIndexSets = DisjointSets<OtherIndex, Link>;
+    std::string path = testing::TempDir() + "TestDisjointSets.snapshot";
+    int n = 200;
+    TypeParam uf(n);
+    for (int i = 0; i < n; i += 3)
+        uf.join(Index(i), Index((i * 7 + 5) % n));
+    uf.save(path);
+
+    // 压缩策略可以不同，合并策略和下标宽度必须相同
+    auto loaded = DisjointSets<Index, Link, CompressNone>::load(path);
+    EXPECT_EQ(uf.size(), loaded.size());
+    EXPECT_EQ(uf.count(), loaded.count());
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_EQ(uf.find(Index(i)), loaded.find(Index(i)));
+    }
+    // 载入后可以继续合并和追加
+    loaded.join(Index(1), Index(2));
+    EXPECT_TRUE(loaded.connected(Index(1), Index(2)));
+    EXPECT_EQ(Index(n), loaded.make_set());
+    EXPECT_THROW(OtherLinkSets::load(path), std::invalid_argument);
+    EXPECT_THROW(OtherIndexSets::load(path), std::invalid_argument);
+    EXPECT_THROW(TypeParam::load(path + ".missing"), std::runtime_error);
+
+    TypeParam().save(path);
+    EXPECT_EQ(0, TypeParam::load(path).size());
+    std::remove(path.c_str());
+}
+
+TYPED_TEST(TestDisjointSetsMembers, ComponentSize)
+{
+    using Index = typename TypeParam::index_type;
+    int n = this->scale;
+    TypeParam uf(n);
+    // LinkBySize不记录成员时从根结点读出大小
+    DisjointSets<Index, LinkBySize> plain(n);
+
+    for (int i = 0; i < n; i += 2)
+    {
+        uf.join(Index(i), Index(i / 3));
+        plain.join(Index(i), Index(i / 3));
+    }
+    for (int i = 0; i < n; ++i)
+        EXPECT_EQ(plain.component_size(Index(i)), uf.component_size(Index(i)));
+    EXPECT_EQ(1, uf.component_size(Index(n - 1)));
+    EXPECT_THROW(uf.component_size(Index(n)), std::out_of_range);
+}
+
+TYPED_TEST(TestDisjointSetsMembers, Snapshot)
+{
+    using Index = typename TypeParam::index_type;
+    using Link = typename TypeParam::link_policy;
+    using Plain = DisjointSets<Index, Link, CompressFull>;
+    std::string path = testing::TempDir() + "TestDisjointSetsMembers.snapshot";
+    int n = 200;
+    TypeParam uf(n);
+    Plain plain(n);
+    for (int i = 0; i < n; i += 3)
+    {
+        uf.join(Index(i), Index((i * 7 + 5) % n));
+        plain.join(Index(i), Index((i * 7 + 5) % n));
+    }
+
+    // 记录成员的快照原样载入，成员环的顺序不变
+    uf.save(path);
+    auto loaded = DisjointSets<Index, Link, CompressNone, true>::load(path);
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_EQ(uf.component_size(Index(i)), loaded.component_size(Index(i)));
+        EXPECT_EQ(uf.next_member(Index(i)), loaded.next_member(Index(i)));
+    }
+    // 载入为不记录成员的并查集时跳过多余的数组
+    Plain skipped = Plain::load(path);
+    EXPECT_EQ(uf.count(), skipped.count());
+    EXPECT_TRUE(skipped.connected(Index(0), Index(5)));
+
+    // 不记录成员的快照载入时重建成员环和分量大小
+    plain.save(path);
+    auto rebuilt = TypeParam::load(path);
+    for (int i = 0; i < n; ++i)
+    {
+        auto expected = uf.members(Index(i));
+        auto members = rebuilt.members(Index(i));
+        std::sort(expected.begin(), expected.end());
+        std::sort(members.begin(), members.end());
+        EXPECT_EQ(expected, members);
+        EXPECT_EQ(uf.component_size(Index(i)), rebuilt.component_size(Index(i)));
+    }
+    rebuilt.join(Index(1), Index(2));
+    EXPECT_EQ(uf.component_size(Index(1)) + uf.component_size(Index(2)), rebuilt.component_size(Index(2)));
+    std::remove(path.c_str());
+}
+
+TYPED_TEST(TestDisjointSetsMembers, CorruptSnapshot)
+{
+    using Index = typename TypeParam::index_type;
+    std::string path = testing::TempDir() + "TestDisjointSetsCorrupt.snapshot";
+    int n = 10;
+    TypeParam uf(n);
+    uf.join(Index(0), Index(1));
+    uf.join(Index(1), Index(2));
+    uf.join(Index(5), Index(6));
+    uf.save(path);
+
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    size_t parent = sizeof(DisjointSetsHeader);
+    size_t next = parent + (n * sizeof(Index) + 7) / 8 * 8; // 数组补齐到8字节
+    // 把第array个数组的第i项改为value后载入
+    auto corrupt = [&](size_t array, int i, Index value)
+    {
+        std::string copy(bytes);
+        std::memcpy(&copy[array + i * sizeof(Index)], &value, sizeof(Index));
+        std::ofstream(path, std::ios::binary).write(copy.data(), std::streamsize(copy.size()));
+        TypeParam::load(path);
+    };
+
+    Index root = uf.find(Index(0));
+    Index other = uf.find(Index(5));
+    Index leaf = root == Index(2) ? Index(1) : Index(2);
+    EXPECT_THROW(corrupt(parent, 3, Index(n)), std::invalid_argument);    // 父结点越界
+    EXPECT_THROW(corrupt(parent, leaf, leaf), std::invalid_argument);     // 父结点为自身，成环
+    EXPECT_THROW(corrupt(parent, root, leaf), std::invalid_argument);     // 根指向自己的成员
+    EXPECT_THROW(corrupt(parent, 3, Index(4)), std::invalid_argument);    // 连通分量数不符
+    EXPECT_THROW(corrupt(next, 3, Index(4)), std::invalid_argument);      // next不是排列
+    EXPECT_THROW(corrupt(next, 3, Index(-1)), std::invalid_argument);     // next越界
+    EXPECT_THROW(corrupt(next, other, root), std::invalid_argument);      // 环跨越分量
+    EXPECT_NO_THROW(corrupt(next, 3, Index(3)));                          // 原样写回
+
+    // 头部声明的触点数超过文件长度时不分配数组
+    DisjointSetsHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.size = uint64_t(std::numeric_limits<Index>::max());
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(&header), sizeof(header));
+    EXPECT_THROW(TypeParam::load(path), std::runtime_error);
+    std::ofstream(path, std::ios::binary).write(bytes.data(), std::streamsize(bytes.size() - 1));
+    EXPECT_THROW(TypeParam::load(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+class TestDisjointSetsLimit : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = std::numeric_limits<signed char>::max(); }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestDisjointSetsLimit, MakeSet)
+{
+    // 容量翻倍会溢出时取下标类型的最大值，触点数达到最大值后不能再追加
+    DisjointSets<signed char> uf;
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(i, uf.make_set());
+    EXPECT_EQ(scale, uf.size());
+    EXPECT_THROW(uf.make_set(), std::length_error);
+    EXPECT_EQ(scale, uf.count());
+}
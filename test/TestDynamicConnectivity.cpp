@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "DynamicConnectivity.h"
+#include "UnionFind.h"
+#include "gtest/gtest.h"
+
+using cpplib::DynamicConnectivity;
+
+class TestDynamicConnectivity : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 300; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestDynamicConnectivity, Small)
+{
+    DynamicConnectivity<int> dc(5);
+
+    EXPECT_EQ(0u, dc.query_count());
+    dc.add_edge(0, 1);
+    dc.add_edge(1, 2);
+    EXPECT_EQ(1u, dc.query_connected(0, 2));
+    dc.add_edge(2, 1);
+    dc.remove_edge(1, 2);
+    dc.query_connected(2, 0);
+    dc.remove_edge(2, 1);
+    dc.query_connected(0, 2);
+    dc.query_count();
+    dc.remove_edge(0, 1);
+    dc.query_count();
+    EXPECT_EQ(6u, dc.queries());
+    EXPECT_EQ(std::vector<int>({ 5, 1, 1, 0, 4, 5 }), dc.solve());
+    EXPECT_THROW(dc.add_edge(0, 5), std::out_of_range);
+    dc.remove_edge(3, 4);
+    EXPECT_THROW(dc.solve(), std::invalid_argument);
+    EXPECT_TRUE(DynamicConnectivity<int>(3).solve().empty());
+}
+
+TEST_F(TestDynamicConnectivity, Random)
+{
+    int n = scale;
+    DynamicConnectivity<int> dc(n);
+    std::vector<std::pair<int, int>> edges;
+    std::vector<int> expected;
+    unsigned x = 9;
+    auto next = [&x](int bound)
+    {
+        x = x * 1103515245 + 12345;
+        return int((x >> 8) % bound);
+    };
+
+    // 每次查询都用UnionFind重建当前的图作为对照
+    for (int i = 0; i < scale * 10; ++i)
+    {
+        int op = next(10);
+        if (op < 4)
+        {
+            int p = next(n), q = next(n);
+            edges.emplace_back(p, q);
+            dc.add_edge(p, q);
+        }
+        else if (op < 7 && !edges.empty())
+        {
+            int k = next(int(edges.size()));
+            std::swap(edges[k], edges.back());
+            dc.remove_edge(edges.back().first, edges.back().second);
+            edges.pop_back();
+        }
+        else
+        {
+            UnionFind uf(n);
+            for (auto& e : edges)
+                uf.join(e.first, e.second);
+            int p = next(n), q = next(n);
+            if (op == 9)
+            {
+                dc.query_count();
+                expected.push_back(uf.count());
+            }
+            else
+            {
+                dc.query_connected(p, q);
+                expected.push_back(uf.connected(p, q));
+            }
+        }
+    }
+    EXPECT_EQ(expected, dc.solve());
+}
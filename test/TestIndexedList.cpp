@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "IndexedList.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::IndexedList;
+
+class TestIndexedList : public testing::Test
+{
+protected:
+    IndexedList<string> list;
+    IndexedList<string> a;
+    IndexedList<string> b;
+    IndexedList<string> c;
+    string str;
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+
+    void insert_n(IndexedList<string>& s, int n, bool from_back = true)
+    {
+        if (from_back)
+        {
+            for (int i = 0; i < n; ++i)
+                s.insert_back(std::to_string(i));
+        }
+        else
+        {
+            for (int i = 0; i < n; ++i)
+                s.insert_front(std::to_string(i));
+        }
+    }
+};
+
+TEST_F(TestIndexedList, Basic)
+{
+    EXPECT_NO_THROW({
+        IndexedList<string> s1;
+        IndexedList<string> s2(s1);
+        IndexedList<string> s3{IndexedList<string>()};
+
+        s1 = s2;
+        s2 = IndexedList<string>();
+    });
+}
+
+TEST_F(TestIndexedList, ElementAccess)
+{
+    EXPECT_THROW(list.front(), std::out_of_range);
+    EXPECT_THROW(list.back(), std::out_of_range);
+    EXPECT_THROW(list.at(0), std::out_of_range);
+    insert_n(list, scale);
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), list.at(i));
+    EXPECT_EQ("0", list.front());
+    EXPECT_EQ(std::to_string(scale - 1), list.back());
+    EXPECT_THROW(list.at(-1), std::out_of_range);
+    EXPECT_THROW(list.at(scale), std::out_of_range);
+}
+
+TEST_F(TestIndexedList, Iterators)
+{
+    EXPECT_EQ(list.begin(), list.end());
+    insert_n(list, scale);
+
+    auto bg = list.begin();
+    auto ed = list.end();
+
+    for (int i = 0; i < scale; ++i)
+    {
+        EXPECT_EQ(i, list.rank(bg));
+        EXPECT_EQ(std::to_string(i), *bg++);
+    }
+    EXPECT_EQ(bg, list.end());
+    EXPECT_EQ(scale, list.rank(bg));
+    for (int i = scale - 1; i >= 0; --i)
+        EXPECT_EQ(std::to_string(i), *--ed);
+    EXPECT_EQ(ed, list.begin());
+}
+
+TEST_F(TestIndexedList, Positional)
+{
+    std::vector<int> expected;
+    IndexedList<int> x;
+    unsigned state = 12345;
+    auto next = [&state](int bound) {
+        state = state * 1103515245 + 12345;
+        return int((state >> 8) % unsigned(bound));
+    };
+
+    // 与std::vector对照随机的添加与移除
+    for (int step = 0; step < 4000; ++step)
+    {
+        if (expected.empty() || next(3) != 0)
+        {
+            int i = next(int(expected.size()) + 1);
+            expected.insert(expected.begin() + i, step);
+            x.insert_at(i, step);
+        }
+        else
+        {
+            int i = next(int(expected.size()));
+            expected.erase(expected.begin() + i);
+            x.erase_at(i);
+        }
+    }
+    ASSERT_EQ(int(expected.size()), x.size());
+    for (int i = 0; i < x.size(); ++i)
+        EXPECT_EQ(expected[i], x.at(i));
+    int i = 0;
+    for (auto it = x.begin(); it != x.end(); ++it, ++i)
+        EXPECT_EQ(i, x.rank(it));
+}
+
+TEST_F(TestIndexedList, Modifiers)
+{
+    EXPECT_THROW(list.remove_back(), std::out_of_range);
+    EXPECT_THROW(list.remove_front(), std::out_of_range);
+    EXPECT_THROW(list.insert_at(1, str), std::out_of_range);
+
+    insert_n(list, scale, false);
+    for (int i = scale - 1; i >= 0; --i)
+    {
+        EXPECT_EQ(std::to_string(i), list.front());
+        list.remove_front();
+    }
+    for (int i = 0; i < scale; ++i)
+        list.insert(list.end(), std::to_string(i));
+    for (int i = scale - 1; i >= 0; --i)
+    {
+        EXPECT_EQ(std::to_string(i), list.back());
+        list.remove(std::prev(list.end()));
+    }
+    EXPECT_TRUE(list.empty());
+
+    insert_n(list, scale);
+    a = a + list;
+    b += list;
+    EXPECT_TRUE(a == b);
+    b += b;
+    EXPECT_EQ(2 * scale, b.size());
+    EXPECT_EQ(std::to_string(scale - 1), b.at(2 * scale - 1));
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    insert_n(list, scale);
+    c.swap(list);
+    EXPECT_EQ(scale, c.size());
+    EXPECT_TRUE(list.empty());
+}
+
+TEST_F(TestIndexedList, Other)
+{
+    using std::swap;
+    insert_n(a, scale);
+    c = a;
+    EXPECT_TRUE(c == a && c != b);
+    b.swap(a);
+    EXPECT_TRUE(c != a && c == b);
+    swap(a, b);
+    EXPECT_TRUE(c == a && c != b);
+}
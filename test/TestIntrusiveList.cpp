@@ -0,0 +1,186 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "IntrusiveList.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::IntrusiveList;
+using cpplib::ListHook;
+using cpplib::UnsafeIntrusiveList;
+using cpplib::UnsafeListHook;
+
+// 同时位于两个链表中的对象
+struct Item
+{
+    string value;
+    ListHook hook;
+    ListHook other;
+    UnsafeListHook raw;
+
+    explicit Item(string value) : value(std::move(value)) {}
+};
+
+class TestIntrusiveList : public testing::Test
+{
+protected:
+    using List = IntrusiveList<Item, &Item::hook>;
+    using OtherList = IntrusiveList<Item, &Item::other>;
+    using RawList = UnsafeIntrusiveList<Item, &Item::raw>;
+
+    std::vector<Item> items;
+    List list;
+    List a;
+    List b;
+    int scale;
+public:
+    virtual void SetUp()
+    {
+        scale = 32;
+        items.reserve(scale);
+        for (int i = 0; i < scale; ++i)
+            items.emplace_back(std::to_string(i));
+    }
+    virtual void TearDown() {}
+
+    void insert_n(List& s, bool from_back = true)
+    {
+        for (auto& i : items)
+        {
+            if (from_back) s.insert_back(i);
+            else           s.insert_front(i);
+        }
+    }
+};
+
+TEST_F(TestIntrusiveList, ElementAccess)
+{
+    EXPECT_THROW(list.front(), std::out_of_range);
+    EXPECT_THROW(list.back(), std::out_of_range);
+    list.insert_back(items[0]);
+    list.insert_front(items[1]);
+    EXPECT_EQ("1", list.front().value);
+    EXPECT_EQ("0", list.back().value);
+    EXPECT_EQ(&items[0], &list.back());
+}
+
+TEST_F(TestIntrusiveList, Iterators)
+{
+    EXPECT_EQ(list.begin(), list.end());
+    insert_n(list);
+
+    auto bg = list.begin();
+    auto ed = list.end();
+
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), (bg++)->value);
+    EXPECT_EQ(bg, list.end());
+    for (int i = scale - 1; i >= 0; --i)
+        EXPECT_EQ(std::to_string(i), (*--ed).value);
+    EXPECT_EQ(ed, list.begin());
+    EXPECT_EQ("5", (*List::iterator_to(items[5])).value);
+}
+
+TEST_F(TestIntrusiveList, Modifiers)
+{
+    EXPECT_THROW(list.remove_back(), std::out_of_range);
+    EXPECT_THROW(list.remove_front(), std::out_of_range);
+
+    insert_n(list, false);
+    EXPECT_EQ(scale, list.size());
+    EXPECT_THROW(list.insert_back(items[0]), std::invalid_argument);
+    list.remove_front();
+    list.remove_back();
+    EXPECT_EQ(std::to_string(scale - 2), list.front().value);
+    EXPECT_EQ("1", list.back().value);
+    EXPECT_FALSE(items[0].hook.is_linked());
+
+    // 从任意位置断开，不需要链表对象
+    List::unlink(items[10]);
+    EXPECT_EQ(scale - 3, list.size());
+    for (auto it = list.begin(); it != list.end(); )
+    {
+        if (std::stoi(it->value) % 2 == 1) it = list.remove(it);
+        else                               ++it;
+    }
+    for (auto& i : list)
+        EXPECT_EQ(0, std::stoi(i.value) % 2);
+
+    list.insert(list.begin(), items[1]);
+    EXPECT_EQ("1", list.front().value);
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    for (auto& i : items)
+        EXPECT_FALSE(i.hook.is_linked());
+}
+
+TEST_F(TestIntrusiveList, MultipleHooks)
+{
+    OtherList other;
+    RawList raw;
+
+    insert_n(list);
+    for (auto& i : items)
+    {
+        other.insert_front(i);
+        raw.insert_back(i);
+    }
+    EXPECT_EQ(scale, list.size());
+    EXPECT_EQ(scale, other.size());
+    EXPECT_EQ(scale, raw.size());
+    EXPECT_EQ("0", list.front().value);
+    EXPECT_EQ(std::to_string(scale - 1), other.front().value);
+    EXPECT_EQ("0", raw.front().value);
+    list.remove_front();
+    EXPECT_EQ(scale, other.size());
+    raw.clear();
+}
+
+TEST_F(TestIntrusiveList, AutoUnlink)
+{
+    {
+        Item temp("temp");
+        insert_n(list);
+        list.insert(std::next(list.begin(), 3), temp);
+        EXPECT_EQ(scale + 1, list.size());
+    }
+    // temp析构时自动从链表断开
+    EXPECT_EQ(scale, list.size());
+    int expected = 0;
+    for (auto& i : list)
+        EXPECT_EQ(std::to_string(expected++), i.value);
+}
+
+TEST_F(TestIntrusiveList, DoubleUnlink)
+{
+    insert_n(list);
+    // 安全模式下重复断开和断开未链接的钩子都被忽略
+    List::unlink(items[5]);
+    List::unlink(items[5]);
+    items[6].hook.unlink();
+    items[6].hook.unlink();
+    EXPECT_EQ(scale - 2, list.size());
+    Item lone("lone");
+    List::unlink(lone);
+    EXPECT_FALSE(lone.hook.is_linked());
+    list.insert_back(items[5]);
+    EXPECT_EQ("5", list.back().value);
+    EXPECT_EQ(scale - 1, list.size());
+}
+
+TEST_F(TestIntrusiveList, Other)
+{
+    using std::swap;
+    insert_n(a);
+    b.swap(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(scale, b.size());
+    swap(a, b);
+    EXPECT_EQ(scale, a.size());
+    EXPECT_EQ("0", a.front().value);
+
+    List c(std::move(a));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(scale, c.size());
+    EXPECT_EQ(std::to_string(scale - 1), c.back().value);
+}
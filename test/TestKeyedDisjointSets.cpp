@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <string>
+#include "KeyedDisjointSets.h"
+#include "gtest/gtest.h"
+
+using cpplib::KeyedDisjointSets;
+
+class TestKeyedDisjointSets : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 100000; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestKeyedDisjointSets, String)
+{
+    KeyedDisjointSets<std::string> uf;
+
+    EXPECT_TRUE(uf.join("alice", "bob"));
+    EXPECT_TRUE(uf.join("carol", "dave"));
+    EXPECT_FALSE(uf.join("bob", "alice"));
+    EXPECT_EQ(4, uf.size());
+    EXPECT_EQ(2, uf.count());
+    EXPECT_TRUE(uf.connected("alice", "bob"));
+    EXPECT_FALSE(uf.connected("alice", "carol"));
+    // 没出现过的键不会被添加
+    EXPECT_FALSE(uf.connected("alice", "eve"));
+    EXPECT_TRUE(uf.connected("eve", "eve"));
+    EXPECT_FALSE(uf.contains("eve"));
+    EXPECT_EQ(-1, uf.lookup("eve"));
+    EXPECT_EQ(2, uf.lookup("carol"));
+    EXPECT_EQ("carol", uf.key(2));
+    EXPECT_EQ(uf.find("dave"), uf.find("carol"));
+    EXPECT_EQ("eve", uf.find("eve"));
+    EXPECT_EQ(5, uf.size());
+    EXPECT_THROW(uf.key(5), std::out_of_range);
+}
+
+TEST_F(TestKeyedDisjointSets, Stream)
+{
+    KeyedDisjointSets<uint64_t> uf;
+
+    // 键是稀疏的64位整数，每个新键与之前的某个键合并，奇数轮次的键单独成组
+    for (int i = 0; i < scale; ++i)
+    {
+        uint64_t key = uint64_t(i) * 0x9e3779b97f4a7c15ULL;
+        if (i % 2 == 0 && i > 0)
+            EXPECT_TRUE(uf.join(key, uint64_t(i / 2 & ~1) * 0x9e3779b97f4a7c15ULL));
+        else
+            EXPECT_EQ(i, uf.index(key));
+    }
+    EXPECT_EQ(scale, uf.size());
+    EXPECT_EQ(scale / 2 + 1, uf.count());
+    for (int i = 0; i < scale; i += 7)
+    {
+        uint64_t key = uint64_t(i) * 0x9e3779b97f4a7c15ULL;
+        EXPECT_EQ(i, uf.lookup(key));
+        EXPECT_EQ(i % 2 == 0, uf.connected(key, 0));
+    }
+}
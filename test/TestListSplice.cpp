@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include "List.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::List;
+
+class TestListSplice : public testing::Test
+{
+protected:
+    List<string> a;
+    List<string> b;
+    List<string> c;
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+
+    void insert_n(List<string>& s, int n)
+    {
+        for (int i = 0; i < n; ++i)
+            s.insert_back(std::to_string(i));
+    }
+};
+
+TEST_F(TestListSplice, Splice)
+{
+    insert_n(a, scale);
+    insert_n(b, scale);
+    a.splice(std::next(a.begin(), 3), b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(2 * scale, a.size());
+
+    auto it = a.begin();
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(std::to_string(i), *it++);
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), *it++);
+    for (int i = 3; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), *it++);
+    EXPECT_EQ(a.end(), it);
+
+    // 单个元素与区间
+    b.splice(b.end(), a, a.begin());
+    EXPECT_EQ(1, b.size());
+    EXPECT_EQ("0", b.front());
+    b.splice(b.begin(), a, a.begin(), std::next(a.begin(), 2));
+    EXPECT_EQ(3, b.size());
+    EXPECT_EQ(2 * scale - 3, a.size());
+    EXPECT_EQ("1", b.front());
+    EXPECT_EQ("0", b.back());
+    b.splice(b.end(), b, b.begin());
+    EXPECT_EQ("1", b.back());
+    EXPECT_THROW(b.splice(b.begin(), a, a.end()), std::out_of_range);
+
+    // d析构后，转移到c的结点仍然有效
+    {
+        List<string> d;
+        insert_n(d, scale);
+        c += std::move(d);
+        EXPECT_TRUE(d.empty());
+    }
+    EXPECT_EQ(scale, c.size());
+    c.remove_front();
+    c.insert_back("x");
+    EXPECT_EQ("x", c.back());
+}
+
+TEST_F(TestListSplice, SpliceInPlace)
+{
+    // 同一链表内pos等于first或last时，区间已在原位，链表不变
+    insert_n(a, 5);
+    auto first = std::next(a.begin(), 1);
+    auto last = std::next(a.begin(), 3);
+    a.splice(first, a, first, last);
+    a.splice(last, a, first, last);
+    EXPECT_EQ(5, a.size());
+    int i = 0;
+    for (auto it = a.begin(); it != a.end(); ++it)
+        EXPECT_EQ(std::to_string(i++), *it);
+    EXPECT_EQ(5, i);
+    for (auto it = a.end(); it != a.begin(); )
+        EXPECT_EQ(std::to_string(--i), *--it);
+}
+
+TEST_F(TestListSplice, Sort)
+{
+    for (int i = scale - 1; i >= 0; --i)
+        a.insert_back(std::to_string(i % 10));
+    a.sort();
+    EXPECT_EQ(scale, a.size());
+    EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+    for (auto it = a.end(); it != a.begin(); --it)
+        EXPECT_EQ(it, std::next(std::prev(it)));
+
+    // 稳定性：按首字符排序后相等元素保持原有次序
+    for (int i = 0; i < scale; ++i)
+        b.insert_back(std::to_string(i));
+    b.sort([](const string& x, const string& y) { return x[0] < y[0]; });
+    EXPECT_EQ("1", *std::next(b.begin()));
+    EXPECT_EQ("10", *std::next(b.begin(), 2));
+
+    c.insert_back("0");
+    c.insert_back("5");
+    c.insert_back("9");
+    a.merge(c);
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(scale + 3, a.size());
+    EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+}
+
+TEST_F(TestListSplice, SharedPools)
+{
+    // 在两个链表间反复拼接，结点始终由转入方的结点池释放和复用
+    insert_n(a, scale);
+    for (int round = 0; round < scale; ++round)
+    {
+        b.splice(b.end(), a, a.begin());
+        a.splice(a.end(), b);
+    }
+    EXPECT_EQ(scale, a.size());
+    EXPECT_TRUE(b.empty());
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), *std::next(a.begin(), i));
+    a.remove_front();
+    a.insert_back("x");
+    EXPECT_EQ("x", a.back());
+
+    // 转出结点的链表先析构，转入的结点和复用的槽位仍然有效
+    {
+        List<string> d;
+        insert_n(d, scale);
+        b.splice(b.end(), d, d.begin(), std::next(d.begin(), scale / 2));
+        c.merge(d);
+    }
+    EXPECT_EQ(scale / 2, b.size());
+    EXPECT_EQ(scale - scale / 2, c.size());
+    b.clear();
+    insert_n(b, scale);
+    EXPECT_EQ(std::to_string(scale - 1), b.back());
+
+    // 转入结点的链表先析构，转出方的结点池不受影响
+    {
+        List<string> e;
+        e.splice(e.end(), c);
+        e.merge(b);
+        EXPECT_EQ(scale + scale - scale / 2, e.size());
+    }
+    EXPECT_TRUE(b.empty() && c.empty());
+    insert_n(c, scale);
+    EXPECT_EQ(scale, c.size());
+}
+
+TEST_F(TestListSplice, NewPool)
+{
+    using NewList = List<string, cpplib::NewPool<cpplib::ListNode<string>>>;
+    NewList x;
+    NewList y;
+
+    for (int i = 0; i < scale; ++i)
+        x.insert_back(std::to_string(i));
+    y.splice(y.end(), x, std::next(x.begin()), x.end());
+    EXPECT_EQ(1, x.size());
+    EXPECT_EQ(scale - 1, y.size());
+    NewList z(y);
+    x.merge(z);
+    EXPECT_TRUE(z.empty());
+    EXPECT_EQ(scale, x.size());
+    EXPECT_EQ("0", x.front());
+    EXPECT_EQ(std::to_string(scale - 1), x.back());
+}
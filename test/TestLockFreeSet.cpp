@@ -0,0 +1,206 @@
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LockFreeSet.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::LockFreeSet;
+using cpplib::EpochReclaimer;
+using cpplib::HazardReclaimer;
+
+// 统计存活对象数量的元素，用于检查结点是否都被回收
+struct Counted
+{
+    static std::atomic<int> alive;
+    int value;
+    Counted(int value) : value(value) { alive++; }
+    Counted(const Counted& that) : value(that.value) { alive++; }
+    ~Counted() { alive--; }
+    bool operator<(const Counted& that) const { return value < that.value; }
+};
+std::atomic<int> Counted::alive(0);
+
+// 遇到负数时抛出异常的比较函数
+struct ThrowingLess
+{
+    bool operator()(const Counted& a, const Counted& b) const
+    {
+        if (a.value < 0 || b.value < 0)
+            throw std::invalid_argument("ThrowingLess");
+        return a.value < b.value;
+    }
+};
+
+class TestLockFreeSet : public testing::Test
+{
+protected:
+    int scale;
+    int threads;
+public:
+    virtual void SetUp() { scale = 32; threads = 4; }
+    virtual void TearDown() {}
+
+    template<typename Set>
+    void basic(Set& set)
+    {
+        EXPECT_TRUE(set.empty());
+        for (int i = scale - 1; i >= 0; --i)
+            EXPECT_TRUE(set.insert(std::to_string(i)));
+        for (int i = 0; i < scale; ++i)
+            EXPECT_FALSE(set.insert(std::to_string(i)));
+        EXPECT_EQ(scale, set.size());
+        for (int i = 0; i < scale; ++i)
+            EXPECT_TRUE(set.contains(std::to_string(i)));
+        EXPECT_FALSE(set.contains("x"));
+
+        string last;
+        int count = 0;
+        set.for_each([&](const string& s)
+        {
+            EXPECT_LT(last, s);
+            last = s;
+            count++;
+        });
+        EXPECT_EQ(scale, count);
+
+        for (int i = 0; i < scale; i += 2)
+            EXPECT_TRUE(set.remove(std::to_string(i)));
+        for (int i = 0; i < scale; ++i)
+            EXPECT_EQ(i % 2 == 1, set.contains(std::to_string(i)));
+        EXPECT_FALSE(set.remove("0"));
+        EXPECT_EQ(scale / 2, set.size());
+    }
+
+    // 每个线程在共享的键范围内随机添加和移除元素，同时维护自己独占的键
+    template<typename Reclaimer>
+    void stress()
+    {
+        const int rounds = 20000;
+        const int range = 64;
+        {
+            LockFreeSet<Counted, Reclaimer> set;
+            std::atomic<int> inserted(0);
+            std::atomic<int> removed(0);
+            std::vector<std::thread> workers;
+
+            for (int t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&, t]
+                {
+                    unsigned x = t + 1;
+                    int own = range + t; // 每个线程独占的键
+                    for (int i = 0; i < rounds; ++i)
+                    {
+                        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+                        int key = x % range;
+                        switch (x >> 30)
+                        {
+                        case 0: if (set.insert(key)) inserted++; break;
+                        case 1: if (set.remove(key)) removed++; break;
+                        default: set.contains(key); break;
+                        }
+                        if (i % 2 == 0) EXPECT_TRUE(set.insert(own));
+                        else            EXPECT_TRUE(set.remove(own));
+                    }
+                });
+            }
+            for (auto& w : workers)
+                w.join();
+
+            int count = 0;
+            int last = -1;
+            set.for_each([&](const Counted& c)
+            {
+                EXPECT_LT(last, c.value);
+                last = c.value;
+                count++;
+            });
+            EXPECT_EQ(inserted - removed, count);
+            EXPECT_EQ(count, set.size());
+            EXPECT_LT(last, range);
+        }
+        EXPECT_EQ(0, Counted::alive);
+    }
+};
+
+TEST_F(TestLockFreeSet, Basic)
+{
+    LockFreeSet<string, EpochReclaimer> epoch;
+    LockFreeSet<string, HazardReclaimer> hazard;
+
+    basic(epoch);
+    basic(hazard);
+}
+
+TEST_F(TestLockFreeSet, Compare)
+{
+    LockFreeSet<int, EpochReclaimer, std::greater<int>> set;
+    std::vector<int> order;
+
+    for (int i = 0; i < scale; ++i)
+        set.insert(i);
+    set.for_each([&](int i) { order.push_back(i); });
+    ASSERT_EQ(scale, static_cast<int>(order.size()));
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(scale - 1 - i, order[i]);
+}
+
+TEST_F(TestLockFreeSet, ThrowingCompare)
+{
+    // 比较函数抛出异常时，尚未发布的新结点被释放
+    {
+        LockFreeSet<Counted, HazardReclaimer, ThrowingLess> set;
+        set.insert(Counted(1));
+        EXPECT_THROW(set.insert(Counted(-1)), std::invalid_argument);
+        EXPECT_EQ(1, set.size());
+        EXPECT_EQ(1, Counted::alive);
+    }
+    EXPECT_EQ(0, Counted::alive);
+}
+
+TEST_F(TestLockFreeSet, NestedGuard)
+{
+    // 回调中的操作使用内层Guard，删除足够多的结点触发扫描时，for_each访问的结点仍受保护
+    LockFreeSet<int, HazardReclaimer> set;
+    std::vector<int> order;
+
+    for (int i = 0; i < 8 * scale; ++i)
+        set.insert(i);
+    set.for_each([&](int i)
+    {
+        order.push_back(i);
+        if (i == 0)
+        {
+            for (int j = 0; j < 4 * scale; ++j)
+                EXPECT_TRUE(set.remove(j));
+        }
+        EXPECT_FALSE(set.contains(0));
+    });
+    ASSERT_EQ(4 * scale + 1, static_cast<int>(order.size()));
+    EXPECT_EQ(0, order[0]);
+    for (int i = 1; i <= 4 * scale; ++i)
+        EXPECT_EQ(4 * scale - 1 + i, order[i]);
+
+    // 每个线程最多嵌套DEPTH层
+    HazardReclaimer domain;
+    std::vector<std::unique_ptr<HazardReclaimer::Guard>> guards;
+    for (int i = 0; i < HazardReclaimer::DEPTH; ++i)
+        guards.emplace_back(new HazardReclaimer::Guard(domain));
+    EXPECT_THROW(HazardReclaimer::Guard extra(domain), std::length_error);
+    guards.pop_back();
+    EXPECT_NO_THROW(HazardReclaimer::Guard extra(domain));
+}
+
+TEST_F(TestLockFreeSet, EpochStress)
+{
+    stress<EpochReclaimer>();
+}
+
+TEST_F(TestLockFreeSet, HazardStress)
+{
+    stress<HazardReclaimer>();
+}
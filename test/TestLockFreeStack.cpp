@@ -0,0 +1,136 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LockFreeStack.h"
+#include "Stack.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::LockFreeStack;
+using cpplib::EpochReclaimer;
+using cpplib::HazardReclaimer;
+
+// 统计存活对象数量的元素，用于检查结点是否都被回收.
+// 放在匿名名字空间中，避免与汇总的Test中其它测试的同名类型冲突
+namespace
+{
+struct Counted
+{
+    static std::atomic<int> alive;
+    int value;
+    Counted(int value = -1) : value(value) { alive++; }
+    Counted(const Counted& that) : value(that.value) { alive++; }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() { alive--; }
+};
+std::atomic<int> Counted::alive(0);
+} // namespace
+
+class TestLockFreeStack : public testing::Test
+{
+protected:
+    int scale;
+    int threads;
+public:
+    virtual void SetUp() { scale = 32; threads = 4; }
+    virtual void TearDown() {}
+
+    template<typename S>
+    void basic(S& stack)
+    {
+        string str;
+
+        EXPECT_TRUE(stack.empty());
+        EXPECT_FALSE(stack.try_remove_back(str));
+        for (int i = 0; i < scale; ++i)
+            stack.insert_back(std::to_string(i));
+        EXPECT_EQ(size_t(scale), stack.size());
+        for (int i = scale - 1; i >= scale / 2; --i)
+        {
+            EXPECT_TRUE(stack.try_remove_back(str));
+            EXPECT_EQ(std::to_string(i), str);
+        }
+        EXPECT_EQ(size_t(scale / 2), stack.size());
+        // 析构时销毁剩余元素
+    }
+
+    // 每个线程交替入栈和出栈，检查每个元素恰好出栈一次且结点都被回收
+    template<typename Reclaimer>
+    void stress(int width)
+    {
+        const int count = 20000;
+        {
+            LockFreeStack<Counted, Reclaimer> stack(width);
+            std::vector<std::atomic<int>> seen(threads * count);
+            std::vector<std::thread> workers;
+
+            for (auto& i : seen)
+                i.store(0);
+            for (int t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&, t]
+                {
+                    Counted elem;
+                    for (int i = 0; i < count; ++i)
+                    {
+                        stack.insert_back(Counted(t * count + i));
+                        if (i % 3 != 0 && stack.try_remove_back(elem))
+                            seen[elem.value]++;
+                    }
+                });
+            }
+            for (auto& w : workers)
+                w.join();
+            Counted elem;
+            while (stack.try_remove_back(elem))
+                seen[elem.value]++;
+            EXPECT_TRUE(stack.empty());
+            EXPECT_EQ(0u, stack.size());
+            for (auto& i : seen)
+                EXPECT_EQ(1, i.load());
+        }
+        EXPECT_EQ(0, Counted::alive.load());
+    }
+};
+
+TEST_F(TestLockFreeStack, Basic)
+{
+    LockFreeStack<string> a;
+    LockFreeStack<string, EpochReclaimer> b(0);
+    LockFreeStack<string, HazardReclaimer> c(4);
+
+    EXPECT_EQ(0, b.elimination_width());
+    EXPECT_EQ(4, c.elimination_width());
+    basic(a);
+    basic(b);
+    basic(c);
+}
+
+TEST_F(TestLockFreeStack, StackFacade)
+{
+    ConcurrentStack<string> stack;
+    string str;
+
+    stack.push("0");
+    stack.push("1");
+    EXPECT_EQ(2u, stack.size());
+    EXPECT_TRUE(stack.try_pop(str));
+    EXPECT_EQ("1", str);
+    EXPECT_TRUE(stack.try_pop(str));
+    EXPECT_EQ("0", str);
+    EXPECT_FALSE(stack.try_pop(str));
+    EXPECT_TRUE(stack.empty());
+}
+
+TEST_F(TestLockFreeStack, Concurrent)
+{
+    stress<HazardReclaimer>(0);
+    stress<EpochReclaimer>(0);
+}
+
+TEST_F(TestLockFreeStack, Elimination)
+{
+    stress<HazardReclaimer>(2);
+    stress<EpochReclaimer>(2);
+}
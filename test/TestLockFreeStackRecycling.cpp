@@ -0,0 +1,151 @@
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include "LockFreeStack.h"
+#include "gtest/gtest.h"
+
+using cpplib::LockFreeStack;
+using cpplib::EpochReclaimer;
+using cpplib::HazardReclaimer;
+
+// 统计存活对象数量的元素，用于检查结点是否都被回收
+struct Counted
+{
+    static std::atomic<int> alive;
+    int value;
+    Counted(int value = -1) : value(value) { alive++; }
+    Counted(const Counted& that) : value(that.value) { alive++; }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() { alive--; }
+};
+std::atomic<int> Counted::alive(0);
+
+// 回收小块内存的全局分配器，释放的块按后进先出立即复用，使结点地址尽快重复出现.
+// 它替换了整个程序的operator new/delete，所以本文件单独编译，不链接进汇总的Test
+namespace recycling
+{
+const size_t HEADER = 16;      // 块头，记录块的大小，保持16字节对齐
+const size_t SMALL = 64;       // 可回收块的大小
+std::atomic<bool> enabled(false);
+std::mutex lock;
+void* free_list = nullptr;     // 空闲块链表，链接指针存放在块内
+
+// 作用域结束时停止回收并归还空闲块
+struct Scope
+{
+    Scope() { enabled = true; }
+    ~Scope()
+    {
+        enabled = false;
+        std::lock_guard<std::mutex> guard(lock);
+        while (free_list != nullptr)
+        {
+            void* block = free_list;
+            free_list = *static_cast<void**>(block);
+            std::free(static_cast<char*>(block) - HEADER);
+        }
+    }
+};
+} // namespace recycling
+
+void* operator new(size_t size)
+{
+    using namespace recycling;
+    if (enabled && size <= SMALL)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (free_list != nullptr)
+        {
+            void* block = free_list;
+            free_list = *static_cast<void**>(block);
+            return block;
+        }
+        size = SMALL;
+    }
+    char* raw = static_cast<char*>(std::malloc(HEADER + (size == 0 ? 1 : size)));
+    if (raw == nullptr)
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(raw) = size;
+    return raw + HEADER;
+}
+
+void operator delete(void* block) noexcept
+{
+    using namespace recycling;
+    if (block == nullptr)
+        return;
+    char* raw = static_cast<char*>(block) - HEADER;
+    if (enabled && *reinterpret_cast<size_t*>(raw) == SMALL)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        *static_cast<void**>(block) = free_list;
+        free_list = block;
+        return;
+    }
+    std::free(raw);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    operator delete(block);
+}
+
+class TestLockFreeStackRecycling : public testing::Test
+{
+protected:
+    int scale;
+    int threads;
+public:
+    virtual void SetUp() { scale = 32; threads = 4; }
+    virtual void TearDown() {}
+
+    // 每个线程交替入栈和出栈，检查每个元素恰好出栈一次且结点都被回收
+    template<typename Reclaimer>
+    void stress(int width)
+    {
+        const int count = 20000;
+        {
+            LockFreeStack<Counted, Reclaimer> stack(width);
+            std::vector<std::atomic<int>> seen(threads * count);
+            std::vector<std::thread> workers;
+
+            for (auto& i : seen)
+                i.store(0);
+            for (int t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&, t]
+                {
+                    Counted elem;
+                    for (int i = 0; i < count; ++i)
+                    {
+                        stack.insert_back(Counted(t * count + i));
+                        if (i % 3 != 0 && stack.try_remove_back(elem))
+                            seen[elem.value]++;
+                    }
+                });
+            }
+            for (auto& w : workers)
+                w.join();
+            Counted elem;
+            while (stack.try_remove_back(elem))
+                seen[elem.value]++;
+            EXPECT_TRUE(stack.empty());
+            EXPECT_EQ(0u, stack.size());
+            for (auto& i : seen)
+                EXPECT_EQ(1, i.load());
+        }
+        EXPECT_EQ(0, Counted::alive.load());
+    }
+};
+
+TEST_F(TestLockFreeStackRecycling, RecycledNodes)
+{
+    // 被取走并释放的结点立即被其它线程复用，消除槽位不能把复用的地址当作自己的结点
+    recycling::Scope scope;
+    stress<HazardReclaimer>(1);
+    stress<EpochReclaimer>(1);
+    stress<HazardReclaimer>(2);
+}
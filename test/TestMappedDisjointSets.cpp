@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "MappedDisjointSets.h"
+#include "QuickUnion.h"
+#include "UnionFind.h"
+#include "WeightedUnion.h"
+#include "gtest/gtest.h"
+
+using cpplib::DisjointSets;
+using cpplib::MappedDisjointSets;
+// 记录成员环的UnionFind
+using TrackedUnionFind = DisjointSets<int, cpplib::LinkByRank, cpplib::CompressHalving, true>;
+
+class TestMappedDisjointSets : public testing::Test
+{
+protected:
+    int scale;
+    std::string path;
+public:
+    virtual void SetUp()
+    {
+        scale = 5000;
+        path = testing::TempDir() + "TestMappedDisjointSets.snapshot";
+    }
+    virtual void TearDown() { std::remove(path.c_str()); }
+};
+
+TEST_F(TestMappedDisjointSets, Query)
+{
+    int n = scale;
+    TrackedUnionFind uf(n);
+    for (int i = 0; i < n; i += 2)
+        uf.join(i, (i * 31 + 17) % n);
+    uf.save(path);
+
+    MappedDisjointSets<> mapped(path);
+    EXPECT_EQ(n, mapped.size());
+    EXPECT_EQ(uf.count(), mapped.count());
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_EQ(uf.find(i), mapped.find(i));
+        EXPECT_EQ(uf.component_size(i), mapped.component_size(i));
+    }
+    EXPECT_EQ(uf.members(4), mapped.members(4));
+    EXPECT_TRUE(mapped.connected(0, 17));
+    EXPECT_THROW(mapped.find(n), std::out_of_range);
+    EXPECT_THROW(mapped.members(-1), std::out_of_range);
+}
+
+TEST_F(TestMappedDisjointSets, Compress)
+{
+    // QuickUnion不压缩路径，保存前compress()后每个触点直接指向根
+    int n = scale;
+    QuickUnion uf(n);
+    for (int i = 1; i < n; ++i)
+        uf.join(i - 1, i);
+    uf.save(path);
+    {
+        MappedDisjointSets<> mapped(path);
+        EXPECT_FALSE(mapped.flat());
+        EXPECT_EQ(1, mapped.count());
+        EXPECT_EQ(mapped.find(0), mapped.find(n - 1));
+    }
+    uf.compress();
+    uf.save(path);
+    MappedDisjointSets<> mapped(path);
+    EXPECT_TRUE(mapped.flat());
+    EXPECT_EQ(uf.find(0), mapped.find(0));
+    EXPECT_EQ(uf.find(0), mapped.find(n / 2));
+}
+
+TEST_F(TestMappedDisjointSets, Untracked)
+{
+    // 不记录成员的快照只有parent数组，LinkBySize的分量大小从根结点读出
+    int n = scale;
+    WeightedUnion weighted(n);
+    UnionFind uf(n);
+    for (int i = 0; i < n; i += 3)
+    {
+        weighted.join(i, n - 1 - i);
+        uf.join(i, n - 1 - i);
+    }
+    weighted.save(path);
+    {
+        MappedDisjointSets<> mapped(path);
+        for (int i = 0; i < n; ++i)
+            EXPECT_EQ(weighted.component_size(i), mapped.component_size(i));
+        EXPECT_THROW(mapped.members(0), std::invalid_argument);
+    }
+    uf.save(path);
+    MappedDisjointSets<> mapped(path);
+    EXPECT_EQ(uf.count(), mapped.count());
+    EXPECT_EQ(uf.find(n - 1), mapped.find(n - 1));
+    EXPECT_THROW(mapped.component_size(0), std::invalid_argument);
+}
+
+TEST_F(TestMappedDisjointSets, Invalid)
+{
+    UnionFind uf(10);
+    uf.save(path);
+    EXPECT_THROW(MappedDisjointSets<long long> wide(path), std::invalid_argument);
+
+    // 截断的文件
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream(path, std::ios::binary).write(bytes.data(), std::streamsize(bytes.size() - 4));
+    EXPECT_THROW(MappedDisjointSets<> truncated(path), std::runtime_error);
+
+    // 不是快照文件
+    bytes[0] = 'X';
+    std::ofstream(path, std::ios::binary).write(bytes.data(), std::streamsize(bytes.size()));
+    EXPECT_THROW(MappedDisjointSets<> garbage(path), std::invalid_argument);
+    EXPECT_THROW(MappedDisjointSets<> missing(path + ".missing"), std::runtime_error);
+
+    UnionFind().save(path);
+    EXPECT_EQ(0, MappedDisjointSets<>(path).size());
+}
+
+TEST_F(TestMappedDisjointSets, Alignment)
+{
+    // 5个short只占10字节，每个数组补齐到16字节，后面的数组仍从8字节对齐的位置开始
+    DisjointSets<short, cpplib::LinkByRank, cpplib::CompressHalving, true> uf(5);
+    uf.join(0, 4);
+    uf.join(1, 4);
+    uf.save(path);
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(std::streamoff(sizeof(cpplib::DisjointSetsHeader) + 3 * 16), std::streamoff(in.tellg()));
+    in.close();
+
+    MappedDisjointSets<short> mapped(path);
+    EXPECT_EQ(3, mapped.component_size(1));
+    EXPECT_EQ(3u, mapped.members(4).size());
+    EXPECT_EQ(uf.find(0), mapped.find(1));
+    auto loaded = decltype(uf)::load(path);
+    EXPECT_EQ(uf.members(0), loaded.members(0));
+}
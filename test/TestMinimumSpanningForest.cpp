@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "MinimumSpanningForest.h"
+#include "UnionFind.h"
+#include "gtest/gtest.h"
+
+using cpplib::MinimumSpanningForest;
+
+class TestMinimumSpanningForest : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 2000; }
+    virtual void TearDown() {}
+};
+
+// 把森林的边表示为排序后的(权值, u, v)，便于比较
+template<typename W>
+static std::vector<std::tuple<W, int, int>> canonical(const std::vector<typename MinimumSpanningForest<W>::Edge>& edges)
+{
+    std::vector<std::tuple<W, int, int>> result;
+    for (auto& e : edges)
+        result.emplace_back(e.weight, std::min(e.u, e.v), std::max(e.u, e.v));
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// 用std::sort排序的Kruskal算法
+template<typename W>
+static std::vector<typename MinimumSpanningForest<W>::Edge> reference(
+    int n, const std::vector<typename MinimumSpanningForest<W>::Edge>& edges)
+{
+    std::vector<size_t> order(edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return edges[a].weight < edges[b].weight; });
+    UnionFind uf(n);
+    std::vector<typename MinimumSpanningForest<W>::Edge> forest;
+    for (size_t i : order)
+        if (uf.join(edges[i].u, edges[i].v))
+            forest.push_back(edges[i]);
+    return forest;
+}
+
+template<typename W>
+static std::vector<typename MinimumSpanningForest<W>::Edge> random_edges(int n, size_t m, W lo, W hi, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_real_distribution<double> weight(static_cast<double>(lo), static_cast<double>(hi));
+    std::vector<typename MinimumSpanningForest<W>::Edge> edges(m);
+    for (auto& e : edges)
+        e = { vertex(gen), vertex(gen), W(weight(gen)) };
+    return edges;
+}
+
+TEST_F(TestMinimumSpanningForest, Small)
+{
+    using MSF = MinimumSpanningForest<int>;
+    // 0-1-2-3成环，4-5单独一棵树，6孤立
+    std::vector<MSF::Edge> edges =
+    {
+        { 0, 1, 4 }, { 1, 2, -2 }, { 2, 3, 3 }, { 3, 0, 1 }, { 0, 2, 5 },
+        { 4, 5, 7 }, { 5, 4, 6 }, { 3, 3, -9 }
+    };
+    for (auto algorithm : { MSF::Algorithm::kruskal, MSF::Algorithm::boruvka })
+    {
+        MSF msf(7, edges, algorithm, 2);
+        EXPECT_EQ(7, msf.vertices());
+        EXPECT_EQ(3, msf.count());
+        EXPECT_EQ(4u, msf.edges().size());
+        EXPECT_EQ(-2 + 1 + 3 + 6, msf.weight());
+    }
+    MSF kruskal(7, edges);
+    EXPECT_EQ(-2, kruskal.edges()[0].weight);
+    EXPECT_EQ(6, kruskal.edges()[3].weight);
+    MSF boruvka(7, edges, MSF::Algorithm::boruvka);
+    EXPECT_EQ(-2, boruvka.edges()[0].weight);
+    EXPECT_EQ(6, boruvka.edges()[3].weight);
+
+    EXPECT_EQ(0, MSF(0, {}).count());
+    EXPECT_EQ(5, MSF(5, {}, MSF::Algorithm::boruvka).count());
+    EXPECT_THROW(MSF(3, { { 0, 3, 1 } }), std::out_of_range);
+    EXPECT_THROW(MSF(3, { { -1, 0, 1 } }, MSF::Algorithm::boruvka), std::out_of_range);
+}
+
+TEST_F(TestMinimumSpanningForest, Double)
+{
+    using MSF = MinimumSpanningForest<double>;
+    int n = scale * 10;
+    // 边数少于触点数时得到很多棵树，GRAIN以上的边数会分给多个线程
+    for (size_t m : { size_t(n / 2), size_t(n) * 4, size_t(n) * 20 })
+    {
+        auto edges = random_edges<double>(n, m, -1e6, 1e6, unsigned(m));
+        auto expected = canonical<double>(reference<double>(n, edges));
+        for (unsigned threads : { 1u, 4u })
+        {
+            MSF kruskal(n, edges, MSF::Algorithm::kruskal, threads);
+            MSF boruvka(n, edges, MSF::Algorithm::boruvka, threads);
+            EXPECT_EQ(expected, canonical<double>(kruskal.edges()));
+            EXPECT_EQ(expected, canonical<double>(boruvka.edges()));
+            EXPECT_EQ(n - int(expected.size()), kruskal.count());
+            EXPECT_NEAR(kruskal.weight(), boruvka.weight(), 1e-9 * std::abs(kruskal.weight()));
+            EXPECT_TRUE(std::is_sorted(kruskal.edges().begin(), kruskal.edges().end(),
+                                       [](const MSF::Edge& a, const MSF::Edge& b) { return a.weight < b.weight; }));
+        }
+    }
+}
+
+TEST_F(TestMinimumSpanningForest, Ties)
+{
+    // 权值只有几种，相等时按下标比较，两种算法选出同一组边
+    int n = scale;
+    auto edges = random_edges<float>(n, size_t(n) * 50, -3.0f, 3.0f, 7);
+    for (auto& e : edges)
+        e.weight = float(int(e.weight));
+    using MSF = MinimumSpanningForest<float>;
+    MSF kruskal(n, edges, MSF::Algorithm::kruskal, 3);
+    MSF boruvka(n, edges, MSF::Algorithm::boruvka, 3);
+    auto expected = reference<float>(n, edges);
+    ASSERT_EQ(expected.size(), kruskal.edges().size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i].u, kruskal.edges()[i].u);
+        EXPECT_EQ(expected[i].v, kruskal.edges()[i].v);
+    }
+    EXPECT_EQ(canonical<float>(expected), canonical<float>(boruvka.edges()));
+
+    // -0.0与+0.0相等，按下标比较，两种算法都选出前两条边
+    std::vector<MSF::Edge> zeros = { { 0, 1, 0.0f }, { 1, 2, 0.0f }, { 0, 2, -0.0f } };
+    std::vector<std::pair<int, int>> first_two = { { 0, 1 }, { 1, 2 } };
+    for (auto algorithm : { MSF::Algorithm::kruskal, MSF::Algorithm::boruvka })
+    {
+        MSF msf(3, zeros, algorithm);
+        std::vector<std::pair<int, int>> chosen;
+        for (auto& e : msf.edges())
+            chosen.emplace_back(std::min(e.u, e.v), std::max(e.u, e.v));
+        std::sort(chosen.begin(), chosen.end());
+        EXPECT_EQ(first_two, chosen);
+    }
+
+    using Long = MinimumSpanningForest<long long>;
+    std::vector<Long::Edge> wide = { { 0, 1, -(1LL << 40) }, { 1, 2, 1LL << 40 }, { 0, 2, 0 } };
+    EXPECT_EQ(-(1LL << 40), Long(3, wide).weight());
+    using Unsigned = MinimumSpanningForest<unsigned char>;
+    std::vector<Unsigned::Edge> narrow = { { 0, 1, 200 }, { 1, 2, 100 }, { 0, 2, 255 } };
+    EXPECT_EQ(300, Unsigned(3, narrow).weight());
+}
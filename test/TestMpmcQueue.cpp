@@ -0,0 +1,151 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MpmcQueue.h"
+#include "Queue.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::MpmcQueue;
+
+class TestMpmcQueue : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+
+    // producers个生产者各入队count个元素，consumers个消费者并发出队，
+    // 检查每个元素恰好出队一次，且同一生产者的元素按入队顺序出队
+    template<typename Q>
+    void transfer(Q& queue, int producers, int consumers, int count)
+    {
+        std::vector<std::thread> workers;
+        std::vector<std::atomic<int>> seen(producers * count);
+        std::atomic<int> consumed(0);
+
+        for (auto& i : seen)
+            i.store(0);
+        for (int p = 0; p < producers; ++p)
+        {
+            workers.emplace_back([&, p]
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    int value = p * count + i;
+                    while (!queue.try_enqueue(value))
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c)
+        {
+            workers.emplace_back([&]
+            {
+                std::vector<int> last(producers, -1);
+                int value;
+                while (consumed.load() < producers * count)
+                {
+                    if (!queue.try_dequeue(value))
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    consumed++;
+                    seen[value]++;
+                    EXPECT_LT(last[value / count], value % count);
+                    last[value / count] = value % count;
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto& i : seen)
+            EXPECT_EQ(1, i.load());
+        EXPECT_TRUE(queue.empty());
+    }
+};
+
+TEST_F(TestMpmcQueue, Capacity)
+{
+    MpmcQueue<string> a(5);
+    MpmcQueue<string> b(1);
+    MpmcQueue<string> c;
+
+    EXPECT_EQ(8u, a.capacity());
+    EXPECT_EQ(2u, b.capacity());
+    EXPECT_EQ(1024u, c.capacity());
+    EXPECT_TRUE(a.empty());
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(a.try_insert_back(std::to_string(i)));
+    EXPECT_EQ(8u, a.size());
+
+    string str = "full";
+    EXPECT_FALSE(a.try_insert_back(std::move(str)));
+    EXPECT_EQ("full", str);
+}
+
+TEST_F(TestMpmcQueue, Modifiers)
+{
+    MpmcQueue<string> queue(8);
+    string str;
+
+    EXPECT_FALSE(queue.try_remove_front(str));
+    // 多轮入队出队，使位置绕过环形数组
+    for (int round = 0; round < scale; ++round)
+    {
+        for (int i = 0; i < 5; ++i)
+            queue.insert_back(std::to_string(round * 5 + i));
+        for (int i = 0; i < 5; ++i)
+        {
+            EXPECT_TRUE(queue.try_remove_front(str));
+            EXPECT_EQ(std::to_string(round * 5 + i), str);
+        }
+    }
+    EXPECT_TRUE(queue.empty());
+    // 析构时销毁剩余元素
+    for (int i = 0; i < 3; ++i)
+        queue.insert_back(std::to_string(i));
+}
+
+TEST_F(TestMpmcQueue, QueueFacade)
+{
+    ConcurrentQueue<string> queue;
+    string str = "0";
+
+    EXPECT_TRUE(queue.try_enqueue(str));
+    queue.enqueue("1");
+    EXPECT_EQ(2u, queue.size());
+    EXPECT_TRUE(queue.try_dequeue(str));
+    EXPECT_EQ("0", str);
+    EXPECT_TRUE(queue.try_dequeue(str));
+    EXPECT_EQ("1", str);
+    EXPECT_FALSE(queue.try_dequeue(str));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TestMpmcQueue, QueueCapacity)
+{
+    // 构造参数转发给MpmcQueue，容量向上取到2的幂
+    ConcurrentQueue<int> small(3);
+    ConcurrentQueue<int> large(4096);
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(small.try_enqueue(i));
+    EXPECT_FALSE(small.try_enqueue(4));
+    for (int i = 0; i < 4096; ++i)
+        EXPECT_TRUE(large.try_enqueue(i));
+    EXPECT_FALSE(large.try_enqueue(4096));
+}
+
+TEST_F(TestMpmcQueue, Concurrent)
+{
+    ConcurrentQueue<int> queue;
+
+    transfer(queue, 1, 1, 100000);
+    transfer(queue, 4, 4, 20000);
+    transfer(queue, 3, 1, 20000);
+    transfer(queue, 1, 3, 20000);
+}
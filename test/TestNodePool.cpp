@@ -0,0 +1,142 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "NodePool.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::NodePool;
+
+// 统计存活对象数量的结点，value为负数时构造失败
+struct Tracked
+{
+    static int alive;
+    string value;
+    explicit Tracked(int value = 0) : value(std::to_string(value))
+    {
+        if (value < 0)
+            throw std::invalid_argument("Tracked");
+        alive++;
+    }
+    ~Tracked() { alive--; }
+};
+int Tracked::alive = 0;
+
+class TestNodePool : public testing::Test
+{
+protected:
+    NodePool<Tracked> pool;
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; Tracked::alive = 0; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestNodePool, Empty)
+{
+    // 空结点池不分配区块，复制得到的也是空结点池
+    EXPECT_EQ(0u, pool.chunks());
+    EXPECT_EQ(0u, pool.capacity());
+    EXPECT_EQ(0u, pool.available());
+    pool.reserve(0);
+    EXPECT_EQ(0u, pool.chunks());
+
+    pool.destroy(pool.construct(1));
+    NodePool<Tracked> copy(pool);
+    EXPECT_EQ(0u, copy.chunks());
+    EXPECT_EQ(0u, copy.capacity());
+}
+
+TEST_F(TestNodePool, AllocateAndReuse)
+{
+    Tracked* p = pool.construct(1);
+    size_t first = pool.capacity();
+
+    EXPECT_EQ(1u, pool.chunks());
+    EXPECT_LT(0u, first);
+    EXPECT_EQ(first - 1, pool.available());
+    EXPECT_EQ(1, Tracked::alive);
+    // 释放的结点按后进先出立即复用
+    pool.destroy(p);
+    EXPECT_EQ(0, Tracked::alive);
+    EXPECT_EQ(first, pool.available());
+    EXPECT_EQ(p, pool.construct(2));
+    EXPECT_EQ("2", p->value);
+    pool.destroy(p);
+
+    // 用完首个区块后，新区块的容量翻倍
+    std::vector<Tracked*> nodes;
+    for (size_t i = 0; i <= first; ++i)
+        nodes.push_back(pool.construct(int(i)));
+    EXPECT_EQ(2u, pool.chunks());
+    EXPECT_EQ(2 * first, pool.capacity());
+    EXPECT_EQ(first - 1, pool.available());
+    for (auto node : nodes)
+        pool.destroy(node);
+    EXPECT_EQ(pool.capacity(), pool.available());
+    EXPECT_EQ(0, Tracked::alive);
+
+    // 构造失败时槽位放回空闲链表
+    EXPECT_THROW(pool.construct(-1), std::invalid_argument);
+    EXPECT_EQ(pool.capacity(), pool.available());
+}
+
+TEST_F(TestNodePool, Reserve)
+{
+    size_t count = 1000 * size_t(scale);
+
+    // 一次预留至多分配一个区块
+    pool.reserve(count);
+    EXPECT_EQ(1u, pool.chunks());
+    EXPECT_LE(count, pool.available());
+    size_t capacity = pool.capacity();
+    pool.reserve(count / 2);
+    EXPECT_EQ(1u, pool.chunks());
+    EXPECT_EQ(capacity, pool.capacity());
+
+    std::vector<Tracked*> nodes;
+    for (size_t i = 0; i < count; ++i)
+        nodes.push_back(pool.allocate());
+    EXPECT_EQ(1u, pool.chunks());
+    // 当前区块剩余的槽位在新区块分配前放入空闲链表，不会丢失
+    size_t left = pool.available();
+    pool.reserve(left + 1);
+    EXPECT_EQ(2u, pool.chunks());
+    EXPECT_LE(left + 1, pool.available());
+    for (auto node : nodes)
+        pool.deallocate(node);
+    EXPECT_EQ(pool.capacity(), pool.available());
+}
+
+TEST_F(TestNodePool, Share)
+{
+    std::vector<Tracked*> nodes;
+    {
+        NodePool<Tracked> other;
+        for (int i = 0; i < scale; ++i)
+            nodes.push_back(other.construct(i));
+        // 共享区块后，other的结点可以由pool释放，other析构后区块仍然有效
+        pool.share(other);
+        pool.share(other);
+        pool.share(pool);
+    }
+    EXPECT_EQ(0u, pool.chunks());
+    EXPECT_EQ(0u, pool.available());
+    for (auto node : nodes)
+        pool.destroy(node);
+    EXPECT_EQ(0, Tracked::alive);
+    EXPECT_EQ(size_t(scale), pool.available());
+    // 转入的结点被优先复用，不分配新区块
+    for (int i = 0; i < scale; ++i)
+        nodes[i] = pool.construct(i);
+    EXPECT_EQ(0u, pool.chunks());
+    EXPECT_EQ(0u, pool.available());
+
+    // 移动后结点池连同共享的区块一起转移
+    NodePool<Tracked> moved(std::move(pool));
+    for (auto node : nodes)
+        moved.destroy(node);
+    EXPECT_EQ(size_t(scale), moved.available());
+    EXPECT_EQ(0u, pool.available());
+    EXPECT_EQ(0, Tracked::alive);
+}
@@ -0,0 +1,55 @@
+#include "Percolation.h"
+#include "gtest/gtest.h"
+
+using cpplib::Percolation;
+using cpplib::PercolationStats;
+
+class TestPercolation : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 40; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestPercolation, Grid)
+{
+    Percolation grid(3);
+
+    EXPECT_FALSE(grid.percolates());
+    grid.open(0, 1);
+    grid.open(1, 1);
+    grid.open(1, 1);
+    EXPECT_TRUE(grid.is_open(1, 1));
+    EXPECT_FALSE(grid.is_open(1, 0));
+    EXPECT_EQ(2, grid.number_of_open_sites());
+    // 对角相邻不连通
+    grid.open(2, 0);
+    EXPECT_FALSE(grid.percolates());
+    grid.open(2, 1);
+    EXPECT_TRUE(grid.percolates());
+    EXPECT_THROW(grid.open(3, 0), std::out_of_range);
+    EXPECT_THROW(grid.is_open(0, -1), std::out_of_range);
+    EXPECT_THROW(Percolation(0), std::out_of_range);
+
+    Percolation single(1);
+    single.open(0, 0);
+    EXPECT_TRUE(single.percolates());
+}
+
+TEST_F(TestPercolation, Stats)
+{
+    PercolationStats one(scale, 200, 1);
+    PercolationStats four(scale, 200, 4);
+
+    // 每次试验的随机序列只由种子和序号决定，与线程数无关
+    EXPECT_EQ(one.thresholds(), four.thresholds());
+    EXPECT_NEAR(0.5927, one.mean(), 0.02);
+    EXPECT_LT(one.confidence_lo(), one.mean());
+    EXPECT_GT(one.confidence_hi(), one.mean());
+    EXPECT_GT(one.stddev(), 0.0);
+    EXPECT_NE(one.thresholds(), PercolationStats(scale, 200, 2, 1).thresholds());
+    EXPECT_EQ(PercolationStats::trial(scale, 5), PercolationStats::trial(scale, 5));
+    EXPECT_THROW(PercolationStats(scale, 0), std::out_of_range);
+}
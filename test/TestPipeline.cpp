@@ -0,0 +1,114 @@
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Pipeline.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::vector;
+using cpplib::Emitter;
+using cpplib::Pipeline;
+using cpplib::StageOptions;
+
+class TestPipeline : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 10000; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestPipeline, Chain)
+{
+    Pipeline<string> source(16);
+    auto tail = source
+        .then<string>("split", [](string& line, Emitter<string>& emit)
+        {
+            std::istringstream in(line);
+            string word;
+            while (in >> word)
+                emit(word);
+        })
+        .map<int>("length", [](string& word) { return int(word.size()); });
+
+    source.push("to be or");
+    source.push(string("not to be"));
+    source.close();
+    vector<int> lengths;
+    int n;
+    while (tail.pop(n))
+        lengths.push_back(n);
+    source.wait();
+    EXPECT_EQ(vector<int>({ 2, 2, 2, 3, 2, 2 }), lengths);
+    EXPECT_FALSE(source.push("closed"));
+
+    auto stats = source.stats();
+    ASSERT_EQ(2u, stats.size());
+    EXPECT_EQ("split", stats[0].name);
+    EXPECT_EQ(2u, stats[0].items_in);
+    EXPECT_EQ(6u, stats[0].items_out);
+    EXPECT_EQ(6u, stats[1].items_in);
+    EXPECT_EQ(0u, stats[1].queue_depth);
+    EXPECT_LE(stats[0].busy_seconds, stats[0].elapsed_seconds);
+}
+
+TEST_F(TestPipeline, Ordered)
+{
+    // 多个工作线程处理时间不同的元素，有序模式下输出顺序不变
+    Pipeline<int> source(64);
+    vector<int> result;
+
+    source.map<int>("square", [](int& x)
+    {
+        if (x % 7 == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        return x * x;
+    }, StageOptions(4, 8))
+        .sink("collect", [&](int& x) { result.push_back(x); });
+    vector<int> in;
+    for (int i = 0; i < scale; ++i)
+        in.push_back(i);
+    EXPECT_EQ(size_t(scale), source.push_batch(in.begin(), in.size()));
+    source.close();
+    source.wait();
+    ASSERT_EQ(size_t(scale), result.size());
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(i * i, result[i]);
+}
+
+TEST_F(TestPipeline, Unordered)
+{
+    Pipeline<int> source;
+    std::atomic<long long> sum(0);
+
+    source.map<int>("double", [](int& x) { return 2 * x; }, StageOptions(3, 16, 32, false))
+        .sink("sum", [&](int& x) { sum += x; }, StageOptions(2, 4));
+    for (int i = 0; i < scale; ++i)
+        source.push(i);
+    source.close();
+    source.wait();
+    EXPECT_EQ(2LL * scale * (scale - 1) / 2, sum.load());
+    auto stats = source.stats();
+    EXPECT_EQ(3, stats[0].workers);
+    EXPECT_EQ(size_t(scale), stats[0].items_in);
+    EXPECT_EQ(size_t(scale), stats[1].items_in);
+    EXPECT_LE(stats[1].max_queue_depth, 32u);
+    EXPECT_GE(stats[1].batches * 4, size_t(scale));
+}
+
+TEST_F(TestPipeline, Abandon)
+{
+    // 没有取走输出就析构，所有阶段被关闭而不会阻塞
+    std::atomic<int> processed(0);
+    {
+        Pipeline<int> source(4);
+        source.map<int>("slow", [&](int& x) { ++processed; return x; }, StageOptions(2, 1, 2));
+        for (int i = 0; i < 6; ++i)
+            source.push(i);
+    }
+    EXPECT_LE(processed.load(), 6);
+}
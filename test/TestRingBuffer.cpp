@@ -0,0 +1,128 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include "RingBuffer.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::RingBuffer;
+using cpplib::BusySpinWait;
+using cpplib::YieldingWait;
+using cpplib::BlockingWait;
+
+class TestRingBuffer : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+
+    // 一个生产者发布count个事件，a和b独立消费，c依赖a和b，
+    // 检查每个消费者按顺序看到所有事件，且c处理时a和b已经处理过
+    template<typename Wait>
+    void fan_out(int count, size_t capacity)
+    {
+        RingBuffer<long long, Wait> ring(capacity);
+        auto& a = ring.add_consumer();
+        auto& b = ring.add_consumer();
+        auto& c = ring.add_consumer({ &a, &b });
+        std::vector<std::thread> workers;
+
+        for (auto consumer : { &a, &b, &c })
+        {
+            workers.emplace_back([&, consumer]
+            {
+                long long expected = 0;
+                while (consumer->consume([&](long long value)
+                {
+                    EXPECT_EQ(expected++, value);
+                    EXPECT_TRUE(consumer != &c
+                                || (a.sequence() >= value && b.sequence() >= value));
+                }) > 0)
+                    continue;
+                EXPECT_EQ(count, expected);
+            });
+        }
+        for (long long i = 0; i < count; )
+        {
+            // 交替单个发布和批量发布
+            if (i % 2 == 0)
+                ring.push(i++);
+            else
+            {
+                long long n = std::min(3LL, count - i);
+                long long last = ring.claim(n);
+                for (long long seq = last - n + 1; seq <= last; ++seq)
+                    ring[seq] = i++;
+                ring.publish(last);
+            }
+        }
+        ring.close();
+        for (auto& w : workers)
+            w.join();
+        EXPECT_EQ(count - 1, c.sequence());
+    }
+};
+
+TEST_F(TestRingBuffer, Basic)
+{
+    RingBuffer<string> ring(5);
+    auto& consumer = ring.add_consumer();
+    std::vector<string> seen;
+    auto collect = [&seen](const string& s) { seen.push_back(s); };
+
+    EXPECT_EQ(8u, ring.capacity());
+    EXPECT_EQ(2u, RingBuffer<int>(0).capacity());
+    EXPECT_EQ(-1, ring.cursor());
+    EXPECT_EQ(-1, consumer.sequence());
+    EXPECT_THROW(ring.claim(0), std::out_of_range);
+    EXPECT_THROW(ring.claim(9), std::out_of_range);
+    for (int i = 0; i < 8; ++i)
+        ring.push(std::to_string(i));
+    EXPECT_EQ(7, ring.cursor());
+    EXPECT_EQ(3u, consumer.consume(collect, 3));
+    EXPECT_EQ(5u, consumer.consume(collect));
+    EXPECT_EQ(7, consumer.sequence());
+    // 槽位被处理后可以再次写入
+    for (int i = 8; i < 8 + scale; ++i)
+    {
+        ring.push(std::to_string(i));
+        EXPECT_EQ(1u, consumer.consume(collect));
+    }
+    ring.close();
+    EXPECT_TRUE(ring.closed());
+    EXPECT_EQ(0u, consumer.consume(collect));
+    ASSERT_EQ(size_t(8 + scale), seen.size());
+    for (int i = 0; i < 8 + scale; ++i)
+        EXPECT_EQ(std::to_string(i), seen[i]);
+}
+
+TEST_F(TestRingBuffer, Dependency)
+{
+    RingBuffer<int> ring(8);
+    auto& a = ring.add_consumer();
+    auto& b = ring.add_consumer({ &a });
+    int sum = 0;
+    auto add = [&sum](int x) { sum += x; };
+
+    for (int i = 1; i <= 3; ++i)
+        ring.push(i);
+    EXPECT_EQ(2u, a.consume(add, 2));
+    // b只能处理a已处理过的事件
+    EXPECT_EQ(2u, b.consume(add));
+    EXPECT_EQ(1, b.sequence());
+    ring.close();
+    EXPECT_EQ(1u, a.consume(add));
+    EXPECT_EQ(1u, b.consume(add));
+    EXPECT_EQ(0u, a.consume(add));
+    EXPECT_EQ(0u, b.consume(add));
+    EXPECT_EQ(12, sum);
+}
+
+TEST_F(TestRingBuffer, Concurrent)
+{
+    fan_out<YieldingWait>(100000, 64);
+    fan_out<BlockingWait>(100000, 64);
+    fan_out<BusySpinWait>(1000, 1024);
+}
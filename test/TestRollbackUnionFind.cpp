@@ -0,0 +1,71 @@
+#include <vector>
+#include "RollbackUnionFind.h"
+#include "gtest/gtest.h"
+
+using cpplib::RollbackUnionFind;
+
+class TestRollbackUnionFind : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 2000; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestRollbackUnionFind, Rollback)
+{
+    RollbackUnionFind<int> uf(8);
+
+    EXPECT_TRUE(uf.join(0, 1));
+    size_t point = uf.checkpoint();
+    EXPECT_TRUE(uf.join(2, 3));
+    EXPECT_TRUE(uf.join(1, 3));
+    EXPECT_FALSE(uf.join(0, 2));
+    EXPECT_EQ(5, uf.count());
+    EXPECT_TRUE(uf.connected(0, 3));
+    uf.rollback(point);
+    EXPECT_EQ(7, uf.count());
+    EXPECT_TRUE(uf.connected(0, 1));
+    EXPECT_FALSE(uf.connected(2, 3));
+    EXPECT_FALSE(uf.connected(0, 3));
+    uf.rollback(0);
+    EXPECT_EQ(8, uf.count());
+    EXPECT_FALSE(uf.connected(0, 1));
+    EXPECT_THROW(uf.rollback(1), std::out_of_range);
+    EXPECT_THROW(uf.find(8), std::out_of_range);
+}
+
+TEST_F(TestRollbackUnionFind, Backtracking)
+{
+    RollbackUnionFind<int> uf(scale);
+    std::vector<std::vector<int>> roots;
+    std::vector<size_t> points;
+    unsigned x = 3;
+
+    // 逐层合并并保存快照，再逐层撤销，每层撤销后与快照一致
+    for (int level = 0; level < 10; ++level)
+    {
+        std::vector<int> snapshot;
+        for (int i = 0; i < scale; ++i)
+            snapshot.push_back(uf.find(i));
+        roots.push_back(snapshot);
+        points.push_back(uf.checkpoint());
+        for (int k = 0; k < scale / 10; ++k)
+        {
+            x = x * 1103515245 + 12345;
+            int p = (x >> 8) % scale;
+            x = x * 1103515245 + 12345;
+            uf.join(p, (x >> 8) % scale);
+        }
+    }
+    while (!points.empty())
+    {
+        uf.rollback(points.back());
+        for (int i = 0; i < scale; ++i)
+            EXPECT_EQ(roots.back()[i], uf.find(i));
+        roots.pop_back();
+        points.pop_back();
+    }
+    EXPECT_EQ(scale, uf.count());
+}
@@ -0,0 +1,148 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::SpscQueue;
+
+// 统计存活对象数量的元素，复制value为负数的元素时抛出异常
+struct Fragile
+{
+    static int alive;
+    int value;
+    Fragile(int value) : value(value) { alive++; }
+    Fragile(const Fragile& that) : value(that.value)
+    {
+        if (value < 0)
+            throw std::invalid_argument("Fragile");
+        alive++;
+    }
+    ~Fragile() { alive--; }
+};
+int Fragile::alive = 0;
+
+class TestSpscQueue : public testing::Test
+{
+protected:
+    SpscQueue<string> queue{8};
+    string str;
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+};
+
+TEST_F(TestSpscQueue, Capacity)
+{
+    EXPECT_EQ(8u, queue.capacity());
+    EXPECT_EQ(2u, SpscQueue<int>(0).capacity());
+    EXPECT_EQ(1024u, SpscQueue<int>().capacity());
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(queue.enqueue(std::to_string(i)));
+    EXPECT_EQ(8u, queue.size());
+    str = "full";
+    EXPECT_FALSE(queue.enqueue(std::move(str)));
+    EXPECT_EQ("full", str);
+}
+
+TEST_F(TestSpscQueue, ElementAccess)
+{
+    EXPECT_THROW(queue.front(), std::out_of_range);
+    EXPECT_FALSE(queue.dequeue());
+    EXPECT_FALSE(queue.dequeue(str));
+    // 多轮入队出队，使位置绕过环形数组
+    for (int i = 0; i < scale; ++i)
+    {
+        queue.enqueue(std::to_string(i));
+        queue.enqueue(std::to_string(i + 1));
+        EXPECT_EQ(std::to_string(i), queue.front());
+        EXPECT_TRUE(queue.dequeue());
+        EXPECT_TRUE(queue.dequeue(str));
+        EXPECT_EQ(std::to_string(i + 1), str);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TestSpscQueue, Bulk)
+{
+    std::vector<string> in;
+    std::vector<string> out(scale);
+
+    for (int i = 0; i < scale; ++i)
+        in.push_back(std::to_string(i));
+    EXPECT_EQ(8u, queue.enqueue_bulk(in.begin(), in.size()));
+    EXPECT_EQ(3u, queue.dequeue_bulk(out.begin(), 3));
+    EXPECT_EQ(3u, queue.enqueue_bulk(in.begin() + 8, 3));
+    EXPECT_EQ(8u, queue.dequeue_bulk(out.begin() + 3, scale));
+    EXPECT_EQ(0u, queue.dequeue_bulk(out.begin(), scale));
+    for (int i = 0; i < 11; ++i)
+        EXPECT_EQ(std::to_string(i), out[i]);
+    // 析构时销毁剩余元素
+    queue.enqueue_bulk(in.begin(), 5);
+}
+
+TEST_F(TestSpscQueue, BulkException)
+{
+    // 复制中途抛出异常时，本批已构造的元素被销毁，不会入队
+    {
+        SpscQueue<Fragile> fragile(8);
+        std::vector<Fragile> in;
+        in.reserve(5);
+        for (int value : { 0, 1, 2, -1, 4 })
+            in.emplace_back(value);
+        EXPECT_EQ(2u, fragile.enqueue_bulk(in.begin(), 2));
+        EXPECT_THROW(fragile.enqueue_bulk(in.begin() + 2, 3), std::invalid_argument);
+        EXPECT_EQ(2u, fragile.size());
+        EXPECT_EQ(7, Fragile::alive);
+        EXPECT_EQ(1u, fragile.enqueue_bulk(in.begin() + 4, 1));
+        EXPECT_EQ(0, fragile.front().value);
+    }
+    EXPECT_EQ(0, Fragile::alive);
+}
+
+TEST_F(TestSpscQueue, Concurrent)
+{
+    const int count = 200000;
+    SpscQueue<int> q(64);
+
+    std::thread producer([&]
+    {
+        std::vector<int> batch(16);
+        int next = 0;
+        while (next < count)
+        {
+            // 交替使用单个入队和批量入队
+            size_t n = 0;
+            if (next % 3 == 0)
+                n = q.enqueue(next);
+            else
+            {
+                int m = std::min(16, count - next);
+                for (int i = 0; i < m; ++i)
+                    batch[i] = next + i;
+                n = q.enqueue_bulk(batch.begin(), m);
+            }
+            if (n == 0) std::this_thread::yield();
+            next += n;
+        }
+    });
+    std::vector<int> batch(16);
+    int expected = 0;
+    while (expected < count)
+    {
+        size_t n = 0;
+        if (expected % 2 == 0)
+            n = q.dequeue(batch[0]);
+        else
+            n = q.dequeue_bulk(batch.begin(), 16);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(expected++, batch[i]);
+    }
+    producer.join();
+    EXPECT_TRUE(q.empty());
+}
@@ -35,7 +35,7 @@ TEST_F(TestStack, Basic)
     EXPECT_NO_THROW({
         Stack<string> s1;
         Stack<string> s2(s1);
-        Stack<string> s3(Stack<string>());
+        Stack<string> s3{Stack<string>()};
 
         s1 = s2;
         s2 = Stack<string>();
@@ -95,8 +95,8 @@ TEST_F(TestStack, Modifiers)
     EXPECT_EQ(scale, b.size());
     for (size_t i = scale; i > 0; --i)
     {
-        EXPECT_EQ(std::to_string(i - 1), stack.top());
-        stack.pop();
+        EXPECT_EQ(std::to_string(i - 1), b.top());
+        b.pop();
     }
 }
 
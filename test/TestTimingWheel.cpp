@@ -0,0 +1,160 @@
+#include <limits>
+#include <string>
+#include <vector>
+#include "TimingWheel.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using std::vector;
+using cpplib::TimingWheel;
+
+class TestTimingWheel : public testing::Test
+{
+protected:
+    TimingWheel<string> wheel{1, 0};
+    vector<string> fired;
+public:
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+
+    // 推进到time并记录到期的值
+    size_t advance(size_t time)
+    {
+        return wheel.advance(time, [this](string& s) { fired.push_back(s); });
+    }
+};
+
+TEST_F(TestTimingWheel, Schedule)
+{
+    EXPECT_TRUE(wheel.empty());
+    wheel.schedule(30, "c");
+    wheel.schedule(10, "a");
+    wheel.schedule(20, "b");
+    wheel.schedule(0, "now");
+    EXPECT_EQ(4u, wheel.size());
+    EXPECT_EQ(1u, advance(1));
+    EXPECT_EQ(0u, advance(9));
+    EXPECT_EQ(2u, advance(20));
+    EXPECT_EQ(20u, wheel.now());
+    EXPECT_EQ(0u, advance(5));
+    EXPECT_EQ(1u, advance(1000));
+    EXPECT_EQ(vector<string>({ "now", "a", "b", "c" }), fired);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TestTimingWheel, Cancel)
+{
+    auto a = wheel.schedule(10, "a");
+    auto b = wheel.schedule(100000, "b");
+    wheel.schedule(10, "c");
+    EXPECT_TRUE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.cancel(a));
+    EXPECT_TRUE(wheel.cancel(b));
+    EXPECT_FALSE(wheel.cancel(12345));
+    EXPECT_EQ(1u, wheel.size());
+    // 结点被复用后旧编号失效
+    auto d = wheel.schedule(10, "d");
+    EXPECT_FALSE(wheel.cancel(b));
+    EXPECT_EQ(2u, advance(10));
+    EXPECT_FALSE(wheel.cancel(d));
+    EXPECT_EQ(2u, fired.size());
+}
+
+TEST_F(TestTimingWheel, Cascade)
+{
+    // 跨越各层边界的定时器按到期时间顺序触发
+    vector<size_t> delays = { 63, 64, 65, 4095, 4096, 4097, 262143, 262144,
+        16777216, 1073741823, 1073741824, 68719476736ull, 100000000000ull };
+    TimingWheel<size_t> w(1, 0);
+    vector<size_t> times;
+
+    for (auto d = delays.rbegin(); d != delays.rend(); ++d)
+        w.schedule(*d, *d);
+    for (size_t d : delays)
+    {
+        EXPECT_EQ(0u, w.advance(d - 1, [&](size_t&) { times.push_back(w.now()); }));
+        EXPECT_EQ(1u, w.advance(d, [&](size_t& v) { EXPECT_EQ(d, v); times.push_back(w.now()); }));
+    }
+    EXPECT_EQ(delays, times);
+    EXPECT_TRUE(w.empty());
+}
+
+TEST_F(TestTimingWheel, Tick)
+{
+    TimingWheel<int> w(10, 1000);
+    int count = 0;
+
+    // 延迟向上取整为刻度
+    w.schedule(1, 1);
+    w.schedule(10, 2);
+    w.schedule(11, 3);
+    EXPECT_EQ(0u, w.advance(1009, [&](int&) { ++count; }));
+    EXPECT_EQ(2u, w.advance(1010, [&](int&) { ++count; }));
+    EXPECT_EQ(1010u, w.now());
+    EXPECT_EQ(1u, w.advance(1020, [&](int&) { ++count; }));
+    EXPECT_EQ(3, count);
+}
+
+TEST_F(TestTimingWheel, HugeDelay)
+{
+    TimingWheel<int> w(10, 0);
+    int count = 0;
+
+    // 接近上限的延迟向上取整时不能回绕成很小的延迟
+    w.schedule(std::numeric_limits<size_t>::max(), 1);
+    w.schedule(std::numeric_limits<size_t>::max() - 5, 2);
+    EXPECT_EQ(0u, w.advance(100000, [&](int&) { ++count; }));
+    EXPECT_EQ(2u, w.size());
+    EXPECT_EQ(0, count);
+}
+
+TEST_F(TestTimingWheel, Reschedule)
+{
+    TimingWheel<int> w(1, 0);
+    vector<size_t> times;
+
+    // 回调中重新添加定时器形成周期定时器
+    w.schedule(100, 5);
+    w.advance(100000, [&](int& left)
+    {
+        times.push_back(w.now());
+        if (--left > 0)
+            w.schedule(100, left);
+    });
+    EXPECT_EQ(vector<size_t>({ 100, 200, 300, 400, 500 }), times);
+    EXPECT_TRUE(w.empty());
+}
+
+TEST_F(TestTimingWheel, Random)
+{
+    TimingWheel<int> w(1, 0);
+    vector<size_t> expiry;
+    vector<TimingWheel<int>::timer_id> ids;
+    unsigned x = 12345;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        size_t d = 1 + (x >> 8) % 300000;
+        expiry.push_back(d);
+        ids.push_back(w.schedule(d, i));
+    }
+    for (int i = 0; i < 20000; i += 3)
+        EXPECT_TRUE(w.cancel(ids[i]));
+    size_t last = 0;
+    int count = 0;
+    for (size_t t = 0; t <= 300000; t += 777)
+    {
+        w.advance(t, [&](int& i)
+        {
+            EXPECT_NE(0, i % 3);
+            EXPECT_EQ(expiry[i], w.now());
+            EXPECT_LE(last, w.now());
+            last = w.now();
+            ++count;
+        });
+    }
+    w.advance(300000, [&](int&) { ++count; });
+    EXPECT_EQ(20000 - 6667, count);
+    EXPECT_TRUE(w.empty());
+}
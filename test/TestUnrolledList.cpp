@@ -0,0 +1,201 @@
+#include <iostream>
+#include <string>
+#include "UnrolledList.h"
+#include "gtest/gtest.h"
+
+using std::string;
+using cpplib::UnrolledList;
+
+class TestUnrolledList : public testing::Test
+{
+protected:
+    // 使用较小的结点容量，使分裂与合并在小规模下也会发生
+    using List = UnrolledList<string, 4>;
+
+    List list;
+    List a;
+    List b;
+    List c;
+    string str;
+    int scale;
+public:
+    virtual void SetUp() { scale = 32; }
+    virtual void TearDown() {}
+
+    void insert_n(List& s, int n, bool from_back = true)
+    {
+        if (from_back)
+        {
+            for (int i = 0; i < n; ++i)
+                s.insert_back(std::to_string(i));
+        }
+        else
+        {
+            for (int i = 0; i < n; ++i)
+                s.insert_front(std::to_string(i));
+        }
+    }
+    void remove_n(List& s, int n, bool from_back = true)
+    {
+        if (from_back)
+        {
+            for (int i = 0; i < n; ++i)
+                s.remove_back();
+        }
+        else
+        {
+            for (int i = 0; i < n; ++i)
+                s.remove_front();
+        }
+    }
+};
+
+TEST_F(TestUnrolledList, Basic)
+{
+    EXPECT_NO_THROW({
+        List s1;
+        List s2(s1);
+        List s3{List()};
+
+        s1 = s2;
+        s2 = List();
+    });
+}
+
+TEST_F(TestUnrolledList, ElementAccess)
+{
+    EXPECT_THROW(list.front(), std::out_of_range);
+    EXPECT_THROW(list.back(), std::out_of_range);
+    for (int i = 0; i < scale; ++i)
+    {
+        str = std::to_string(i);
+        list.insert_back(str);
+        EXPECT_EQ(str, list.back());
+        list.insert_front(str);
+        EXPECT_EQ(str, list.front());
+    }
+    list.clear();
+    EXPECT_THROW(list.front(), std::out_of_range);
+    EXPECT_THROW(list.back(), std::out_of_range);
+}
+
+TEST_F(TestUnrolledList, Iterators)
+{
+    EXPECT_EQ(list.begin(), list.end());
+    insert_n(list, scale);
+    EXPECT_NE(list.begin(), list.end());
+
+    auto bg = list.begin();
+    auto ed = list.end();
+
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), *bg++);
+    EXPECT_EQ(bg, list.end());
+    for (int i = scale - 1; i >= 0; --i)
+        EXPECT_EQ(std::to_string(i), *--ed);
+    EXPECT_EQ(ed, list.begin());
+}
+
+TEST_F(TestUnrolledList, Capacity)
+{
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(0, list.size());
+
+    insert_n(list, scale, true);
+    EXPECT_EQ(scale, list.size());
+    remove_n(list, scale, true);
+    EXPECT_TRUE(list.empty());
+
+    insert_n(list, scale, false);
+    EXPECT_EQ(scale, list.size());
+    remove_n(list, scale, false);
+    EXPECT_TRUE(list.empty());
+}
+
+TEST_F(TestUnrolledList, Modifiers)
+{
+    EXPECT_THROW(list.remove_back(), std::out_of_range);
+    EXPECT_THROW(list.remove_front(), std::out_of_range);
+
+    // 在中间位置插入，触发结点分裂
+    for (int i = 0; i < scale; i += 2)
+        list.insert_back(std::to_string(i));
+    for (auto it = list.begin(); it != list.end(); ++it)
+    {
+        int value = std::stoi(*it);
+        it = list.insert(std::next(it), std::to_string(value + 1));
+    }
+    EXPECT_EQ(scale, list.size());
+    int expected = 0;
+    for (auto& i : list)
+        EXPECT_EQ(std::to_string(expected++), i);
+
+    // 移除所有奇数，触发结点合并
+    for (auto it = list.begin(); it != list.end(); )
+    {
+        if (std::stoi(*it) % 2 == 1) it = list.remove(it);
+        else                         ++it;
+    }
+    EXPECT_EQ(scale / 2, list.size());
+    expected = 0;
+    for (auto& i : list)
+    {
+        EXPECT_EQ(std::to_string(expected), i);
+        expected += 2;
+    }
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_THROW(list.remove_back(), std::out_of_range);
+
+    insert_n(list, scale);
+    a = a + list;
+    b += list;
+    EXPECT_TRUE(a == b);
+    b += b;
+    EXPECT_EQ(2 * scale, b.size());
+
+    c.swap(list);
+    EXPECT_EQ(scale, c.size());
+    for (int i = scale - 1; i >= 0; --i)
+    {
+        EXPECT_EQ(std::to_string(i), c.back());
+        c.remove_back();
+    }
+}
+
+TEST_F(TestUnrolledList, Splice)
+{
+    insert_n(a, scale);
+    insert_n(b, scale);
+    // 从结点中间位置拼接
+    a.splice(std::next(a.begin(), 3), b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(2 * scale, a.size());
+
+    auto it = a.begin();
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(std::to_string(i), *it++);
+    for (int i = 0; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), *it++);
+    for (int i = 3; i < scale; ++i)
+        EXPECT_EQ(std::to_string(i), *it++);
+    EXPECT_EQ(a.end(), it);
+
+    insert_n(b, scale);
+    a.splice(a.end(), b);
+    EXPECT_EQ(3 * scale, a.size());
+    EXPECT_EQ(std::to_string(scale - 1), a.back());
+}
+
+TEST_F(TestUnrolledList, Other)
+{
+    using std::swap;
+    insert_n(a, scale);
+    c = a;
+    EXPECT_TRUE(c == a && c != b);
+    b.swap(a);
+    EXPECT_TRUE(c != a && c == b);
+    swap(a, b);
+    EXPECT_TRUE(c == a && c != b);
+}
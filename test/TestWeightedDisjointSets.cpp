@@ -0,0 +1,113 @@
+#include <vector>
+#include "WeightedDisjointSets.h"
+#include "gtest/gtest.h"
+
+using namespace cpplib;
+
+template<typename WDS>
+class TestWeightedDisjointSets : public testing::Test
+{
+protected:
+    int scale;
+public:
+    virtual void SetUp() { scale = 5000; }
+    virtual void TearDown() {}
+};
+
+using WeightedDisjointSetsTypes = testing::Types<
+    WeightedDisjointSets<long long>,
+    WeightedDisjointSets<long long, int, LinkByRank, CompressFull>,
+    WeightedDisjointSets<long long, int, LinkBySize, CompressSplitting>,
+    WeightedDisjointSets<long long, long long, LinkByRandomIndex, CompressNone>,
+    WeightedDisjointSets<int, short, LinkNaive, CompressHalving>>;
+TYPED_TEST_SUITE(TestWeightedDisjointSets, WeightedDisjointSetsTypes);
+
+TYPED_TEST(TestWeightedDisjointSets, Join)
+{
+    using Index = typename TypeParam::index_type;
+    using Result = typename TypeParam::Result;
+    TypeParam wds(6);
+
+    // x1 - x0 = 3, x2 - x1 = 4, x4 - x3 = -2
+    EXPECT_EQ(Result::merged, wds.join(Index(1), Index(0), 3));
+    EXPECT_EQ(Result::merged, wds.join(Index(2), Index(1), 4));
+    EXPECT_EQ(Result::merged, wds.join(Index(4), Index(3), -2));
+    EXPECT_EQ(7, wds.diff(Index(2), Index(0)));
+    EXPECT_EQ(-7, wds.diff(Index(0), Index(2)));
+    EXPECT_EQ(Result::consistent, wds.join(Index(0), Index(2), -7));
+    EXPECT_EQ(Result::violated, wds.join(Index(2), Index(0), 8));
+    EXPECT_EQ(1u, wds.violations());
+    // 合并两个分量后，跨分量的偏移由约束推出
+    EXPECT_EQ(Result::merged, wds.join(Index(3), Index(2), 10));
+    EXPECT_EQ(15, wds.diff(Index(4), Index(0)));
+    EXPECT_EQ(2, wds.count());
+    EXPECT_TRUE(wds.connected(Index(4), Index(1)));
+    EXPECT_THROW(wds.diff(Index(5), Index(0)), std::invalid_argument);
+    EXPECT_THROW(wds.join(Index(6), Index(0), 1), std::out_of_range);
+    EXPECT_THROW(wds.find(Index(-1)), std::out_of_range);
+}
+
+TYPED_TEST(TestWeightedDisjointSets, Random)
+{
+    using Index = typename TypeParam::index_type;
+    using G = typename TypeParam::value_type;
+    int n = this->scale;
+    TypeParam wds(n);
+    std::vector<G> value(n);
+    unsigned x = 13;
+    auto next = [&x](int bound)
+    {
+        x = x * 1103515245 + 12345;
+        return int((x >> 8) % bound);
+    };
+
+    // 由隐藏的取值生成约束，每隔10个约束篡改一个
+    for (int i = 0; i < n; ++i)
+        value[i] = G(next(1000));
+    size_t violations = 0;
+    for (int k = 0; k < 2 * n; ++k)
+    {
+        int p = next(n), q = next(n);
+        bool connected = wds.connected(Index(p), Index(q));
+        bool corrupt = connected && k % 10 == 0 && p != q;
+        auto result = wds.join(Index(p), Index(q), G(value[p] - value[q] + (corrupt ? 1 : 0)));
+        violations += corrupt;
+        EXPECT_EQ(corrupt, result == TypeParam::Result::violated);
+    }
+    EXPECT_EQ(violations, wds.violations());
+    for (int i = 0; i < n; i += 3)
+    {
+        int j = (i * 7) % n;
+        if (wds.connected(Index(i), Index(j)))
+        {
+            EXPECT_EQ(G(value[i] - value[j]), wds.diff(Index(i), Index(j)));
+        }
+    }
+}
+
+TEST(TestWeightedDisjointSetsDouble, Double)
+{
+    WeightedDisjointSets<double> wds(3);
+
+    wds.join(0, 1, 0.5);
+    wds.join(1, 2, 0.25);
+    EXPECT_DOUBLE_EQ(0.75, wds.diff(0, 2));
+}
+
+TEST(TestWeightedDisjointSetsDouble, Tolerance)
+{
+    // 0.1 + 0.2与0.3相差一个舍入误差，精确比较视为矛盾，允许误差时视为一致
+    using Exact = WeightedDisjointSets<double>;
+    using Approx = WeightedDisjointSets<double, int, LinkByRank, CompressHalving, Tolerance<double>>;
+    Exact exact(3);
+    Approx approx(3, Tolerance<double>(1e-12));
+
+    exact.join(0, 1, 0.1);
+    exact.join(1, 2, 0.2);
+    EXPECT_EQ(Exact::Result::violated, exact.join(0, 2, 0.3));
+    approx.join(0, 1, 0.1);
+    approx.join(1, 2, 0.2);
+    EXPECT_EQ(Approx::Result::consistent, approx.join(0, 2, 0.3));
+    EXPECT_EQ(Approx::Result::violated, approx.join(0, 2, 0.31));
+    EXPECT_EQ(1u, approx.violations());
+}